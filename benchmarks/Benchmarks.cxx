@@ -0,0 +1,497 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "skip_list.hpp"
+#include "skip_map.hpp"
+#include "unrolled_skip_list.hpp"
+
+/*
+ * Times skip_list, skip_map and unrolled_skip_list against std::set and
+ * std::map on the same key sequences and writes the results as JSON.
+ *
+ *   Benchmarks [--sizes 1000,10000,...] [--ops N] [--containers a,b,...]
+ *              [--distributions a,b,...] [--out results.json]
+ *
+ * For every size, distribution and container a fresh container is filled
+ * (insert) and then measured on find, lower_bound, iterate, mixed (80% find,
+ * 10% insert, 10% erase) and erase of every key. Each entry reports the
+ * time and the number of operator new calls per operation, and the peak
+ * RSS of the process during that operation where the OS allows resetting
+ * it (Linux), the peak since the start otherwise.
+ */
+
+namespace
+{
+
+std::size_t g_allocations = 0;
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+
+using key_type = std::uint64_t;
+
+volatile key_type g_sink = 0;
+
+enum class distribution
+{
+    uniform,     // random keys, queries uniform over them
+    zipf,        // random keys, queries skewed towards a few hot keys
+    sequential,  // ascending keys, queries in key order
+    adversarial, // descending keys so every insert is at the front, queries all miss
+};
+
+const distribution all_distributions[] = {
+    distribution::uniform, distribution::zipf, distribution::sequential, distribution::adversarial
+};
+
+const char* distribution_name(distribution dist)
+{
+    switch (dist) {
+    case distribution::uniform:     return "uniform";
+    case distribution::zipf:        return "zipf";
+    case distribution::sequential:  return "sequential";
+    case distribution::adversarial: return "adversarial";
+    default:                        return "unknown";
+    }
+}
+
+/**
+ * @brief Zipfian ranks in [0, n) with the constant of YCSB
+ * Gray et al., "Quickly generating billion-record synthetic databases".
+ */
+class zipf_generator
+{
+public:
+    explicit zipf_generator(std::uint64_t n, double theta = 0.99)
+        : m_n(n)
+        , m_theta(theta)
+        , m_alpha(1.0 / (1.0 - theta))
+        , m_zetan(zeta(n, theta))
+        , m_eta((1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta(2, theta) / m_zetan))
+    { }
+
+    template <typename Random>
+    std::uint64_t operator()(Random& rng)
+    {
+        const double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        const double uz = u * m_zetan;
+        if (uz < 1.0) {
+            return 0;
+        }
+        if (uz < 1.0 + std::pow(0.5, m_theta)) {
+            return 1;
+        }
+        const double rank = static_cast<double>(m_n) * std::pow(m_eta * u - m_eta + 1.0, m_alpha);
+        return std::min(static_cast<std::uint64_t>(rank), m_n - 1);
+    }
+
+private:
+    static double zeta(std::uint64_t n, double theta)
+    {
+        double sum = 0;
+        for (std::uint64_t i = 1; i <= n; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        }
+        return sum;
+    }
+
+private:
+    std::uint64_t m_n;
+    double m_theta;
+    double m_alpha;
+    double m_zetan;
+    double m_eta;
+};
+
+/// Keys to fill the container with, keys to look up and keys to insert during the mixed run.
+struct workload
+{
+    std::vector<key_type> m_keys;
+    std::vector<key_type> m_queries;
+    std::vector<key_type> m_fresh;
+};
+
+workload make_workload(distribution dist, std::size_t size, std::size_t ops)
+{
+    std::mt19937_64 rng(size * 31 + static_cast<std::size_t>(dist));
+    workload load;
+    load.m_keys.resize(size);
+    load.m_queries.resize(ops);
+    load.m_fresh.resize(ops / 10 + 1);
+    switch (dist) {
+    case distribution::uniform:
+    case distribution::zipf:
+        for (key_type& key : load.m_keys) {
+            key = rng();
+        }
+        for (key_type& key : load.m_fresh) {
+            key = rng();
+        }
+        if (dist == distribution::uniform) {
+            std::uniform_int_distribution<std::size_t> index(0, size - 1);
+            for (key_type& key : load.m_queries) {
+                key = load.m_keys[index(rng)];
+            }
+        } else {
+            // scramble the ranks so the hot keys are spread over the key space
+            zipf_generator zipf(size);
+            for (key_type& key : load.m_queries) {
+                key = load.m_keys[(zipf(rng) * 0x9E3779B97F4A7C15ull) % size];
+            }
+        }
+        break;
+    case distribution::sequential:
+        for (std::size_t i = 0; i < size; ++i) {
+            load.m_keys[i] = 2 * i;
+        }
+        for (std::size_t i = 0; i < ops; ++i) {
+            load.m_queries[i] = 2 * (i % size);
+        }
+        for (std::size_t i = 0; i < load.m_fresh.size(); ++i) {
+            load.m_fresh[i] = 2 * (size + i);
+        }
+        break;
+    case distribution::adversarial:
+        for (std::size_t i = 0; i < size; ++i) {
+            load.m_keys[i] = 2 * (size - i);
+        }
+        for (std::size_t i = 0; i < ops; ++i) {
+            load.m_queries[i] = 2 * (size - i % size) + 1;
+        }
+        for (std::size_t i = 0; i < load.m_fresh.size(); ++i) {
+            load.m_fresh[i] = 2 * (size - i % size) - 1;
+        }
+        break;
+    default:
+        break;
+    }
+    return load;
+}
+
+struct result
+{
+    std::string m_container;
+    std::string m_operation;
+    std::string m_distribution;
+    std::size_t m_size;
+    std::size_t m_ops;
+    double m_ns_per_op;
+    double m_allocs_per_op;
+    long m_peak_rss_kb;
+};
+
+void reset_peak_rss()
+{
+#if defined(__linux__)
+    if (std::FILE* file = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", file);
+        std::fclose(file);
+    }
+#endif
+}
+
+long peak_rss_kb()
+{
+#if defined(__linux__)
+    if (std::FILE* file = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        long peak = -1;
+        while (std::fgets(line, sizeof(line), file) != nullptr) {
+            if (std::strncmp(line, "VmHWM:", 6) == 0) {
+                peak = std::strtol(line + 6, nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(file);
+        return peak;
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<long>(usage.ru_maxrss / 1024);
+#else
+    return static_cast<long>(usage.ru_maxrss);
+#endif
+#else
+    return -1;
+#endif
+}
+
+template <typename Container>
+inline constexpr bool is_map = !std::is_same_v<typename Container::value_type, key_type>;
+
+template <typename Container, typename Value>
+key_type key_of(const Value& value)
+{
+    if constexpr (is_map<Container>) {
+        return value.first;
+    } else {
+        return value;
+    }
+}
+
+template <typename Container>
+bool insert(Container& container, key_type key)
+{
+    if constexpr (is_map<Container>) {
+        return container.try_emplace(key, key).second;
+    } else {
+        return container.insert(key).second;
+    }
+}
+
+class runner
+{
+public:
+    runner(std::size_t size, distribution dist, const workload& load, std::vector<result>& results)
+        : m_size(size)
+        , m_dist(dist)
+        , m_load(load)
+        , m_results(results)
+    { }
+
+    template <typename Container>
+    void run(const std::string& name)
+    {
+        std::cerr << name << ' ' << distribution_name(m_dist) << ' ' << m_size << std::endl;
+        Container container;
+        const std::vector<key_type>& keys = m_load.m_keys;
+        const std::vector<key_type>& queries = m_load.m_queries;
+
+        measure(name, "insert", keys.size(), [&] {
+            for (key_type key : keys) {
+                insert(container, key);
+            }
+        });
+        measure(name, "find", queries.size(), [&] {
+            key_type found = 0;
+            for (key_type key : queries) {
+                found += (container.find(key) != container.end()) ? 1 : 0;
+            }
+            g_sink = g_sink + found;
+        });
+        measure(name, "lower_bound", queries.size(), [&] {
+            key_type sum = 0;
+            for (key_type key : queries) {
+                auto it = container.lower_bound(key);
+                sum += (it != container.end()) ? key_of<Container>(*it) : 0;
+            }
+            g_sink = g_sink + sum;
+        });
+        measure(name, "iterate", container.size(), [&] {
+            key_type sum = 0;
+            for (const auto& value : container) {
+                sum += key_of<Container>(value);
+            }
+            g_sink = g_sink + sum;
+        });
+        measure(name, "mixed", queries.size(), [&] {
+            key_type found = 0;
+            for (std::size_t i = 0; i < queries.size(); ++i) {
+                switch (i % 10) {
+                case 8:
+                    insert(container, m_load.m_fresh[i / 10]);
+                    break;
+                case 9:
+                    container.erase(queries[i]);
+                    break;
+                default:
+                    found += (container.find(queries[i]) != container.end()) ? 1 : 0;
+                    break;
+                }
+            }
+            g_sink = g_sink + found;
+        });
+        measure(name, "erase", keys.size(), [&] {
+            for (key_type key : keys) {
+                container.erase(key);
+            }
+        });
+    }
+
+private:
+    template <typename Body>
+    void measure(const std::string& container, const char* operation, std::size_t ops, Body&& body)
+    {
+        reset_peak_rss();
+        const std::size_t allocations = g_allocations;
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto stop = std::chrono::steady_clock::now();
+        // read before building the result, whose strings allocate too
+        const std::size_t allocated = g_allocations - allocations;
+        const long peak = peak_rss_kb();
+        const double count = static_cast<double>(std::max<std::size_t>(ops, 1));
+        m_results.push_back(result{
+            container, operation, distribution_name(m_dist), m_size, ops,
+            std::chrono::duration<double, std::nano>(stop - start).count() / count,
+            static_cast<double>(allocated) / count, peak});
+    }
+
+private:
+    std::size_t m_size;
+    distribution m_dist;
+    const workload& m_load;
+    std::vector<result>& m_results;
+};
+
+std::vector<std::string> split_list(const std::string& text)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    for (std::string item; std::getline(stream, item, ','); ) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+bool selected(const std::vector<std::string>& names, const std::string& name)
+{
+    return names.empty() || std::find(names.begin(), names.end(), name) != names.end();
+}
+
+void write_json(std::ostream& out, const std::vector<result>& results)
+{
+    out << "{\n  \"schema\": 1,\n";
+#if defined(NDEBUG)
+    out << "  \"assertions\": false,\n";
+#else
+    out << "  \"assertions\": true,\n";
+#endif
+    out << "  \"results\": [";
+    const char* separator = "\n";
+    for (const result& r : results) {
+        out << separator
+            << "    {\"container\": \"" << r.m_container << "\", \"operation\": \"" << r.m_operation
+            << "\", \"distribution\": \"" << r.m_distribution << "\", \"size\": " << r.m_size
+            << ", \"ops\": " << r.m_ops << ", \"ns_per_op\": " << r.m_ns_per_op
+            << ", \"allocs_per_op\": " << r.m_allocs_per_op << ", \"peak_rss_kb\": " << r.m_peak_rss_kb << "}";
+        separator = ",\n";
+    }
+    out << "\n  ]\n}\n";
+}
+
+int usage(const char* program)
+{
+    std::cerr << "usage: " << program << " [--sizes 1000,10000,...] [--ops N] [--containers a,b,...]"
+              << " [--distributions a,b,...] [--out file.json]\n"
+              << "containers: skip_list std::set unrolled_skip_list skip_map std::map\n"
+              << "distributions: uniform zipf sequential adversarial\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<std::size_t> sizes = {1000, 10000, 100000, 1000000};
+    std::size_t ops = 1000000;
+    std::vector<std::string> containers;
+    std::vector<std::string> distributions;
+    std::string out_path;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 == argc) {
+            return usage(argv[0]);
+        }
+        const std::string value = argv[++i];
+        if (arg == "--sizes") {
+            sizes.clear();
+            for (const std::string& size : split_list(value)) {
+                sizes.push_back(static_cast<std::size_t>(std::stoull(size)));
+            }
+        } else if (arg == "--ops") {
+            ops = static_cast<std::size_t>(std::stoull(value));
+        } else if (arg == "--containers") {
+            containers = split_list(value);
+        } else if (arg == "--distributions") {
+            distributions = split_list(value);
+        } else if (arg == "--out") {
+            out_path = value;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    std::vector<result> results;
+    for (std::size_t size : sizes) {
+        if (size == 0) {
+            continue;
+        }
+        for (distribution dist : all_distributions) {
+            if (!selected(distributions, distribution_name(dist))) {
+                continue;
+            }
+            const workload load = make_workload(dist, size, ops);
+            runner bench(size, dist, load, results);
+            if (selected(containers, "skip_list")) {
+                bench.run<skip_list::skip_list<key_type>>("skip_list");
+            }
+            if (selected(containers, "std::set")) {
+                bench.run<std::set<key_type>>("std::set");
+            }
+            if (selected(containers, "unrolled_skip_list")) {
+                bench.run<skip_list::unrolled_skip_list<key_type>>("unrolled_skip_list");
+            }
+            if (selected(containers, "skip_map")) {
+                bench.run<skip_list::skip_map<key_type, key_type>>("skip_map");
+            }
+            if (selected(containers, "std::map")) {
+                bench.run<std::map<key_type, key_type>>("std::map");
+            }
+        }
+    }
+
+    if (out_path.empty()) {
+        write_json(std::cout, results);
+    } else {
+        std::ofstream out(out_path);
+        write_json(out, results);
+    }
+    return 0;
+}
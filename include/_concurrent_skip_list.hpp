@@ -0,0 +1,109 @@
+#pragma once
+
+namespace skip_list
+{
+
+template <class T, class C, class A, class G>
+concurrent_skip_list<T, C, A, G>::concurrent_skip_list(const allocator_type& alloc)
+    : m_impl(alloc)
+{ }
+
+template <class T, class C, class A, class G>
+template <class InputIterator>
+concurrent_skip_list<T, C, A, G>::concurrent_skip_list(InputIterator first, InputIterator last, const allocator_type& alloc)
+    : m_impl(alloc)
+{
+    insert(first, last);
+}
+
+template <class T, class C, class A, class G>
+concurrent_skip_list<T, C, A, G>::concurrent_skip_list(std::initializer_list<T> init, const allocator_type& alloc)
+    : m_impl(alloc)
+{
+    insert(init.begin(), init.end());
+}
+
+template <class T, class C, class A, class G>
+typename concurrent_skip_list<T, C, A, G>::iterator concurrent_skip_list<T, C, A, G>::begin() const
+{
+    auto guard = pin();
+    return iterator(m_impl.front(), std::move(guard));
+}
+
+template <class T, class C, class A, class G>
+std::pair<typename concurrent_skip_list<T, C, A, G>::iterator, bool> concurrent_skip_list<T, C, A, G>::insert(const value_type& value)
+{
+    auto guard = pin();
+    auto [node, inserted] = m_impl.insert(value);
+    return std::make_pair(iterator(node, std::move(guard)), inserted);
+}
+
+template <class T, class C, class A, class G>
+template <typename InputIterator>
+void concurrent_skip_list<T, C, A, G>::insert(InputIterator first, InputIterator last)
+{
+    auto guard = pin();
+    for (; first != last; ++first) {
+        m_impl.insert(*first);
+    }
+}
+
+template <class T, class C, class A, class G>
+void concurrent_skip_list<T, C, A, G>::insert(std::initializer_list<T> init)
+{
+    insert(init.begin(), init.end());
+}
+
+template <class T, class C, class A, class G>
+typename concurrent_skip_list<T, C, A, G>::size_type concurrent_skip_list<T, C, A, G>::erase(const value_type& value)
+{
+    auto guard = pin();
+    return m_impl.remove(value) ? 1 : 0;
+}
+
+template <class T, class C, class A, class G>
+bool concurrent_skip_list<T, C, A, G>::try_pop_min(value_type& value)
+{
+    auto guard = pin();
+    return m_impl.remove_min(value);
+}
+
+template <class T, class C, class A, class G>
+bool concurrent_skip_list<T, C, A, G>::spray_pop_min(value_type& value, size_type threads)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    auto guard = pin();
+    return m_impl.spray_remove_min(value, threads);
+}
+
+template <class T, class C, class A, class G>
+bool concurrent_skip_list<T, C, A, G>::contains(const value_type& value) const
+{
+    auto guard = pin();
+    return m_impl.find(value) != nullptr;
+}
+
+template <class T, class C, class A, class G>
+typename concurrent_skip_list<T, C, A, G>::iterator concurrent_skip_list<T, C, A, G>::find(const value_type& value) const
+{
+    auto guard = pin();
+    return iterator(m_impl.find(value), std::move(guard));
+}
+
+template <class T, class C, class A, class G>
+typename concurrent_skip_list<T, C, A, G>::iterator concurrent_skip_list<T, C, A, G>::lower_bound(const value_type& value) const
+{
+    auto guard = pin();
+    return iterator(m_impl.lower_bound(value), std::move(guard));
+}
+
+template <class T, class C, class A, class G>
+typename concurrent_skip_list<T, C, A, G>::iterator concurrent_skip_list<T, C, A, G>::upper_bound(const value_type& value) const
+{
+    auto guard = pin();
+    return iterator(m_impl.upper_bound(value), std::move(guard));
+}
+
+} // namespace skip_list
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace skip_list
+{
+
+template <class T, class C, class G>
+std::pair<typename mapped_skip_list<T, C, G>::iterator, bool> mapped_skip_list<T, C, G>::insert(const value_type& value)
+{
+    const auto [offset, inserted] = m_impl.insert(value);
+    return std::make_pair(iterator(&m_impl, offset), inserted);
+}
+
+template <class T, class C, class G>
+template <typename InputIterator>
+void mapped_skip_list<T, C, G>::insert(InputIterator first, InputIterator last)
+{
+    for (; first != last; ++first) {
+        m_impl.insert(*first);
+    }
+}
+
+template <class T, class C, class G>
+typename mapped_skip_list<T, C, G>::iterator mapped_skip_list<T, C, G>::upper_bound(const value_type& value) const
+{
+    iterator it = lower_bound(value);
+    if (it != end() && !m_impl.is_less(value, *it)) {
+        ++it;
+    }
+    return it;
+}
+
+} // namespace skip_list
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace skip_list
+{
+
+template <class T, class C, class G, bool B>
+std::pair<typename packed_skip_list<T, C, G, B>::iterator, bool> packed_skip_list<T, C, G, B>::insert(const value_type& value)
+{
+    const auto [index, inserted] = m_impl.insert(value);
+    return std::make_pair(iterator(&m_impl, index), inserted);
+}
+
+template <class T, class C, class G, bool B>
+template <typename InputIterator>
+void packed_skip_list<T, C, G, B>::insert(InputIterator first, InputIterator last)
+{
+    for (; first != last; ++first) {
+        m_impl.insert(*first);
+    }
+}
+
+template <class T, class C, class G, bool B>
+typename packed_skip_list<T, C, G, B>::iterator packed_skip_list<T, C, G, B>::upper_bound(const value_type& value) const
+{
+    iterator it = lower_bound(value);
+    if (it != end() && !m_impl.is_less(value, *it)) {
+        ++it;
+    }
+    return it;
+}
+
+} // namespace skip_list
@@ -3,190 +3,471 @@
 namespace skip_list
 {
 
-template <class T, class C, class A>
-skip_list<T, C, A>::skip_list(const allocator_type& alloc)
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S>::skip_list(const allocator_type& alloc)
     : m_impl(alloc)
 { }
 
-template <class T, class C, class A>
+template <class T, class C, class A, class G, class S>
 template <class InputIterator>
-skip_list<T, C, A>::skip_list(InputIterator first, InputIterator last, const allocator_type& alloc)
+skip_list<T, C, A, G, S>::skip_list(InputIterator first, InputIterator last, const allocator_type& alloc)
     : m_impl(alloc)
 {
     assign(first, last);
 }
 
 
-template <class T, class C, class A>
-skip_list<T, C, A>::skip_list(const skip_list& other)
-    : m_impl(other.get_allocator())
+template <class T, class C, class A, class G, class S>
+template <class InputIterator>
+skip_list<T, C, A, G, S>::skip_list(sorted_unique_t, InputIterator first, InputIterator last, const allocator_type& alloc)
+    : m_impl(alloc)
 {
-    assign(other.begin(), other.end());
+    assign(sorted_unique, first, last);
 }
 
-template <class T, class C, class A>
-skip_list<T, C, A>::skip_list(const skip_list& other, const allocator_type& alloc)
+template <class T, class C, class A, class G, class S>
+template <class InputIterator>
+skip_list<T, C, A, G, S>::skip_list(parallel_t, InputIterator first, InputIterator last, const allocator_type& alloc)
     : m_impl(alloc)
 {
-    assign(other.begin(), other.end());
+    assign(parallel, first, last);
 }
 
-template <class T, class C, class A>
-skip_list<T, C, A>::skip_list(skip_list&& other)
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S>::skip_list(const skip_list& other)
+    : m_impl(other.m_impl)
+{ }
+
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S>::skip_list(const skip_list& other, const allocator_type& alloc)
+    : m_impl(other.m_impl, alloc)
+{ }
+
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S>::skip_list(skip_list&& other) noexcept(std::is_nothrow_move_constructible_v<impl_type>)
     : m_impl(std::move(other.m_impl))
 { }
 
-template <class T, class C, class A>
-skip_list<T, C, A>::skip_list(skip_list&& other, const allocator_type &alloc)
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S>::skip_list(skip_list&& other, const allocator_type &alloc)
     : m_impl(alloc)
 {
-    assign(other.begin(), other.end());
+    if (alloc == other.get_allocator()) {
+        m_impl.swap(other.m_impl);
+    } else {
+        m_impl.assign_move(other.m_impl);
+    }
 }
 
-template <class T, class C, class A>
-skip_list<T, C, A>::skip_list(std::initializer_list<T> init, const allocator_type& alloc)
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S>::skip_list(std::initializer_list<T> init, const allocator_type& alloc)
     : m_impl(alloc)
 {
     assign(init.begin(), init.end());
 }
 
-template <class T, class C, class A>
-skip_list<T, C, A>& skip_list<T, C, A>::operator=(const skip_list& other)
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S>& skip_list<T, C, A, G, S>::operator=(const skip_list& other)
 {
-    assign(other.begin(), other.end());
+    m_impl = other.m_impl;
     return *this;
 }
 
-template <class T, class C, class A>
-skip_list<T, C, A>& skip_list<T, C, A>::operator=(skip_list&& other)
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S>& skip_list<T, C, A, G, S>::operator=(skip_list&& other) noexcept(std::is_nothrow_move_assignable_v<impl_type>)
 {
-    clear();
     m_impl = std::move(other.m_impl);
     return *this;
 }
 
-template <class T, class C, class A>
-skip_list<T, C, A>& skip_list<T, C, A>::operator=(std::initializer_list<T> init)
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S>& skip_list<T, C, A, G, S>::operator=(std::initializer_list<T> init)
 {
     assign(init.begin(), init.end());
     return *this;
 }
 
-template <class T, class C, class A>
+template <class T, class C, class A, class G, class S>
 template <typename InputIterator>
-void skip_list<T, C, A>::assign(InputIterator first, InputIterator last)
+void skip_list<T, C, A, G, S>::assign(InputIterator first, InputIterator last)
 {
     clear();
-    while (first != last) {
-        insert(*first++);
-    }
+    m_impl.insert_range(first, last);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename InputIterator>
+void skip_list<T, C, A, G, S>::assign(sorted_unique_t, InputIterator first, InputIterator last)
+{
+    clear();
+    m_impl.append_sorted(first, last);
 }
 
-template <class T, class C, class A>
-void skip_list<T, C, A>::assign(std::initializer_list<T> init)
+template <class T, class C, class A, class G, class S>
+template <typename InputIterator>
+void skip_list<T, C, A, G, S>::assign(parallel_t, InputIterator first, InputIterator last, size_type threads)
+{
+    std::vector<value_type> values(first, last);
+    threads = internal::sl_thread_count(threads, values.size());
+    internal::sl_parallel_sort(values.begin(), values.end(), compare(), threads);
+    m_impl.assign_sorted_parallel(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()), threads);
+}
+
+template <class T, class C, class A, class G, class S>
+void skip_list<T, C, A, G, S>::assign(std::initializer_list<T> init)
 {
     assign(init.begin(), init.end());
 }
 
-template <class T, class C, class A>
-typename skip_list<T, C, A>::reference skip_list<T, C, A>::front()
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::reference skip_list<T, C, A, G, S>::front()
 {
     assert(!empty());
     return m_impl.front()->m_value;
 }
 
-template <class T, class C, class A>
-const typename skip_list<T, C, A>::value_type& skip_list<T, C, A>::front() const
+template <class T, class C, class A, class G, class S>
+const typename skip_list<T, C, A, G, S>::value_type& skip_list<T, C, A, G, S>::front() const
 {
     assert(!empty());
     return m_impl.front()->m_value;
 }
 
-template <class T, class C, class A>
-typename skip_list<T, C, A>::reference skip_list<T, C, A>::back()
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::reference skip_list<T, C, A, G, S>::back()
 {
     assert(!empty());
     return m_impl.back()->m_value;
 }
 
-template <class T, class C, class A>
-const typename skip_list<T, C, A>::value_type& skip_list<T, C, A>::back() const
+template <class T, class C, class A, class G, class S>
+const typename skip_list<T, C, A, G, S>::value_type& skip_list<T, C, A, G, S>::back() const
 {
     assert(!empty());
     return m_impl.back()->m_value;
 }
 
-template <class T, class C, class A>
-std::pair<typename skip_list<T, C, A>::iterator, bool> skip_list<T, C, A>::insert(const value_type& value)
+template <class T, class C, class A, class G, class S>
+std::pair<typename skip_list<T, C, A, G, S>::iterator, bool> skip_list<T, C, A, G, S>::insert(const value_type& value)
 {
-    node_type* node = m_impl.insert(value);
-    return std::make_pair(iterator(node), (nullptr != node));
+    auto [node, inserted] = m_impl.insert(value);
+    return std::make_pair(iterator(node), inserted);
 }
 
-template <class T, class C, class A>
-void skip_list<T, C, A>::insert(std::initializer_list<T> init)
+template <class T, class C, class A, class G, class S>
+std::pair<typename skip_list<T, C, A, G, S>::iterator, bool> skip_list<T, C, A, G, S>::insert(value_type&& value)
 {
-    for (auto& val : init) {
-        m_impl.insert(val);
-    }
+    auto [node, inserted] = m_impl.insert(std::move(value));
+    return std::make_pair(iterator(node), inserted);
 }
 
-template <class T, class C, class A>
-typename skip_list<T, C, A>::iterator skip_list<T, C, A>::erase(const value_type& value)
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::insert(const_iterator hint, const value_type& value)
 {
-    node_type* node = m_impl.find(value);
-    if (m_impl.is_equal(node->m_value, value)) {
-        node_type* next = node->m_next[0];
-        m_impl.remove(node);
-        return iterator(next);
-    }
-    return iterator(m_impl.tail());
+    return iterator(m_impl.insert(value, true, const_cast<node_type*>(hint.get_node())).first);
 }
 
-template <class T, class C, class A>
-typename skip_list<T, C, A>::iterator skip_list<T, C, A>::find(const value_type& value)
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::insert(const_iterator hint, value_type&& value)
 {
-    node_type* node = m_impl.find(value);
-    if (m_impl.is_equal(node->m_value, value)) {
-        return iterator(node);
+    return iterator(m_impl.insert(std::move(value), true, const_cast<node_type*>(hint.get_node())).first);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename InputIterator>
+void skip_list<T, C, A, G, S>::insert(InputIterator first, InputIterator last)
+{
+    m_impl.insert_range(first, last);
+}
+
+template <class T, class C, class A, class G, class S>
+void skip_list<T, C, A, G, S>::insert(std::initializer_list<T> init)
+{
+    m_impl.insert_range(init.begin(), init.end());
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename... Args>
+std::pair<typename skip_list<T, C, A, G, S>::iterator, bool> skip_list<T, C, A, G, S>::emplace(Args&&... args)
+{
+    auto [node, inserted] = m_impl.emplace(std::forward<Args>(args)...);
+    return std::make_pair(iterator(node), inserted);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename... Args>
+std::pair<typename skip_list<T, C, A, G, S>::iterator, bool> skip_list<T, C, A, G, S>::try_emplace(Key&& key, Args&&... args)
+{
+    if constexpr (internal::sl_is_transparent<compare>::value ||
+                  std::is_same_v<std::decay_t<Key>, value_type>) {
+        // the key is only forwarded to the constructor once the search is over
+        auto [node, inserted] = m_impl.try_emplace(key, std::forward<Key>(key), std::forward<Args>(args)...);
+        return std::make_pair(iterator(node), inserted);
+    } else {
+        // the comparator only takes values, so there is nothing to search with before construction
+        return emplace(std::forward<Key>(key), std::forward<Args>(args)...);
     }
-    return iterator(m_impl.tail());
 }
 
-template <class T, class C, class A>
-typename skip_list<T, C, A>::const_iterator skip_list<T, C, A>::find(const value_type& value) const
+template <class T, class C, class A, class G, class S>
+template <typename... Args>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::emplace_hint(const_iterator hint, Args&&... args)
+{
+    return iterator(m_impl.emplace_hint(const_cast<node_type*>(hint.get_node()), std::forward<Args>(args)...).first);
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::erase(const value_type& value)
+{
+    return iterator(m_impl.remove(value));
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::erase(const_iterator pos)
+{
+    assert(pos != cend());
+    return iterator(m_impl.remove(const_cast<node_type*>(pos.get_node())));
+}
+
+template <class T, class C, class A, class G, class S>
+void skip_list<T, C, A, G, S>::pop_front()
+{
+    assert(!empty());
+    m_impl.remove_front();
+}
+
+template <class T, class C, class A, class G, class S>
+void skip_list<T, C, A, G, S>::pop_back()
+{
+    assert(!empty());
+    m_impl.remove(m_impl.back());
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::value_type skip_list<T, C, A, G, S>::extract_min()
+{
+    assert(!empty());
+    value_type value = std::move(m_impl.front()->m_value);
+    m_impl.remove_front();
+    return value;
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::erase(const_iterator first, const_iterator last)
+{
+    return iterator(m_impl.remove_range(const_cast<node_type*>(first.get_node()), const_cast<node_type*>(last.get_node())));
+}
+
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S> skip_list<T, C, A, G, S>::split(const value_type& key)
+{
+    // the allocator is shared, the nodes are freed by the other list
+    return skip_list(internal::sl_build, get_allocator(), [&](impl_type& rest) { m_impl.split(key, rest); });
+}
+
+template <class T, class C, class A, class G, class S>
+skip_list<T, C, A, G, S> skip_list<T, C, A, G, S>::extract(const_iterator first, const_iterator last)
+{
+    return skip_list(internal::sl_build, get_allocator(), [&](impl_type& out) {
+        m_impl.extract(const_cast<node_type*>(first.get_node()), const_cast<node_type*>(last.get_node()), out);
+    });
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::find(const value_type& value)
+{
+    return iterator(m_impl.find(value));
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::const_iterator skip_list<T, C, A, G, S>::find(const value_type& value) const
 {
-    return const_iterator(const_cast<skip_list&>(this).find(value));
+    return const_iterator(const_cast<skip_list*>(this)->find(value));
 }
 
-template <class T, class C, class A>
-typename skip_list<T, C, A>::iterator skip_list<T, C, A>::lower_bound(const value_type& value)
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::lower_bound(const value_type& value)
 {
     return iterator(m_impl.find_first(value));
 }
 
-template <class T, class C, class A>
-typename skip_list<T, C, A>::const_iterator skip_list<T, C, A>::lower_bound(const value_type& value) const
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::const_iterator skip_list<T, C, A, G, S>::lower_bound(const value_type& value) const
 {
-    return const_iterator(const_cast<skip_list&>(this).lower_bound(value));
+    return const_iterator(const_cast<skip_list*>(this)->lower_bound(value));
 }
 
-template <class T, class C, class A>
-typename skip_list<T, C, A>::iterator skip_list<T, C, A>::upper_bound(const value_type& value)
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::upper_bound(const value_type& value)
 {
     node_type* node = m_impl.find_first(value);
-    if (node != m_impl.tail()) {
-        while (m_impl.is_less_or_equal(node->m_value, value)) {
-            node = node->m_next[0];
-        }
+    while (node != m_impl.tail() && m_impl.is_less_or_equal(node->m_value, value)) {
+        node = node->next(0);
     }
     return iterator(node);
 }
 
-template <class T, class C, class A>
-typename skip_list<T, C, A>::const_iterator skip_list<T, C, A>::upper_bound(const value_type& value) const
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::const_iterator skip_list<T, C, A, G, S>::upper_bound(const value_type& value) const
+{
+    return const_iterator(const_cast<skip_list*>(this)->upper_bound(value));
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::find(const Key& key)
+{
+    return iterator(m_impl.find(key));
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename>
+typename skip_list<T, C, A, G, S>::const_iterator skip_list<T, C, A, G, S>::find(const Key& key) const
+{
+    return const_iterator(const_cast<skip_list*>(this)->find(key));
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::lower_bound(const Key& key)
+{
+    return iterator(m_impl.find_first(key));
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename>
+typename skip_list<T, C, A, G, S>::const_iterator skip_list<T, C, A, G, S>::lower_bound(const Key& key) const
+{
+    return const_iterator(const_cast<skip_list*>(this)->lower_bound(key));
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::upper_bound(const Key& key)
+{
+    node_type* node = m_impl.find_first(key);
+    while (node != m_impl.tail() && m_impl.is_less_or_equal(node->m_value, key)) {
+        node = node->next(0);
+    }
+    return iterator(node);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename>
+typename skip_list<T, C, A, G, S>::const_iterator skip_list<T, C, A, G, S>::upper_bound(const Key& key) const
+{
+    return const_iterator(const_cast<skip_list*>(this)->upper_bound(key));
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename ForwardIterator, typename OutputIterator>
+OutputIterator skip_list<T, C, A, G, S>::lower_bound_batch(ForwardIterator first, ForwardIterator last, OutputIterator out)
+{
+    m_impl.find_first_batch(first, last, [&](const auto&, node_type* node) {
+        *out = iterator(node);
+        ++out;
+    });
+    return out;
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename ForwardIterator, typename OutputIterator>
+OutputIterator skip_list<T, C, A, G, S>::lower_bound_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const
+{
+    m_impl.find_first_batch(first, last, [&](const auto&, node_type* node) {
+        *out = const_iterator(node);
+        ++out;
+    });
+    return out;
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename ForwardIterator, typename OutputIterator>
+OutputIterator skip_list<T, C, A, G, S>::find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out)
+{
+    m_impl.find_first_batch(first, last, [&](const auto& key, node_type* node) {
+        *out = iterator((node != m_impl.tail() && !m_impl.is_less(key, node->m_value)) ? node : m_impl.tail());
+        ++out;
+    });
+    return out;
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename ForwardIterator, typename OutputIterator>
+OutputIterator skip_list<T, C, A, G, S>::find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const
+{
+    m_impl.find_first_batch(first, last, [&](const auto& key, node_type* node) {
+        *out = const_iterator((node != m_impl.tail() && !m_impl.is_less(key, node->m_value)) ? node : m_impl.tail());
+        ++out;
+    });
+    return out;
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::find_from(const_iterator pos, const value_type& value)
+{
+    node_type* node = m_impl.find_from(const_cast<node_type*>(pos.get_node()), value);
+    if (node != m_impl.tail() && !m_impl.is_less(value, node->m_value)) {
+        return iterator(node);
+    }
+    return end();
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::const_iterator skip_list<T, C, A, G, S>::find_from(const_iterator pos, const value_type& value) const
+{
+    return const_iterator(const_cast<skip_list*>(this)->find_from(pos, value));
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::find_from(const_iterator pos, const Key& key)
+{
+    node_type* node = m_impl.find_from(const_cast<node_type*>(pos.get_node()), key);
+    if (node != m_impl.tail() && !m_impl.is_less(key, node->m_value)) {
+        return iterator(node);
+    }
+    return end();
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename>
+typename skip_list<T, C, A, G, S>::const_iterator skip_list<T, C, A, G, S>::find_from(const_iterator pos, const Key& key) const
 {
-    return const_iterator(const_cast<skip_list&>(this).upper_bound(value));
+    return const_iterator(const_cast<skip_list*>(this)->find_from(pos, key));
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::iterator skip_list<T, C, A, G, S>::nth(size_type index)
+{
+    return iterator(m_impl.at(index + 1));
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::const_iterator skip_list<T, C, A, G, S>::nth(size_type index) const
+{
+    return const_iterator(m_impl.at(index + 1));
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::size_type skip_list<T, C, A, G, S>::index_of(const_iterator pos) const
+{
+    return m_impl.rank(pos.get_node()) - 1;
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::difference_type skip_list<T, C, A, G, S>::distance(const_iterator first, const_iterator last) const
+{
+    return static_cast<difference_type>(index_of(last)) - static_cast<difference_type>(index_of(first));
+}
+
+template <class T, class C, class A, class G, class S>
+typename skip_list<T, C, A, G, S>::size_type skip_list<T, C, A, G, S>::count_range(const value_type& lo, const value_type& hi) const
+{
+    if (!m_impl.is_less(lo, hi)) {
+        return 0;
+    }
+    return m_impl.count_less(hi) - m_impl.count_less(lo);
 }
 
 } // namespace skip_list
@@ -0,0 +1,292 @@
+#pragma once
+
+namespace skip_list
+{
+
+template <class K, class M, class C, class A, class G>
+skip_map<K, M, C, A, G>::skip_map(const allocator_type& alloc)
+    : skip_map(key_compare(), alloc)
+{ }
+
+template <class K, class M, class C, class A, class G>
+skip_map<K, M, C, A, G>::skip_map(const key_compare& comp, const allocator_type& alloc)
+    : m_slab(alloc)
+    , m_impl(internal::sl_map_compare<C>(comp), entry_allocator(alloc))
+{ }
+
+template <class K, class M, class C, class A, class G>
+template <class InputIterator>
+skip_map<K, M, C, A, G>::skip_map(InputIterator first, InputIterator last, const allocator_type& alloc)
+    : skip_map(alloc)
+{
+    insert(first, last);
+}
+
+template <class K, class M, class C, class A, class G>
+skip_map<K, M, C, A, G>::skip_map(std::initializer_list<value_type> init, const allocator_type& alloc)
+    : skip_map(alloc)
+{
+    insert(init.begin(), init.end());
+}
+
+template <class K, class M, class C, class A, class G>
+skip_map<K, M, C, A, G>::skip_map(const skip_map& other)
+    : skip_map(other.key_comp(), std::allocator_traits<allocator_type>::select_on_container_copy_construction(other.get_allocator()))
+{
+    copy_entries(other);
+}
+
+template <class K, class M, class C, class A, class G>
+skip_map<K, M, C, A, G>::skip_map(skip_map&& other) noexcept(std::is_nothrow_move_constructible_v<impl_type>)
+    : m_slab(std::move(other.m_slab))
+    , m_impl(std::move(other.m_impl))
+{ }
+
+template <class K, class M, class C, class A, class G>
+skip_map<K, M, C, A, G>::~skip_map()
+{
+    clear();
+}
+
+template <class K, class M, class C, class A, class G>
+skip_map<K, M, C, A, G>& skip_map<K, M, C, A, G>::operator=(const skip_map& other)
+{
+    if (this != &other) {
+        clear();
+        copy_entries(other);
+    }
+    return *this;
+}
+
+template <class K, class M, class C, class A, class G>
+skip_map<K, M, C, A, G>& skip_map<K, M, C, A, G>::operator=(skip_map&& other) noexcept(std::is_nothrow_move_assignable_v<impl_type>)
+{
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    using alloc_traits = std::allocator_traits<allocator_type>;
+    if constexpr (!alloc_traits::propagate_on_container_move_assignment::value && !alloc_traits::is_always_equal::value) {
+        if (!(get_allocator() == other.get_allocator())) {
+            for (auto entry : other) {
+                try_emplace(entry.first, std::move(entry.second));
+            }
+            other.clear();
+            return *this;
+        }
+    }
+    // the out of line values follow their nodes, the slab of other gets the empty one
+    m_slab.swap(other.m_slab);
+    m_impl = std::move(other.m_impl);
+    return *this;
+}
+
+template <class K, class M, class C, class A, class G>
+void skip_map<K, M, C, A, G>::swap(skip_map& other) noexcept
+{
+    m_slab.swap(other.m_slab);
+    m_impl.swap(other.m_impl);
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::mapped_type& skip_map<K, M, C, A, G>::operator[](const key_type& key)
+{
+    return emplace_key(key).first->second;
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::mapped_type& skip_map<K, M, C, A, G>::operator[](key_type&& key)
+{
+    return emplace_key(std::move(key)).first->second;
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::mapped_type& skip_map<K, M, C, A, G>::at(const key_type& key)
+{
+    iterator it = find(key);
+    if (it == end()) {
+        throw std::out_of_range("skip_map::at");
+    }
+    return it->second;
+}
+
+template <class K, class M, class C, class A, class G>
+const typename skip_map<K, M, C, A, G>::mapped_type& skip_map<K, M, C, A, G>::at(const key_type& key) const
+{
+    return const_cast<skip_map*>(this)->at(key);
+}
+
+template <class K, class M, class C, class A, class G>
+void skip_map<K, M, C, A, G>::clear()
+{
+    if constexpr (!inline_mapped) {
+        if constexpr (!std::is_trivially_destructible_v<mapped_type>) {
+            for (node_type* node = m_impl.front(); node != m_impl.tail(); node = node->next(0)) {
+                std::destroy_at(node->m_value.storage());
+            }
+        }
+        m_slab.release();
+    }
+    m_impl.remove_all();
+}
+
+template <class K, class M, class C, class A, class G>
+std::pair<typename skip_map<K, M, C, A, G>::iterator, bool> skip_map<K, M, C, A, G>::insert(const value_type& value)
+{
+    return emplace_key(value.first, value.second);
+}
+
+template <class K, class M, class C, class A, class G>
+template <typename InputIterator>
+void skip_map<K, M, C, A, G>::insert(InputIterator first, InputIterator last)
+{
+    for (; first != last; ++first) {
+        emplace_key((*first).first, (*first).second);
+    }
+}
+
+template <class K, class M, class C, class A, class G>
+template <typename... Args>
+std::pair<typename skip_map<K, M, C, A, G>::iterator, bool> skip_map<K, M, C, A, G>::try_emplace(const key_type& key, Args&&... args)
+{
+    return emplace_key(key, std::forward<Args>(args)...);
+}
+
+template <class K, class M, class C, class A, class G>
+template <typename... Args>
+std::pair<typename skip_map<K, M, C, A, G>::iterator, bool> skip_map<K, M, C, A, G>::try_emplace(key_type&& key, Args&&... args)
+{
+    return emplace_key(std::move(key), std::forward<Args>(args)...);
+}
+
+template <class K, class M, class C, class A, class G>
+template <typename Obj>
+std::pair<typename skip_map<K, M, C, A, G>::iterator, bool> skip_map<K, M, C, A, G>::insert_or_assign(const key_type& key, Obj&& obj)
+{
+    auto result = emplace_key(key, std::forward<Obj>(obj));
+    if (!result.second) {
+        // obj was not used since nothing was inserted
+        result.first->second = std::forward<Obj>(obj);
+    }
+    return result;
+}
+
+template <class K, class M, class C, class A, class G>
+template <typename Obj>
+std::pair<typename skip_map<K, M, C, A, G>::iterator, bool> skip_map<K, M, C, A, G>::insert_or_assign(key_type&& key, Obj&& obj)
+{
+    auto result = emplace_key(std::move(key), std::forward<Obj>(obj));
+    if (!result.second) {
+        result.first->second = std::forward<Obj>(obj);
+    }
+    return result;
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::size_type skip_map<K, M, C, A, G>::erase(const key_type& key)
+{
+    const size_type old_size = m_impl.size();
+    m_impl.remove(key, [this](entry_type& entry) { dispose(entry); });
+    return old_size - m_impl.size();
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::iterator skip_map<K, M, C, A, G>::erase(const_iterator pos)
+{
+    assert(pos != cend());
+    node_type* node = pos.get_node();
+    dispose(node->m_value);
+    return iterator(m_impl.remove(node));
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::iterator skip_map<K, M, C, A, G>::find(const key_type& key)
+{
+    node_type* node = m_impl.find_first(key);
+    if (node != m_impl.tail() && !m_impl.is_less(key, node->m_value)) {
+        return iterator(node);
+    }
+    return end();
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::const_iterator skip_map<K, M, C, A, G>::find(const key_type& key) const
+{
+    return const_iterator(const_cast<skip_map*>(this)->find(key));
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::iterator skip_map<K, M, C, A, G>::lower_bound(const key_type& key)
+{
+    return iterator(m_impl.find_first(key));
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::const_iterator skip_map<K, M, C, A, G>::lower_bound(const key_type& key) const
+{
+    return const_iterator(const_cast<skip_map*>(this)->lower_bound(key));
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::iterator skip_map<K, M, C, A, G>::upper_bound(const key_type& key)
+{
+    node_type* node = m_impl.find_first(key);
+    if (node != m_impl.tail() && !m_impl.is_less(key, node->m_value)) {
+        node = node->next(0);
+    }
+    return iterator(node);
+}
+
+template <class K, class M, class C, class A, class G>
+typename skip_map<K, M, C, A, G>::const_iterator skip_map<K, M, C, A, G>::upper_bound(const key_type& key) const
+{
+    return const_iterator(const_cast<skip_map*>(this)->upper_bound(key));
+}
+
+template <class K, class M, class C, class A, class G>
+template <typename Key, typename... Args>
+std::pair<typename skip_map<K, M, C, A, G>::iterator, bool> skip_map<K, M, C, A, G>::emplace_key(Key&& key, Args&&... args)
+{
+    // the mapped value is only built by the entry constructor, after the search found no equal key
+    auto [node, inserted] = m_impl.try_emplace(key, std::forward<Key>(key), mapped_factory(std::forward<Args>(args)...));
+    return std::make_pair(iterator(node), inserted);
+}
+
+template <class K, class M, class C, class A, class G>
+template <typename... Args>
+auto skip_map<K, M, C, A, G>::mapped_factory(Args&&... args)
+{
+    return [this, &args...]() {
+        if constexpr (inline_mapped) {
+            return mapped_type(std::forward<Args>(args)...);
+        } else {
+            mapped_type* storage = m_slab.allocate();
+            try {
+                return ::new (static_cast<void*>(storage)) mapped_type(std::forward<Args>(args)...);
+            } catch (...) {
+                m_slab.deallocate(storage);
+                throw;
+            }
+        }
+    };
+}
+
+template <class K, class M, class C, class A, class G>
+void skip_map<K, M, C, A, G>::copy_entries(const skip_map& other)
+{
+    // the out of line values are copied into the slab of this map
+    m_impl.assign_copy(other.m_impl, [this](const entry_type& entry) {
+        return std::make_tuple(std::cref(entry.key()), mapped_factory(entry.mapped()));
+    });
+}
+
+template <class K, class M, class C, class A, class G>
+void skip_map<K, M, C, A, G>::dispose(entry_type& entry)
+{
+    if constexpr (!inline_mapped) {
+        std::destroy_at(entry.storage());
+        m_slab.deallocate(entry.storage());
+    }
+}
+
+} // namespace skip_list
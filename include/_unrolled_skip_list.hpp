@@ -0,0 +1,105 @@
+#pragma once
+
+namespace skip_list
+{
+
+template <class T, class C, class A, class G, std::size_t B>
+unrolled_skip_list<T, C, A, G, B>::unrolled_skip_list(const allocator_type& alloc)
+    : m_impl(alloc)
+{ }
+
+template <class T, class C, class A, class G, std::size_t B>
+template <class InputIterator>
+unrolled_skip_list<T, C, A, G, B>::unrolled_skip_list(InputIterator first, InputIterator last, const allocator_type& alloc)
+    : m_impl(alloc)
+{
+    insert(first, last);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+unrolled_skip_list<T, C, A, G, B>::unrolled_skip_list(std::initializer_list<T> init, const allocator_type& alloc)
+    : m_impl(alloc)
+{
+    insert(init.begin(), init.end());
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+unrolled_skip_list<T, C, A, G, B>& unrolled_skip_list<T, C, A, G, B>::operator=(const unrolled_skip_list& other)
+{
+    m_impl = other.m_impl;
+    return *this;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+unrolled_skip_list<T, C, A, G, B>& unrolled_skip_list<T, C, A, G, B>::operator=(unrolled_skip_list&& other) noexcept(std::is_nothrow_move_assignable_v<impl_type>)
+{
+    m_impl = std::move(other.m_impl);
+    return *this;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+std::pair<typename unrolled_skip_list<T, C, A, G, B>::iterator, bool> unrolled_skip_list<T, C, A, G, B>::insert(const value_type& value)
+{
+    const auto [pos, inserted] = m_impl.insert(value);
+    return std::make_pair(iterator(pos.first, pos.second), inserted);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+template <typename InputIterator>
+void unrolled_skip_list<T, C, A, G, B>::insert(InputIterator first, InputIterator last)
+{
+    for (; first != last; ++first) {
+        m_impl.insert(*first);
+    }
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename unrolled_skip_list<T, C, A, G, B>::iterator unrolled_skip_list<T, C, A, G, B>::erase(const_iterator pos)
+{
+    const position_type next = m_impl.erase(position_type(pos.get_node(), pos.get_index()));
+    return iterator(next.first, next.second);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename unrolled_skip_list<T, C, A, G, B>::iterator unrolled_skip_list<T, C, A, G, B>::find(const value_type& value)
+{
+    const position_type pos = m_impl.find(value);
+    return iterator(pos.first, pos.second);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename unrolled_skip_list<T, C, A, G, B>::const_iterator unrolled_skip_list<T, C, A, G, B>::find(const value_type& value) const
+{
+    return const_iterator(const_cast<unrolled_skip_list*>(this)->find(value));
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename unrolled_skip_list<T, C, A, G, B>::iterator unrolled_skip_list<T, C, A, G, B>::lower_bound(const value_type& value)
+{
+    const position_type pos = m_impl.lower_bound(value);
+    return iterator(pos.first, pos.second);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename unrolled_skip_list<T, C, A, G, B>::const_iterator unrolled_skip_list<T, C, A, G, B>::lower_bound(const value_type& value) const
+{
+    return const_iterator(const_cast<unrolled_skip_list*>(this)->lower_bound(value));
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename unrolled_skip_list<T, C, A, G, B>::iterator unrolled_skip_list<T, C, A, G, B>::upper_bound(const value_type& value)
+{
+    iterator it = lower_bound(value);
+    if (it != end() && !m_impl.is_less(value, *it)) {
+        ++it;
+    }
+    return it;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename unrolled_skip_list<T, C, A, G, B>::const_iterator unrolled_skip_list<T, C, A, G, B>::upper_bound(const value_type& value) const
+{
+    return const_iterator(const_cast<unrolled_skip_list*>(this)->upper_bound(value));
+}
+
+} // namespace skip_list
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <initializer_list>
+#include <memory>
+
+#include "internal/csl_impl.hpp"
+#include "level_generator.hpp"
+
+namespace skip_list
+{
+
+/**
+ * @brief Lock-free ordered set
+ *
+ * insert(), erase() and the lookups may be called concurrently from any
+ * number of threads. Erased nodes are reclaimed through epochs once no
+ * thread can still read them.
+ *
+ * Iterators are weakly consistent: they never return an element twice,
+ * see every element present for the whole iteration and may or may not
+ * see concurrent changes. A live iterator holds reclamation back and must
+ * be used only by the thread which obtained it.
+ *
+ * The allocator must be thread-safe.
+ */
+template <typename T,
+          typename Compare = std::less<T>,
+          typename Allocator = std::allocator<T>,
+          typename LevelGenerator = level_generator<>>
+class concurrent_skip_list
+{
+private:
+    using impl_type = internal::csl_impl<T, Compare, Allocator, LevelGenerator>;
+    using node_type = typename impl_type::node_type;
+
+public:
+    using value_type                = typename impl_type::value_type;
+    using size_type                 = typename impl_type::size_type;
+    using allocator_type            = typename impl_type::allocator_type;
+    using difference_type           = typename std::allocator_traits<allocator_type>::difference_type;
+    using reference                 = typename impl_type::reference;
+    using const_reference           = typename impl_type::const_reference;
+    using pointer                   = typename impl_type::pointer;
+    using const_pointer             = typename impl_type::const_pointer;
+    using compare                   = typename impl_type::compare;
+    using level_generator_type      = typename impl_type::level_generator_type;
+
+    using iterator                  = internal::csl_iterator<impl_type>;
+    using const_iterator            = iterator;
+
+    ///@{ @name Member functions
+
+    ///@{ @name Constructors and destructor
+
+    explicit concurrent_skip_list(const allocator_type& alloc = allocator_type());
+    template <class InputIterator>
+    concurrent_skip_list(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type());
+    concurrent_skip_list(std::initializer_list<T> init, const allocator_type& alloc = allocator_type());
+
+    concurrent_skip_list(const concurrent_skip_list&) = delete;
+    concurrent_skip_list& operator=(const concurrent_skip_list&) = delete;
+
+    ~concurrent_skip_list() = default;
+
+    ///@}
+
+    allocator_type get_allocator() const { return m_impl.get_allocator(); }
+
+    /**
+     * @brief The generator of the list, e.g. to seed it
+     * Every thread draws from a generator of its own, split from this one
+     * the first time the thread inserts into the list: the same seed and
+     * the same inserts from one thread build the same towers. Not
+     * thread-safe, set it up before the list is shared.
+     */
+    level_generator_type& get_level_generator() { return m_impl.get_level_generator(); }
+    const level_generator_type& get_level_generator() const { return m_impl.get_level_generator(); }
+
+    ///@{ @name Iterators
+
+    iterator begin() const;
+    iterator cbegin() const         { return begin(); }
+    iterator end() const            { return iterator(); }
+    iterator cend() const           { return iterator(); }
+
+    ///@}
+
+    ///@{ @name Capacity
+
+    /// Exact only without concurrent modifications.
+    bool      empty() const         { return m_impl.size() == 0; }
+    size_type size() const          { return m_impl.size(); }
+
+    ///@}
+
+    ///@{ @name Modifiers
+
+    /// Not thread-safe, no other thread may use the list meanwhile.
+    void clear() { m_impl.remove_all(); }
+
+    std::pair<iterator, bool> insert(const value_type& value);
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last);
+    void insert(std::initializer_list<T> init);
+
+    /// @return The number of erased elements, 0 if another thread erased it first
+    size_type erase(const value_type& value);
+
+    /**
+     * @brief Remove the smallest element and copy it to value
+     * All the threads popping compete for the first node, spray_pop_min()
+     * spreads them when there are many.
+     * @return false if the list is empty
+     */
+    bool try_pop_min(value_type& value);
+    /**
+     * @brief Remove one of the smallest elements and copy it to value
+     * Relaxed delete-min after the SprayList: every call removes an element
+     * picked at random among the first O(p log^3 p), p being the number of
+     * threads popping at once, so they rarely fight for the same node. With
+     * a single thread it is the smallest element.
+     * @param threads Number of threads popping at once, 0 for std::thread::hardware_concurrency()
+     * @return false if the list is empty
+     */
+    bool spray_pop_min(value_type& value, size_type threads = 0);
+
+    ///@}
+
+    ///@{ @name Lookup
+
+    bool contains(const value_type& value) const;
+    size_type count(const value_type& value) const { return contains(value) ? 1 : 0; }
+
+    iterator find(const value_type& value) const;
+    iterator lower_bound(const value_type& value) const;
+    iterator upper_bound(const value_type& value) const;
+
+    ///@}
+
+    ///@}
+
+private:
+    internal::sl_epoch::guard pin() const { return m_impl.epoch().pin(); }
+
+private:
+    impl_type m_impl;
+
+}; // concurrent_skip_list
+
+} // namespace skip_list
+
+#include "_concurrent_skip_list.hpp"
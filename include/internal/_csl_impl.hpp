@@ -0,0 +1,466 @@
+#pragma once
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+template <class T>
+csl_node<T>::csl_node(sentinel_tag, size_type level)
+    : m_level(level)
+    , m_refs(1)
+{
+    for (size_type i = 0; i <= level; ++i) {
+        ::new (static_cast<void*>(&tower()[i])) link_type(0);
+    }
+}
+
+template <class T>
+template <typename... Args>
+csl_node<T>::csl_node(size_type level, Args&&... args)
+    : m_value(std::forward<Args>(args)...)
+    , m_level(level)
+    , m_refs(2)
+{
+    for (size_type i = 0; i <= level; ++i) {
+        ::new (static_cast<void*>(&tower()[i])) link_type(0);
+    }
+}
+
+
+
+template <class T, class C, class A, class G>
+csl_impl<T, C, A, G>::csl_impl(const allocator_type& alloc)
+    : m_alloc(alloc)
+    , m_levels(0)
+    , m_states(nullptr)
+    , m_states_mutex()
+    , m_size_estimate(0)
+    , m_id(next_id())
+    , m_head(nullptr)
+    , m_less()
+    , m_level_generator()
+    , m_epoch(&csl_impl::dispose, this)
+{
+    const size_type count = storage_count(max_levels - 1);
+    node_storage* storage = node_alloc_traits::allocate(m_alloc, count);
+    m_head = ::new (static_cast<void*>(storage)) node_type(typename node_type::sentinel_tag(), max_levels - 1);
+}
+
+template <class T, class C, class A, class G>
+csl_impl<T, C, A, G>::~csl_impl()
+{
+    remove_all();
+    destroy_node(m_head);
+    thread_state* state = m_states.load();
+    while (state != nullptr) {
+        thread_state* next = state->m_next;
+        delete state;
+        state = next;
+    }
+}
+
+template <class T, class C, class A, class G>
+typename csl_impl<T, C, A, G>::size_type csl_impl<T, C, A, G>::size() const
+{
+    std::ptrdiff_t total = 0;
+    for (const thread_state* state = m_states.load(std::memory_order_acquire); state != nullptr; state = state->m_next) {
+        total += state->m_size.load(std::memory_order_relaxed);
+    }
+    // a removal may be counted before the insert of another thread
+    return total > 0 ? static_cast<size_type>(total) : 0;
+}
+
+template <class T, class C, class A, class G>
+template <typename... Args>
+typename csl_impl<T, C, A, G>::node_type* csl_impl<T, C, A, G>::create_node(level_type level, Args&&... args)
+{
+    const size_type count = storage_count(level);
+    node_storage* storage = node_alloc_traits::allocate(m_alloc, count);
+    try {
+        return ::new (static_cast<void*>(storage)) node_type(level, std::forward<Args>(args)...);
+    } catch (...) {
+        node_alloc_traits::deallocate(m_alloc, storage, count);
+        throw;
+    }
+}
+
+template <class T, class C, class A, class G>
+void csl_impl<T, C, A, G>::destroy_node(node_type* node)
+{
+    const size_type count = storage_count(node->m_level);
+    if (node != m_head) {
+        node->m_value.~value_type();
+    }
+    node->~node_type();
+    node_alloc_traits::deallocate(m_alloc, reinterpret_cast<node_storage*>(node), count);
+}
+
+template <class T, class C, class A, class G>
+void csl_impl<T, C, A, G>::dispose(void* context, void* object)
+{
+    static_cast<csl_impl*>(context)->destroy_node(static_cast<node_type*>(object));
+}
+
+template <class T, class C, class A, class G>
+void csl_impl<T, C, A, G>::release(node_type* node)
+{
+    if (node->m_refs.fetch_sub(1) == 1) {
+        m_epoch.retire(node);
+    }
+}
+
+template <class T, class C, class A, class G>
+typename csl_impl<T, C, A, G>::thread_state& csl_impl<T, C, A, G>::local_state()
+{
+    thread_local std::vector<std::pair<std::uint64_t, thread_state*>> cache;
+    for (auto& entry : cache) {
+        if (entry.first == m_id) {
+            return *entry.second;
+        }
+    }
+    // not cached, the thread may still own a state evicted from its cache
+    const std::thread::id self = std::this_thread::get_id();
+    thread_state* state = m_states.load(std::memory_order_acquire);
+    while (state != nullptr && state->m_owner != self) {
+        state = state->m_next;
+    }
+    if (state == nullptr) {
+        std::lock_guard<std::mutex> lock(m_states_mutex);
+        if constexpr (csl_has_split<level_generator_type>::value) {
+            state = new thread_state(self, m_level_generator.split());
+        } else {
+            state = new thread_state(self, level_generator_type());
+        }
+        state->m_next = m_states.load(std::memory_order_relaxed);
+        m_states.store(state, std::memory_order_release);
+    }
+    if (cache.size() == cache_size) {
+        cache.erase(cache.begin());
+    }
+    cache.emplace_back(m_id, state);
+    return *state;
+}
+
+template <class T, class C, class A, class G>
+void csl_impl<T, C, A, G>::count(thread_state& state, std::ptrdiff_t delta)
+{
+    // the owner is the only writer, no read-modify-write needed
+    state.m_size.store(state.m_size.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    state.m_unpublished += delta;
+    if (state.m_unpublished >= publish_period || state.m_unpublished <= -publish_period) {
+        m_size_estimate.fetch_add(state.m_unpublished, std::memory_order_relaxed);
+        state.m_unpublished = 0;
+    }
+}
+
+template <class T, class C, class A, class G>
+typename csl_impl<T, C, A, G>::level_type csl_impl<T, C, A, G>::random_level(thread_state& state)
+{
+    const std::ptrdiff_t estimate = m_size_estimate.load(std::memory_order_relaxed) + state.m_unpublished;
+    size_type count = (estimate > 0 ? static_cast<size_type>(estimate) : 0) + 1;
+    level_type limit = 0;
+    while ((count >>= 1) != 0) {
+        ++limit;
+    }
+    return state.m_level_generator(std::min(limit, max_levels - 1));
+}
+
+template <class T, class C, class A, class G>
+void csl_impl<T, C, A, G>::raise_levels(level_type level)
+{
+    level_type current = m_levels.load();
+    while (current < level && !m_levels.compare_exchange_weak(current, level)) {
+    }
+}
+
+template <class T, class C, class A, class G>
+typename csl_impl<T, C, A, G>::node_type* csl_impl<T, C, A, G>::next_of(const node_type* node, level_type level)
+{
+    node_type* curr = node_type::to_node(node->next(level).load(std::memory_order_acquire));
+    while (curr != nullptr) {
+        const std::uintptr_t succ = curr->next(level).load(std::memory_order_acquire);
+        if (!node_type::is_marked(succ)) {
+            break;
+        }
+        curr = node_type::to_node(succ);
+    }
+    return curr;
+}
+
+template <class T, class C, class A, class G>
+template <typename Before>
+typename csl_impl<T, C, A, G>::node_type* csl_impl<T, C, A, G>::search(Before before) const
+{
+    const node_type* pred = m_head;
+    node_type* curr = nullptr;
+    for (level_type level = m_levels.load(std::memory_order_acquire) + 1; level > 0; ) {
+        --level;
+        curr = node_type::to_node(pred->next(level).load(std::memory_order_acquire));
+        while (curr != nullptr) {
+            const std::uintptr_t succ = curr->next(level).load(std::memory_order_acquire);
+            if (node_type::is_marked(succ)) {
+                // being removed, step over it without helping
+                curr = node_type::to_node(succ);
+                continue;
+            }
+            if (!before(curr)) {
+                break;
+            }
+            pred = curr;
+            curr = node_type::to_node(succ);
+        }
+    }
+    return curr;
+}
+
+template <class T, class C, class A, class G>
+typename csl_impl<T, C, A, G>::node_type* csl_impl<T, C, A, G>::find(const_reference value) const
+{
+    node_type* node = lower_bound(value);
+    return (node != nullptr && !m_less(value, node->m_value)) ? node : nullptr;
+}
+
+template <class T, class C, class A, class G>
+typename csl_impl<T, C, A, G>::node_type* csl_impl<T, C, A, G>::lower_bound(const_reference value) const
+{
+    return search([this, &value](const node_type* node) { return m_less(node->m_value, value); });
+}
+
+template <class T, class C, class A, class G>
+typename csl_impl<T, C, A, G>::node_type* csl_impl<T, C, A, G>::upper_bound(const_reference value) const
+{
+    return search([this, &value](const node_type* node) { return !m_less(value, node->m_value); });
+}
+
+template <class T, class C, class A, class G>
+bool csl_impl<T, C, A, G>::find_predecessors(const_reference value, node_type** preds, node_type** succs, level_type top)
+{
+    // start high enough to skip over the list, the levels above m_levels point to nothing
+    top = std::max(top, m_levels.load());
+retry:
+    node_type* pred = m_head;
+    for (level_type level = top + 1; level > 0; ) {
+        --level;
+        node_type* curr = node_type::to_node(pred->next(level).load(std::memory_order_acquire));
+        while (curr != nullptr) {
+            std::uintptr_t succ = curr->next(level).load(std::memory_order_acquire);
+            while (node_type::is_marked(succ)) {
+                // help the removal: snip the marked node out of this level
+                std::uintptr_t expected = node_type::to_link(curr);
+                if (!pred->next(level).compare_exchange_strong(expected, succ & ~std::uintptr_t(1))) {
+                    goto retry;
+                }
+                curr = node_type::to_node(succ);
+                if (curr == nullptr) {
+                    break;
+                }
+                succ = curr->next(level).load(std::memory_order_acquire);
+            }
+            if (curr == nullptr || !m_less(curr->m_value, value)) {
+                break;
+            }
+            pred = curr;
+            curr = node_type::to_node(succ);
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return succs[0] != nullptr && !m_less(value, succs[0]->m_value);
+}
+
+template <class T, class C, class A, class G>
+std::pair<typename csl_impl<T, C, A, G>::node_type*, bool> csl_impl<T, C, A, G>::insert(const value_type& value)
+{
+    node_type* preds[max_levels];
+    node_type* succs[max_levels];
+    thread_state& state = local_state();
+    const level_type node_level = random_level(state);
+    node_type* node = nullptr;
+
+    for (;;) {
+        if (find_predecessors(value, preds, succs, node_level)) {
+            if (node != nullptr) {
+                destroy_node(node); // never published
+            }
+            return std::make_pair(succs[0], false);
+        }
+        if (node == nullptr) {
+            node = create_node(node_level, value);
+        }
+        for (level_type level = 0; level <= node_level; ++level) {
+            node->next(level).store(node_type::to_link(succs[level]), std::memory_order_relaxed);
+        }
+        std::uintptr_t expected = node_type::to_link(succs[0]);
+        if (preds[0]->next(0).compare_exchange_strong(expected, node_type::to_link(node))) {
+            break;
+        }
+    }
+    count(state, 1);
+    raise_levels(node_level);
+
+    // level 0 makes the value present, the upper levels are only shortcuts
+    for (level_type level = 1; level <= node_level; ++level) {
+        for (;;) {
+            std::uintptr_t link = node->next(level).load();
+            if (node_type::is_marked(link)) {
+                goto linked; // removed meanwhile, stop linking
+            }
+            if (node_type::to_node(link) != succs[level] &&
+                    !node->next(level).compare_exchange_strong(link, node_type::to_link(succs[level]))) {
+                continue;
+            }
+            std::uintptr_t expected = node_type::to_link(succs[level]);
+            if (preds[level]->next(level).compare_exchange_strong(expected, node_type::to_link(node))) {
+                break;
+            }
+            find_predecessors(value, preds, succs, node_level);
+            if (succs[0] != node) {
+                goto linked; // removed meanwhile
+            }
+        }
+    }
+linked:
+    if (node_type::is_marked(node->next(0).load())) {
+        // the remover may have finished before the upper levels were linked
+        find_predecessors(value, preds, succs, node_level);
+    }
+    release(node);
+    return std::make_pair(node, true);
+}
+
+template <class T, class C, class A, class G>
+bool csl_impl<T, C, A, G>::remove(const_reference value)
+{
+    node_type* preds[max_levels];
+    node_type* succs[max_levels];
+    if (!find_predecessors(value, preds, succs, 0)) {
+        return false;
+    }
+    node_type* victim = succs[0];
+    if (!claim(victim)) {
+        return false; // someone else removed it
+    }
+    finish_remove(victim);
+    return true;
+}
+
+template <class T, class C, class A, class G>
+bool csl_impl<T, C, A, G>::claim(node_type* victim)
+{
+    for (level_type level = victim->m_level; level > 0; --level) {
+        std::uintptr_t link = victim->next(level).load();
+        while (!node_type::is_marked(link) &&
+                !victim->next(level).compare_exchange_weak(link, link | 1)) {
+        }
+    }
+    std::uintptr_t link = victim->next(0).load();
+    for (;;) {
+        if (node_type::is_marked(link)) {
+            return false;
+        }
+        if (victim->next(0).compare_exchange_weak(link, link | 1)) {
+            return true;
+        }
+    }
+}
+
+template <class T, class C, class A, class G>
+void csl_impl<T, C, A, G>::finish_remove(node_type* victim)
+{
+    node_type* preds[max_levels];
+    node_type* succs[max_levels];
+    count(local_state(), -1);
+    // unlink from every level
+    find_predecessors(victim->m_value, preds, succs, victim->m_level);
+    release(victim);
+}
+
+template <class T, class C, class A, class G>
+bool csl_impl<T, C, A, G>::take(node_type* victim, value_type& value)
+{
+    if (!claim(victim)) {
+        return false;
+    }
+    try {
+        value = victim->m_value; // other threads may still be comparing it, no move
+    } catch (...) {
+        finish_remove(victim);
+        throw;
+    }
+    finish_remove(victim);
+    return true;
+}
+
+template <class T, class C, class A, class G>
+bool csl_impl<T, C, A, G>::remove_min(value_type& value)
+{
+    for (;;) {
+        node_type* victim = next_of(m_head);
+        if (victim == nullptr) {
+            return false;
+        }
+        if (take(victim, value)) {
+            return true;
+        }
+    }
+}
+
+template <class T, class C, class A, class G>
+bool csl_impl<T, C, A, G>::spray_remove_min(value_type& value, size_type threads)
+{
+    level_type log_p = 0;
+    for (size_type p = threads; p > 1; p >>= 1) {
+        ++log_p;
+    }
+    const size_type max_jump = log_p * log_p * log_p;
+    // the jumps only spread the threads, any cheap per-thread source does
+    static thread_local std::minstd_rand random(std::random_device{}());
+    for (size_type attempt = 0; attempt < spray_attempts; ++attempt) {
+        const node_type* curr = m_head;
+        for (level_type level = std::min(log_p + 1, m_levels.load(std::memory_order_acquire)) + 1; level > 0; ) {
+            --level;
+            for (size_type jump = random() % (max_jump + 1); jump > 0; --jump) {
+                node_type* next = next_of(curr, level);
+                if (next == nullptr) {
+                    break;
+                }
+                curr = next;
+            }
+        }
+        node_type* victim = (curr == m_head) ? next_of(m_head) : const_cast<node_type*>(curr);
+        if (victim == nullptr) {
+            return false;
+        }
+        if (take(victim, value)) {
+            return true;
+        }
+    }
+    return remove_min(value);
+}
+
+template <class T, class C, class A, class G>
+void csl_impl<T, C, A, G>::remove_all()
+{
+    node_type* node = node_type::to_node(m_head->next(0).load());
+    while (node != nullptr) {
+        node_type* next = node_type::to_node(node->next(0).load());
+        destroy_node(node);
+        node = next;
+    }
+    m_epoch.reclaim_all();
+    for (level_type level = 0; level < max_levels; ++level) {
+        m_head->next(level).store(0);
+    }
+    m_levels.store(0);
+    for (thread_state* state = m_states.load(); state != nullptr; state = state->m_next) {
+        state->m_size.store(0);
+        state->m_unpublished = 0;
+    }
+    m_size_estimate.store(0);
+}
+
+} // namespace internal
+
+} // namespace skip_list
@@ -0,0 +1,518 @@
+#pragma once
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+inline void msl_mapping::create(const std::string& path, size_type size)
+{
+    close();
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0) {
+        fail("mapped_skip_list: open");
+    }
+    // the journal of a former file of that name must not be replayed on this one
+    open_journal(path, true);
+    if (::ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+        fail("mapped_skip_list: ftruncate");
+    }
+    map(size);
+}
+
+inline void msl_mapping::open(const std::string& path)
+{
+    close();
+    m_fd = ::open(path.c_str(), O_RDWR);
+    if (m_fd < 0) {
+        fail("mapped_skip_list: open");
+    }
+    open_journal(path, false);
+    replay();
+    struct stat info;
+    if (::fstat(m_fd, &info) != 0) {
+        fail("mapped_skip_list: fstat");
+    }
+    map(static_cast<size_type>(info.st_size));
+}
+
+inline void msl_mapping::grow(size_type size)
+{
+    assert(size > m_size);
+    // the file only gets zeros past its end, which no synced header counts
+    if (::ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+        fail("mapped_skip_list: ftruncate");
+    }
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, m_fd, 0);
+    if (data == MAP_FAILED) {
+        fail("mapped_skip_list: mmap");
+    }
+    // the changed pages are private to the old mapping
+    char* grown = static_cast<char*>(data);
+    for (size_type page = 0; page < page_count(m_size); ++page) {
+        if (is_dirty(page)) {
+            const size_type offset = page * m_page;
+            std::copy(m_data + offset, m_data + std::min(offset + m_page, m_size), grown + offset);
+        }
+    }
+    ::munmap(m_data, m_size);
+    m_data = grown;
+    m_size = size;
+    m_dirty.resize((page_count(size) + 63) / 64, 0);
+}
+
+inline char* msl_mapping::write(size_type offset, size_type length)
+{
+    assert(offset + length <= m_size);
+    for (size_type page = offset / m_page; page < page_count(offset + length); ++page) {
+        m_dirty[page / 64] |= std::uint64_t(1) << (page % 64);
+    }
+    return m_data + offset;
+}
+
+inline void msl_mapping::sync()
+{
+    // the runs of consecutive changed pages
+    std::vector<std::pair<size_type, size_type>> runs;
+    size_type length = 0;
+    for (size_type page = 0; page < page_count(m_size); ++page) {
+        if (!is_dirty(page)) {
+            continue;
+        }
+        const size_type offset = page * m_page;
+        const size_type end = std::min(offset + m_page, m_size);
+        if (!runs.empty() && runs.back().first + runs.back().second == offset) {
+            runs.back().second += end - offset;
+        } else {
+            runs.emplace_back(offset, end - offset);
+            length += 2 * sizeof(std::uint64_t);
+        }
+        length += end - offset;
+    }
+    if (runs.empty()) {
+        return;
+    }
+
+    // the header goes last, its checksum only matches once the runs are whole
+    msl_journal_header info{msl_journal_header::magic, m_size, length, 0};
+    info.m_checksum = checksum(&info, offsetof(msl_journal_header, m_checksum), checksum_basis);
+    if (::ftruncate(m_journal, 0) != 0) {
+        fail("mapped_skip_list: ftruncate");
+    }
+    size_type position = sizeof(msl_journal_header);
+    for (const auto& [offset, size] : runs) {
+        const std::uint64_t run[2] = {offset, size};
+        write_all(m_journal, run, sizeof(run), position);
+        write_all(m_journal, m_data + offset, size, position + sizeof(run));
+        info.m_checksum = checksum(m_data + offset, size, checksum(run, sizeof(run), info.m_checksum));
+        position += sizeof(run) + size;
+    }
+    write_all(m_journal, &info, sizeof(info), 0);
+    if (::fdatasync(m_journal) != 0) {
+        fail("mapped_skip_list: fdatasync");
+    }
+
+    for (const auto& [offset, size] : runs) {
+        write_all(m_fd, m_data + offset, size, offset);
+    }
+    if (::fdatasync(m_fd) != 0) {
+        fail("mapped_skip_list: fdatasync");
+    }
+    // a journal found again after a crash only writes the same bytes once more
+    if (::ftruncate(m_journal, 0) != 0) {
+        fail("mapped_skip_list: ftruncate");
+    }
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+}
+
+inline void msl_mapping::close()
+{
+    if (m_data != nullptr) {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+        m_dirty.clear();
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (m_journal >= 0) {
+        // an empty journal is not needed to open the file, one left by a failed sync is
+        struct stat info;
+        if (::fstat(m_journal, &info) == 0 && info.st_size == 0) {
+            ::unlink(m_journal_path.c_str());
+        }
+        ::close(m_journal);
+        m_journal = -1;
+    }
+}
+
+inline void msl_mapping::map(size_type size)
+{
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, m_fd, 0);
+    if (data == MAP_FAILED) {
+        fail("mapped_skip_list: mmap");
+    }
+    m_data = static_cast<char*>(data);
+    m_size = size;
+    m_page = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+    m_dirty.assign((page_count(size) + 63) / 64, 0);
+}
+
+inline void msl_mapping::open_journal(const std::string& path, bool truncate)
+{
+    m_journal_path = path + "-journal";
+    m_journal = ::open(m_journal_path.c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+    if (m_journal < 0) {
+        fail("mapped_skip_list: open");
+    }
+    // the journal must still be found after a crash in the middle of a sync
+    const std::string::size_type slash = path.rfind('/');
+    const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    const int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fail("mapped_skip_list: open");
+    }
+    const int result = ::fsync(fd);
+    ::close(fd);
+    if (result != 0) {
+        fail("mapped_skip_list: fsync");
+    }
+}
+
+inline void msl_mapping::replay()
+{
+    struct stat status;
+    if (::fstat(m_journal, &status) != 0) {
+        fail("mapped_skip_list: fstat");
+    }
+    const size_type journal_size = static_cast<size_type>(status.st_size);
+    msl_journal_header info{};
+    if (journal_size < sizeof(info)) {
+        return;
+    }
+    read_all(m_journal, &info, sizeof(info), 0);
+    if (info.m_magic != msl_journal_header::magic || info.m_length != journal_size - sizeof(info)) {
+        return; // torn before its header, the file was not touched yet
+    }
+    std::vector<char> runs(static_cast<size_type>(info.m_length));
+    read_all(m_journal, runs.data(), runs.size(), sizeof(info));
+    std::uint64_t hash = checksum(&info, offsetof(msl_journal_header, m_checksum), checksum_basis);
+    for (size_type position = 0; position < runs.size(); ) {
+        std::uint64_t run[2];
+        if (runs.size() - position < sizeof(run)) {
+            return;
+        }
+        std::copy(runs.data() + position, runs.data() + position + sizeof(run), reinterpret_cast<char*>(run));
+        if (run[1] > runs.size() - position - sizeof(run)) {
+            return;
+        }
+        hash = checksum(runs.data() + position + sizeof(run), static_cast<size_type>(run[1]), checksum(run, sizeof(run), hash));
+        position += sizeof(run) + static_cast<size_type>(run[1]);
+    }
+    if (hash != info.m_checksum) {
+        return;
+    }
+
+    if (::fstat(m_fd, &status) != 0) {
+        fail("mapped_skip_list: fstat");
+    }
+    if (static_cast<std::uint64_t>(status.st_size) < info.m_file_size &&
+            ::ftruncate(m_fd, static_cast<off_t>(info.m_file_size)) != 0) {
+        fail("mapped_skip_list: ftruncate");
+    }
+    for (size_type position = 0; position < runs.size(); ) {
+        std::uint64_t run[2];
+        std::copy(runs.data() + position, runs.data() + position + sizeof(run), reinterpret_cast<char*>(run));
+        write_all(m_fd, runs.data() + position + sizeof(run), static_cast<size_type>(run[1]), static_cast<size_type>(run[0]));
+        position += sizeof(run) + static_cast<size_type>(run[1]);
+    }
+    if (::fdatasync(m_fd) != 0) {
+        fail("mapped_skip_list: fdatasync");
+    }
+    if (::ftruncate(m_journal, 0) != 0) {
+        fail("mapped_skip_list: ftruncate");
+    }
+}
+
+inline std::uint64_t msl_mapping::checksum(const void* data, size_type length, std::uint64_t hash)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_type i = 0; i < length; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3;
+    }
+    return hash;
+}
+
+inline void msl_mapping::write_all(int fd, const void* data, size_type length, size_type offset)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (length > 0) {
+        const ssize_t written = ::pwrite(fd, bytes, length, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fail("mapped_skip_list: pwrite");
+        }
+        bytes += written;
+        offset += static_cast<size_type>(written);
+        length -= static_cast<size_type>(written);
+    }
+}
+
+inline void msl_mapping::read_all(int fd, void* data, size_type length, size_type offset)
+{
+    char* bytes = static_cast<char*>(data);
+    while (length > 0) {
+        const ssize_t count = ::pread(fd, bytes, length, static_cast<off_t>(offset));
+        if (count <= 0) {
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            fail("mapped_skip_list: pread");
+        }
+        bytes += count;
+        offset += static_cast<size_type>(count);
+        length -= static_cast<size_type>(count);
+    }
+}
+
+template <class T, class C, class G>
+msl_impl<T, C, G>::~msl_impl()
+{
+    if (is_open()) {
+        try {
+            sync();
+        } catch (...) {
+            // the file keeps its last synced state, or the journal of this sync
+        }
+    }
+}
+
+template <class T, class C, class G>
+void msl_impl<T, C, G>::create(const std::string& path, size_type capacity)
+{
+    // the mapping alone would unmap the file open now without its last changes
+    close();
+    const size_type sentinels = sizeof(msl_header) + 2 * node_type::allocation_size(max_levels - 1);
+    m_file.create(path, std::max(capacity, sentinels));
+    msl_header& info = write_header();
+    info.m_magic = msl_header::magic;
+    info.m_value_size = sizeof(T);
+    info.m_value_align = alignof(T);
+    info.m_capacity = m_file.size();
+    info.m_used = sizeof(msl_header);
+    info.m_size = 0;
+    info.m_levels = 0;
+    std::fill(info.m_free, info.m_free + max_levels, 0);
+    const offset_type head_offset = create_sentinel();
+    const offset_type tail_offset = create_sentinel();
+    msl_header& links = write_header();
+    links.m_head = head_offset;
+    links.m_tail = tail_offset;
+    links.m_first = links.m_used;
+    node_type* head_node = write_node(head_offset);
+    for (level_type level = 0; level < max_levels; ++level) {
+        head_node->next(level) = tail_offset;
+    }
+    write_node(tail_offset)->m_prev = head_offset;
+    sync();
+}
+
+template <class T, class C, class G>
+void msl_impl<T, C, G>::open(const std::string& path)
+{
+    close();
+    m_file.open(path);
+    const auto reject = [this](const char* what) {
+        m_file.close();
+        throw std::runtime_error(what);
+    };
+    if (m_file.size() < sizeof(msl_header) || header().m_magic != msl_header::magic) {
+        reject("mapped_skip_list: not a mapped_skip_list file");
+    }
+    const msl_header& info = header();
+    if (info.m_value_size != sizeof(T) || info.m_value_align != alignof(T)) {
+        reject("mapped_skip_list: the file holds another value type");
+    }
+    if (info.m_capacity > m_file.size() || info.m_used > info.m_capacity) {
+        reject("mapped_skip_list: truncated file");
+    }
+    if (info.m_capacity < m_file.size()) {
+        // grown before a crash and not synced since, the room is free
+        write_header().m_capacity = m_file.size();
+    }
+}
+
+template <class T, class C, class G>
+void msl_impl<T, C, G>::close()
+{
+    if (is_open()) {
+        sync();
+        m_file.close();
+    }
+}
+
+template <class T, class C, class G>
+void msl_impl<T, C, G>::sync()
+{
+    assert(is_open());
+    m_file.sync();
+}
+
+template <class T, class C, class G>
+typename msl_impl<T, C, G>::offset_type msl_impl<T, C, G>::allocate(level_type level)
+{
+    const offset_type free = header().m_free[level];
+    if (free != 0) {
+        write_header().m_free[level] = node(free)->m_prev;
+        return free;
+    }
+    const size_type size = node_type::allocation_size(level);
+    if (header().m_used + size > header().m_capacity) {
+        m_file.grow(std::max(m_file.size() * 2, static_cast<size_type>(header().m_used) + size));
+        write_header().m_capacity = m_file.size();
+    }
+    const offset_type offset = header().m_used;
+    write_header().m_used += size;
+    return offset;
+}
+
+template <class T, class C, class G>
+void msl_impl<T, C, G>::deallocate(offset_type offset)
+{
+    const level_type level = node(offset)->m_level;
+    write_node(offset)->m_prev = header().m_free[level];
+    write_header().m_free[level] = offset;
+}
+
+template <class T, class C, class G>
+typename msl_impl<T, C, G>::offset_type msl_impl<T, C, G>::create_node(level_type level, const_reference value)
+{
+    // the file may grow and move here, the value may be one of its elements
+    const value_type copy(value);
+    const offset_type offset = allocate(level);
+    char* storage = m_file.write(offset, node_type::allocation_size(level));
+    node_type* new_node = ::new (static_cast<void*>(storage)) node_type(copy, level);
+    for (level_type i = 0; i <= level; ++i) {
+        new_node->next(i) = 0;
+    }
+    return offset;
+}
+
+template <class T, class C, class G>
+typename msl_impl<T, C, G>::offset_type msl_impl<T, C, G>::create_sentinel()
+{
+    // the sentinels never hold a value, only their links are used
+    const offset_type offset = allocate(max_levels - 1);
+    char* storage = m_file.write(offset, node_type::allocation_size(max_levels - 1));
+    ::new (static_cast<void*>(storage)) node_type(typename node_type::sentinel_tag(), max_levels - 1);
+    return offset;
+}
+
+template <class T, class C, class G>
+typename msl_impl<T, C, G>::offset_type msl_impl<T, C, G>::lower_bound(const_reference key) const
+{
+    const offset_type tail_offset = tail();
+    const node_type* curr = node(head());
+    for (level_type level = header().m_levels + 1; level > 0; ) {
+        --level;
+        for (offset_type next = curr->next(level); next != tail_offset && m_less(node(next)->m_value, key); next = curr->next(level)) {
+            curr = node(next);
+        }
+    }
+    return curr->next(0);
+}
+
+template <class T, class C, class G>
+typename msl_impl<T, C, G>::offset_type msl_impl<T, C, G>::find(const_reference key) const
+{
+    const offset_type offset = lower_bound(key);
+    if (offset != tail() && !m_less(key, node(offset)->m_value)) {
+        return offset;
+    }
+    return tail();
+}
+
+template <class T, class C, class G>
+typename msl_impl<T, C, G>::offset_type msl_impl<T, C, G>::find_predecessors(const_reference key, path_type& path) const
+{
+    const msl_header& info = header();
+    std::fill(path.m_node + info.m_levels + 1, path.m_node + max_levels, info.m_head);
+    offset_type curr = info.m_head;
+    for (level_type level = info.m_levels + 1; level > 0; ) {
+        --level;
+        for (offset_type next = node(curr)->next(level); next != info.m_tail && m_less(node(next)->m_value, key); next = node(curr)->next(level)) {
+            curr = next;
+        }
+        path.m_node[level] = curr;
+    }
+    return node(curr)->next(0);
+}
+
+template <class T, class C, class G>
+std::pair<typename msl_impl<T, C, G>::offset_type, bool> msl_impl<T, C, G>::insert(const_reference value)
+{
+    path_type path;
+    const offset_type next = find_predecessors(value, path);
+    if (next != tail() && !m_less(value, node(next)->m_value)) {
+        return std::make_pair(next, false);
+    }
+    const level_type level = random_level();
+    // the file may grow and move here, the path holds offsets
+    const offset_type offset = create_node(level, value);
+    node_type* new_node = write_node(offset);
+    for (level_type i = 0; i <= level; ++i) {
+        node_type* pred = write_node(path.m_node[i]);
+        new_node->next(i) = pred->next(i);
+        pred->next(i) = offset;
+    }
+    new_node->m_prev = path.m_node[0];
+    write_node(new_node->next(0))->m_prev = offset;
+    msl_header& info = write_header();
+    info.m_levels = std::max<std::uint64_t>(info.m_levels, level);
+    ++info.m_size;
+    return std::make_pair(offset, true);
+}
+
+template <class T, class C, class G>
+bool msl_impl<T, C, G>::erase(const_reference key)
+{
+    path_type path;
+    const offset_type offset = find_predecessors(key, path);
+    if (offset == tail() || m_less(key, node(offset)->m_value)) {
+        return false;
+    }
+    const node_type* old_node = node(offset);
+    for (level_type i = 0; i <= old_node->m_level; ++i) {
+        write_node(path.m_node[i])->next(i) = old_node->next(i);
+    }
+    write_node(old_node->next(0))->m_prev = old_node->m_prev;
+    deallocate(offset);
+    --write_header().m_size;
+    shrink_levels();
+    return true;
+}
+
+template <class T, class C, class G>
+void msl_impl<T, C, G>::remove_all()
+{
+    msl_header& info = write_header();
+    // the sentinels come first, dropping everything after them frees every node
+    info.m_used = info.m_first;
+    std::fill(info.m_free, info.m_free + max_levels, 0);
+    node_type* head_node = write_node(info.m_head);
+    for (level_type level = 0; level < max_levels; ++level) {
+        head_node->next(level) = info.m_tail;
+    }
+    write_node(info.m_tail)->m_prev = info.m_head;
+    info.m_size = 0;
+    info.m_levels = 0;
+}
+
+} // namespace internal
+
+} // namespace skip_list
@@ -0,0 +1,241 @@
+#pragma once
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+template <class T, class C, class G, bool B>
+psl_impl<T, C, G, B>::psl_impl(psl_impl&& other) noexcept
+    : m_arena(std::move(other.m_arena))
+    , m_used(other.m_used)
+    , m_size(other.m_size)
+    , m_levels(other.m_levels)
+    , m_less(std::move(other.m_less))
+    , m_level_generator(std::move(other.m_level_generator))
+{
+    std::copy(other.m_free, other.m_free + max_levels, m_free);
+    // no arena is an empty list, as for a new one
+    other.m_arena.clear();
+    other.m_used = 0;
+    other.m_size = 0;
+    other.m_levels = 0;
+    std::fill(other.m_free, other.m_free + max_levels, 0);
+}
+
+template <class T, class C, class G, bool B>
+psl_impl<T, C, G, B>& psl_impl<T, C, G, B>::operator=(psl_impl&& other) noexcept
+{
+    psl_impl taken(std::move(other));
+    swap(taken);
+    return *this;
+}
+
+template <class T, class C, class G, bool B>
+void psl_impl<T, C, G, B>::swap(psl_impl& other) noexcept
+{
+    using std::swap;
+    swap(m_arena, other.m_arena);
+    swap(m_used, other.m_used);
+    swap(m_size, other.m_size);
+    swap(m_levels, other.m_levels);
+    std::swap_ranges(m_free, m_free + max_levels, other.m_free);
+    swap(m_less, other.m_less);
+    swap(m_level_generator, other.m_level_generator);
+}
+
+template <class T, class C, class G, bool B>
+void psl_impl<T, C, G, B>::reserve(size_type count)
+{
+    // half the nodes have level 0, a quarter level 1...: two links on average
+    const size_type units = std::max(m_used, sentinel_units) + count * node_type::unit_count(1);
+    if (units > max_units) {
+        throw std::length_error("packed_skip_list: more nodes than 32-bit indices can address");
+    }
+    if (units > m_arena.size()) {
+        m_arena.resize(units);
+    }
+}
+
+template <class T, class C, class G, bool B>
+void psl_impl<T, C, G, B>::init()
+{
+    assert(m_arena.empty() || m_used == 0);
+    m_arena.resize(std::max(m_arena.size(), 2 * sentinel_units));
+    m_used = sentinel_units;
+    // the sentinels never hold a value, only their links are used
+    const auto top = static_cast<std::uint8_t>(max_levels - 1);
+    node_type* head = ::new (static_cast<void*>(&m_arena[head_index])) node_type(psl_sentinel_tag(), top);
+    node_type* tail = ::new (static_cast<void*>(&m_arena[tail_index])) node_type(psl_sentinel_tag(), top);
+    for (level_type level = 0; level < max_levels; ++level) {
+        head->next(level) = tail_index;
+        tail->next(level) = tail_index;
+    }
+    if constexpr (B) {
+        tail->m_prev = head_index;
+    }
+}
+
+template <class T, class C, class G, bool B>
+typename psl_impl<T, C, G, B>::index_type psl_impl<T, C, G, B>::allocate(level_type level)
+{
+    index_type& free = m_free[level];
+    if (free != 0) {
+        const index_type index = free;
+        free = node(index)->next(0);
+        return index;
+    }
+    const size_type units = node_type::unit_count(level);
+    if (m_used + units > max_units) {
+        throw std::length_error("packed_skip_list: more nodes than 32-bit indices can address");
+    }
+    if (m_used + units > m_arena.size()) {
+        m_arena.resize(std::min(std::max(m_arena.size() * 2, m_used + units), max_units));
+    }
+    const index_type index = static_cast<index_type>(m_used);
+    m_used += units;
+    return index;
+}
+
+template <class T, class C, class G, bool B>
+void psl_impl<T, C, G, B>::deallocate(index_type index)
+{
+    index_type& free = m_free[node(index)->m_level];
+    node(index)->next(0) = free;
+    free = index;
+}
+
+template <class T, class C, class G, bool B>
+typename psl_impl<T, C, G, B>::index_type psl_impl<T, C, G, B>::back() const
+{
+    if (m_arena.empty()) {
+        return head_index;
+    }
+    if constexpr (B) {
+        return node(tail_index)->m_prev;
+    } else {
+        // no back links, the last node of every level leads to it in O(log n)
+        index_type curr = head_index;
+        for (level_type level = m_levels + 1; level > 0; ) {
+            --level;
+            for (index_type next = node(curr)->next(level); next != tail_index; next = node(curr)->next(level)) {
+                curr = next;
+            }
+        }
+        return curr;
+    }
+}
+
+template <class T, class C, class G, bool B>
+typename psl_impl<T, C, G, B>::index_type psl_impl<T, C, G, B>::lower_bound(const_reference key) const
+{
+    if (m_arena.empty()) {
+        return tail_index;
+    }
+    const node_type* curr = node(head_index);
+    for (level_type level = m_levels + 1; level > 0; ) {
+        --level;
+        for (index_type next = curr->next(level); next != tail_index && m_less(node(next)->m_value, key); next = curr->next(level)) {
+            curr = node(next);
+        }
+    }
+    return curr->next(0);
+}
+
+template <class T, class C, class G, bool B>
+typename psl_impl<T, C, G, B>::index_type psl_impl<T, C, G, B>::find(const_reference key) const
+{
+    const index_type index = lower_bound(key);
+    if (index != tail_index && !m_less(key, node(index)->m_value)) {
+        return index;
+    }
+    return tail_index;
+}
+
+template <class T, class C, class G, bool B>
+typename psl_impl<T, C, G, B>::index_type psl_impl<T, C, G, B>::find_predecessors(const_reference key, path_type& path) const
+{
+    std::fill(path.m_node + m_levels + 1, path.m_node + max_levels, head_index);
+    index_type curr = head_index;
+    for (level_type level = m_levels + 1; level > 0; ) {
+        --level;
+        for (index_type next = node(curr)->next(level); next != tail_index && m_less(node(next)->m_value, key); next = node(curr)->next(level)) {
+            curr = next;
+        }
+        path.m_node[level] = curr;
+    }
+    return node(curr)->next(0);
+}
+
+template <class T, class C, class G, bool B>
+std::pair<typename psl_impl<T, C, G, B>::index_type, bool> psl_impl<T, C, G, B>::insert(const_reference value)
+{
+    if (m_arena.empty()) {
+        init();
+    }
+    path_type path;
+    const index_type next = find_predecessors(value, path);
+    if (next != tail_index && !m_less(value, node(next)->m_value)) {
+        return std::make_pair(next, false);
+    }
+    // the arena may grow and move here, the value may be one of its elements
+    const value_type copy(value);
+    const level_type level = random_level();
+    const index_type index = allocate(level);
+    node_type* new_node = ::new (static_cast<void*>(&m_arena[index])) node_type(copy, static_cast<std::uint8_t>(level));
+    for (level_type i = 0; i <= level; ++i) {
+        node_type* pred = node(path.m_node[i]);
+        new_node->next(i) = pred->next(i);
+        pred->next(i) = index;
+    }
+    if constexpr (B) {
+        new_node->m_prev = path.m_node[0];
+        node(new_node->next(0))->m_prev = index;
+    }
+    m_levels = std::max(m_levels, level);
+    ++m_size;
+    return std::make_pair(index, true);
+}
+
+template <class T, class C, class G, bool B>
+bool psl_impl<T, C, G, B>::erase(const_reference key)
+{
+    if (m_arena.empty()) {
+        return false;
+    }
+    path_type path;
+    const index_type index = find_predecessors(key, path);
+    if (index == tail_index || m_less(key, node(index)->m_value)) {
+        return false;
+    }
+    const node_type* old_node = node(index);
+    for (level_type i = 0; i <= old_node->m_level; ++i) {
+        node(path.m_node[i])->next(i) = old_node->next(i);
+    }
+    if constexpr (B) {
+        node(old_node->next(0))->m_prev = old_node->m_prev;
+    }
+    deallocate(index);
+    --m_size;
+    shrink_levels();
+    return true;
+}
+
+template <class T, class C, class G, bool B>
+void psl_impl<T, C, G, B>::remove_all()
+{
+    if (m_arena.empty()) {
+        return;
+    }
+    // the sentinels come first, dropping everything after them frees every node, the arena stays
+    m_used = 0;
+    init();
+    m_size = 0;
+    m_levels = 0;
+    std::fill(m_free, m_free + max_levels, 0);
+}
+
+} // namespace internal
+
+} // namespace skip_list
@@ -0,0 +1,160 @@
+#pragma once
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+inline sl_epoch::guard::guard(sl_epoch& domain)
+    : m_domain(&domain)
+    , m_record(domain.local_record())
+{
+    m_domain->enter(m_record);
+}
+
+inline sl_epoch::guard::guard(const guard& other)
+    : m_domain(other.m_domain)
+    , m_record(other.m_record)
+{
+    if (m_record != nullptr) {
+        m_domain->enter(m_record);
+    }
+}
+
+inline sl_epoch::guard::guard(guard&& other) noexcept
+    : m_domain(other.m_domain)
+    , m_record(other.m_record)
+{
+    other.m_domain = nullptr;
+    other.m_record = nullptr;
+}
+
+inline sl_epoch::guard& sl_epoch::guard::operator=(guard other) noexcept
+{
+    swap(other);
+    return *this;
+}
+
+inline sl_epoch::guard::~guard()
+{
+    if (m_record != nullptr) {
+        m_domain->leave(m_record);
+    }
+}
+
+inline sl_epoch::sl_epoch(dispose_function dispose, void* context)
+    : m_global(1)
+    , m_records(nullptr)
+    , m_id(next_id())
+    , m_dispose(dispose)
+    , m_context(context)
+{ }
+
+inline sl_epoch::~sl_epoch()
+{
+    reclaim_all();
+    record* rec = m_records.load();
+    while (rec != nullptr) {
+        record* next = rec->m_next;
+        delete rec;
+        rec = next;
+    }
+}
+
+inline void sl_epoch::retire(void* object)
+{
+    record* rec = local_record();
+    assert(rec->m_nesting > 0);
+    rec->m_limbo.emplace_back(m_global.load(), object);
+    if (++rec->m_retired % collect_period == 0) {
+        try_advance();
+        collect(rec, m_global.load());
+    }
+}
+
+inline void sl_epoch::reclaim_all()
+{
+    for (record* rec = m_records.load(); rec != nullptr; rec = rec->m_next) {
+        assert(rec->m_nesting == 0);
+        for (auto& entry : rec->m_limbo) {
+            m_dispose(m_context, entry.second);
+        }
+        rec->m_limbo.clear();
+    }
+}
+
+inline sl_epoch::record* sl_epoch::local_record()
+{
+    thread_local std::vector<std::pair<std::uint64_t, record*>> cache;
+    for (auto& entry : cache) {
+        if (entry.first == m_id) {
+            return entry.second;
+        }
+    }
+    // not cached, the thread may still own a record evicted from its cache
+    const std::thread::id self = std::this_thread::get_id();
+    record* rec = m_records.load();
+    while (rec != nullptr && rec->m_owner != self) {
+        rec = rec->m_next;
+    }
+    if (rec == nullptr) {
+        rec = new record(self);
+        record* head = m_records.load();
+        do {
+            rec->m_next = head;
+        } while (!m_records.compare_exchange_weak(head, rec));
+    }
+    if (cache.size() == cache_size) {
+        cache.erase(cache.begin());
+    }
+    cache.emplace_back(m_id, rec);
+    return rec;
+}
+
+inline void sl_epoch::enter(record* rec)
+{
+    if (rec->m_nesting++ == 0) {
+        rec->m_epoch.store((m_global.load() << 1) | 1);
+        // the pinned epoch must be visible before any shared pointer is read
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+inline void sl_epoch::leave(record* rec)
+{
+    assert(rec->m_nesting > 0);
+    if (--rec->m_nesting == 0) {
+        rec->m_epoch.store(0, std::memory_order_release);
+    }
+}
+
+inline void sl_epoch::try_advance()
+{
+    std::uint64_t global = m_global.load();
+    for (record* rec = m_records.load(); rec != nullptr; rec = rec->m_next) {
+        const std::uint64_t local = rec->m_epoch.load();
+        if ((local & 1) != 0 && (local >> 1) != global) {
+            return; // someone is still in an older epoch
+        }
+    }
+    m_global.compare_exchange_strong(global, global + 1);
+}
+
+inline void sl_epoch::collect(record* rec, std::uint64_t safe_epoch)
+{
+    auto& limbo = rec->m_limbo;
+    size_type kept = 0;
+    for (size_type i = 0; i < limbo.size(); ++i) {
+        if (limbo[i].first + 2 <= safe_epoch) {
+            m_dispose(m_context, limbo[i].second);
+        } else {
+            limbo[kept++] = limbo[i];
+        }
+    }
+    limbo.resize(kept);
+}
+
+} // namespace internal
+
+} // namespace skip_list
@@ -6,189 +6,1567 @@ namespace skip_list
 namespace internal
 {
 
-template <class T>
-sl_node<T>::sl_node(value_type value, size_type level)
-    : m_value(value)
-    , m_level(level)
+template <class T, bool K>
+sl_node<T, K>::sl_node(sentinel_tag, size_type level)
+    : m_level(static_cast<std::uint32_t>(level))
+    , m_slab(0)
     , m_prev(nullptr)
-    , m_next(new self_type*[level + 1])
 {
+    if constexpr (K) {
+        // the links to a sentinel copy its value bytes into the tower, they are never compared
+        std::memset(static_cast<void*>(&m_value), 0, sizeof(value_type));
+    }
     for (size_type i = 0; i <= level; ++i) {
-        m_next[i] = nullptr;
+        set_next(i, nullptr);
+        span(i) = 0;
     }
 }
 
-template <class T>
-sl_node<T>::~sl_node()
+template <class T, bool K>
+template <typename... Args>
+sl_node<T, K>::sl_node(size_type level, Args&&... args)
+    : m_value(std::forward<Args>(args)...)
+    , m_level(static_cast<std::uint32_t>(level))
+    , m_slab(0)
+    , m_prev(nullptr)
 {
-    delete [] m_next;
-    m_prev = nullptr; // don't need this
-    m_next = nullptr; // don't need this
+    for (size_type i = 0; i <= level; ++i) {
+        set_next(i, nullptr);
+        span(i) = 0;
+    }
 }
 
+template <class T, class C, class A, class G, class S>
+sl_impl<T, C, A, G, S>::sl_impl(const allocator_type& alloc)
+    : sl_impl(compare(), alloc)
+{ }
 
-
-template <class T, class C, class A>
-sl_impl<T, C, A>::sl_impl(const allocator_type& alloc)
+template <class T, class C, class A, class G, class S>
+sl_impl<T, C, A, G, S>::sl_impl(const compare& comp, const allocator_type& alloc)
     : m_alloc(alloc)
-    , m_levels(max_levels)
+    , m_levels(0)
+    , m_size(0)
+    , m_capacity(0)
+    , m_compact_rank(0)
+    , m_head(nullptr)
+    , m_tail(nullptr)
+    , m_less(comp)
+    , m_finger()
+    , m_finger_valid(false)
+    , m_finger_enabled(false)
+{
+    create_sentinels();
+}
+
+template <class T, class C, class A, class G, class S>
+sl_impl<T, C, A, G, S>::sl_impl(const sl_impl& other)
+    : sl_impl(other, std::allocator_traits<allocator_type>::select_on_container_copy_construction(other.get_allocator()))
+{ }
+
+template <class T, class C, class A, class G, class S>
+sl_impl<T, C, A, G, S>::sl_impl(const sl_impl& other, const allocator_type& alloc)
+    : sl_impl(other.key_comp(), alloc)
+{
+    clone(other);
+}
+
+template <class T, class C, class A, class G, class S>
+sl_impl<T, C, A, G, S>::sl_impl(sl_impl&& other) noexcept(nothrow_move)
+    : m_alloc(other.m_alloc)
+    , m_levels(0)
     , m_size(0)
-    , m_head(new node_type(std::numeric_limits<typename node_type::value_type>::min(), max_levels))
-    , m_tail(new node_type(std::numeric_limits<typename node_type::value_type>::max(), max_levels))
+    , m_capacity(0)
+    , m_compact_rank(0)
+    , m_head(nullptr)
+    , m_tail(nullptr)
+    , m_less(std::move(other.m_less))
+    , m_level_generator(std::move(other.m_level_generator))
+    , m_finger()
+    , m_finger_valid(false)
+    , m_finger_enabled(other.m_finger_enabled)
 {
-    for (size_type i = 0; i <= max_levels; ++i) {
-        m_head->m_next[i] = m_tail;
-        m_tail->m_next[i] = nullptr;
+    create_sentinels();
+    swap_nodes(other);
+}
+
+template <class T, class C, class A, class G, class S>
+sl_impl<T, C, A, G, S>::~sl_impl()
+{
+    if (releases_arena()) {
+        return; // the arena goes away with the allocator
     }
-    m_head->m_prev = nullptr;
-    m_tail->m_prev = m_head;
+    remove_all();
 }
 
-template <class T, class C, class A>
-sl_impl<T, C, A>::~sl_impl()
+template <class T, class C, class A, class G, class S>
+sl_impl<T, C, A, G, S>& sl_impl<T, C, A, G, S>::operator=(const sl_impl& other)
 {
+    if (this == &other) {
+        return *this;
+    }
+    if constexpr (node_alloc_traits::propagate_on_container_copy_assignment::value) {
+        if (!(m_alloc == other.m_alloc)) {
+            // the nodes go back to the allocator they came from
+            remove_all();
+        }
+        m_alloc = other.m_alloc;
+    }
+    assign_copy(other);
+    return *this;
+}
+
+template <class T, class C, class A, class G, class S>
+sl_impl<T, C, A, G, S>& sl_impl<T, C, A, G, S>::operator=(sl_impl&& other) noexcept(nothrow_move && move_assign_steals)
+{
+    if (this == &other) {
+        return *this;
+    }
+    if constexpr (!move_assign_steals) {
+        if (!(m_alloc == other.m_alloc)) {
+            assign_move(other);
+            return *this;
+        }
+    }
     remove_all();
-    delete m_head;
-    delete m_tail;
+    if constexpr (node_alloc_traits::propagate_on_container_move_assignment::value) {
+        m_alloc = other.m_alloc;
+    }
+    m_less = std::move(other.m_less);
+    m_level_generator = std::move(other.m_level_generator);
+    swap_nodes(other);
+    return *this;
 }
 
-template <class T, class C, class A>
-typename sl_impl<T, C, A>::node_type* sl_impl<T, C, A>::find(const_reference value)
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::swap(sl_impl& other) noexcept
 {
-    node_type* curr = m_head;
-    for (level_type level = m_levels + 1; level > 0; ) {
+    using std::swap;
+    if constexpr (node_alloc_traits::propagate_on_container_swap::value) {
+        swap(m_alloc, other.m_alloc);
+    } else {
+        assert(m_alloc == other.m_alloc);
+    }
+    swap_nodes(other);
+    swap(m_less, other.m_less);
+    swap(m_level_generator, other.m_level_generator);
+    swap(m_finger_enabled, other.m_finger_enabled);
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::assign_copy(const sl_impl& other)
+{
+    if (this != &other) {
+        remove_all();
+        copy_compare(other);
+        clone(other);
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Args>
+void sl_impl<T, C, A, G, S>::assign_copy(const sl_impl& other, Args&& args)
+{
+    if (this != &other) {
+        remove_all();
+        copy_compare(other);
+        clone(other, std::forward<Args>(args));
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::compare sl_impl<T, C, A, G, S>::key_comp() const
+{
+    if constexpr (S::enabled) {
+        return m_less.comp();
+    } else {
+        return m_less;
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::copy_compare(const sl_impl& other)
+{
+    // the comparison count stays the one of this list
+    if constexpr (S::enabled) {
+        m_less.comp() = other.m_less.comp();
+    } else {
+        m_less = other.m_less;
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::assign_move(sl_impl& other)
+{
+    if (this != &other) {
+        remove_all();
+        clone(other);
+        other.remove_all();
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Other>
+void sl_impl<T, C, A, G, S>::clone(Other& other)
+{
+    clone(other, [](auto& value) {
+        if constexpr (std::is_const_v<Other>) {
+            return std::forward_as_tuple(value);
+        } else {
+            return std::forward_as_tuple(std::move(value));
+        }
+    });
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Other, typename Args>
+void sl_impl<T, C, A, G, S>::clone(Other& other, Args&& args)
+{
+    assert(m_size == 0);
+    m_capacity = std::max(m_capacity, other.m_capacity);
+    if (other.m_size == 0) {
+        return;
+    }
+    path_type last;
+    collect_last(last);
+    // the towers keep their heights, no level is drawn and no value compared
+    for (auto* node = other.front(); node != other.m_tail; node = node->next(0)) {
+        const level_type level = node->m_level;
+        link_back(std::apply([this, level](auto&&... values) {
+            return create_node(level, std::forward<decltype(values)>(values)...);
+        }, args(node->m_value)), last);
+    }
+    close_back(last);
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::swap_nodes(sl_impl& other) noexcept
+{
+    // the last node of every level is found from the one of the level above, as for a key past the end
+    node_type* last = m_head;
+    node_type* other_last = other.m_head;
+    for (level_type level = std::max(m_levels, other.m_levels) + 1; level > 0; ) {
         --level;
-        while ((curr->m_next[level] != m_tail) &&
-                !is_equal(curr->m_value, value) &&
-                is_less_or_equal(curr->m_next[level]->m_value, value)) {
-            curr = curr->m_next[level];
+        while (last->next(level) != m_tail) {
+            last = last->next(level);
+        }
+        while (other_last->next(level) != other.m_tail) {
+            other_last = other_last->next(level);
+        }
+        node_type* first = m_head->next(level);
+        node_type* other_first = other.m_head->next(level);
+        m_head->set_next(level, (other_first == other.m_tail) ? m_tail : other_first);
+        other.m_head->set_next(level, (first == m_tail) ? other.m_tail : first);
+        // the spans count steps, they do not depend on the sentinels
+        std::swap(m_head->span(level), other.m_head->span(level));
+        if (last != m_head) {
+            last->set_next(level, other.m_tail);
+        }
+        if (other_last != other.m_head) {
+            other_last->set_next(level, m_tail);
         }
     }
-    return curr;
+    node_type* back = m_tail->m_prev;
+    node_type* other_back = other.m_tail->m_prev;
+    m_tail->m_prev = (other_back == other.m_head) ? m_head : other_back;
+    other.m_tail->m_prev = (back == m_head) ? other.m_head : back;
+    m_head->next(0)->m_prev = m_head;
+    other.m_head->next(0)->m_prev = other.m_head;
+
+    using std::swap;
+    swap(m_levels, other.m_levels);
+    swap(m_size, other.m_size);
+    swap(m_capacity, other.m_capacity);
+    swap(m_compact_rank, other.m_compact_rank);
+    swap(m_stats, other.m_stats);
+    // the fingers hold nodes of the lists, which change hands
+    m_finger_valid = false;
+    other.m_finger_valid = false;
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::create_sentinels() noexcept
+{
+    using tag = typename node_type::sentinel_tag;
+    m_head = ::new (static_cast<void*>(m_head_storage)) node_type(tag(), max_levels - 1);
+    m_tail = ::new (static_cast<void*>(m_tail_storage)) node_type(tag(), 0);
+    for (size_type i = 0; i < max_levels; ++i) {
+        m_head->set_next(i, m_tail);
+        m_head->span(i) = 1;
+    }
+    m_tail->m_prev = m_head;
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename... Args>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::create_node(level_type level, Args&&... args)
+{
+    const size_type count = storage_count(level);
+    node_storage* storage = node_alloc_traits::allocate(m_alloc, count);
+    m_stats.on_allocate(count * sizeof(node_storage));
+    try {
+        return ::new (static_cast<void*>(storage)) node_type(level, std::forward<Args>(args)...);
+    } catch (...) {
+        node_alloc_traits::deallocate(m_alloc, storage, count);
+        throw;
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::destroy_node(node_type* node)
+{
+    std::destroy_at(&node->m_value);
+    deallocate_node(node);
 }
 
-template <class T, class C, class A>
-const typename sl_impl<T, C, A>::node_type* sl_impl<T, C, A>::find(const_reference value) const
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::deallocate_node(node_type* node)
+{
+    const size_type count = storage_count(node->m_level);
+    const size_type offset = node->m_slab;
+    node->~node_type();
+    if (offset == 0) {
+        node_alloc_traits::deallocate(m_alloc, reinterpret_cast<node_storage*>(node), count);
+        m_stats.on_deallocate(count * sizeof(node_storage));
+        return;
+    }
+    node_storage* slab = reinterpret_cast<node_storage*>(node) - offset;
+    slab_header* header = std::launder(reinterpret_cast<slab_header*>(slab));
+    if (header->m_live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        const size_type units = header->m_units;
+        header->~slab_header();
+        node_alloc_traits::deallocate(m_alloc, slab, units);
+        m_stats.on_deallocate(units * sizeof(node_storage));
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::find(const Key& value)
+{
+    node_type* node = find_first(value);
+    // the only equality check, at the bottom
+    return (node != m_tail && !m_less(value, node->m_value)) ? node : m_tail;
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+const typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::find(const Key& value) const
 {
     return const_cast<sl_impl*>(this)->find(value);
 }
 
-template <class T, class C, class A>
-typename sl_impl<T, C, A>::node_type* sl_impl<T, C, A>::find_first(const value_type& value)
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::find_first(const Key& value)
 {
-    node_type* node = find(value);
-    if (!is_equal(node->m_value, value)) {
-        node = node->m_next[0];
+    m_stats.on_descent(descent::find);
+    if (m_finger_enabled) {
+        return find_near(value);
     }
-    return node;
+    // One comparison per hop. The node which stopped a level is not less
+    // than the value, the levels below stop there without comparing it again.
+    node_type* curr = m_head;
+    const node_type* bound = m_tail;
+    for (level_type level = m_levels + 1; level > 0; ) {
+        --level;
+        node_type* next = curr->next(level);
+        while (next != bound && m_less(curr->next_value(level), value)) {
+            m_stats.on_hop(level);
+            curr = next;
+            next = curr->next(level);
+        }
+        bound = next;
+    }
+    return curr->next(0);
 }
 
-template <class T, class C, class A>
-const typename sl_impl<T, C, A>::node_type* sl_impl<T, C, A>::find_first(const_reference value) const
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+const typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::find_first(const Key& value) const
 {
     return const_cast<sl_impl*>(this)->find_first(value);
 }
 
-template <class T, class C, class A>
-typename sl_impl<T, C, A>::node_type* sl_impl<T, C, A>::insert(const value_type& value, node_type* hint)
+template <class T, class C, class A, class G, class S>
+template <typename ForwardIterator, typename Visit>
+void sl_impl<T, C, A, G, S>::find_first_batch(ForwardIterator first, ForwardIterator last, Visit&& visit) const
+{
+    using key_type = std::remove_reference_t<decltype(*first)>;
+    struct search
+    {
+        key_type* m_key;
+        const node_type* m_node;
+        level_type m_level;
+        bool m_done;
+    };
+
+    search group[batch_width];
+    while (first != last) {
+        size_type count = 0;
+        for (; count < batch_width && first != last; ++count, ++first) {
+            group[count] = search{&*first, m_head, m_levels, false};
+            m_stats.on_descent(descent::find);
+        }
+        SKIP_LIST_PREFETCH(m_head->next(m_levels));
+        size_type active = count;
+        while (active != 0) {
+            for (size_type i = 0; i < count; ++i) {
+                search& s = group[i];
+                if (s.m_done) {
+                    continue;
+                }
+                const node_type* next = s.m_node->next(s.m_level);
+                if (next != m_tail && m_less(s.m_node->next_value(s.m_level), *s.m_key)) {
+                    m_stats.on_hop(s.m_level);
+                    s.m_node = next;
+                    SKIP_LIST_PREFETCH(next->next(s.m_level));
+                } else if (s.m_level == 0) {
+                    s.m_node = next;
+                    s.m_done = true;
+                    --active;
+                } else {
+                    --s.m_level;
+                    SKIP_LIST_PREFETCH(s.m_node->next(s.m_level));
+                }
+            }
+        }
+        for (size_type i = 0; i < count; ++i) {
+            visit(*group[i].m_key, const_cast<node_type*>(group[i].m_node));
+        }
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::find_from(node_type* start, const Key& key)
 {
-    if (is_equal(find(value)->m_value, value)) {
-        return nullptr;
+    if (start != m_head && (start == m_tail || !m_less(start->m_value, key))) {
+        // the upper levels have no back links, only the position right before the start is cheap
+        if (start->m_prev == m_head || m_less(start->m_prev->m_value, key)) {
+            return start;
+        }
+        return find_first(key);
     }
-    const level_type node_level = random_level();
+    m_stats.on_descent(descent::find);
+    node_type* curr = start;
+    level_type level = 0;
+    for (;;) {
+        // go up as long as the taller links still land before the key
+        while (level < curr->m_level && curr->next(level + 1) != m_tail &&
+                m_less(curr->next_value(level + 1), key)) {
+            ++level;
+        }
+        node_type* next = curr->next(level);
+        if (next == m_tail || !m_less(curr->next_value(level), key)) {
+            break;
+        }
+        m_stats.on_hop(level);
+        curr = next;
+    }
+    while (level > 0) {
+        --level;
+        while ((curr->next(level) != m_tail) && m_less(curr->next_value(level), key)) {
+            m_stats.on_hop(level);
+            curr = curr->next(level);
+        }
+    }
+    return curr->next(0);
+}
 
-    node_type* new_node = new node_type(value, node_level);
-    const bool is_valid_hint = (hint != nullptr);
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::find_near(const Key& key)
+{
+    if (!m_finger_valid) {
+        m_finger_valid = true;
+        return find_predecessors(key, m_finger);
+    }
+    move_finger(key, 0);
+    return m_finger.m_node[0]->next(0);
+}
 
-    node_type* curr = (is_valid_hint) ? hint : m_head; // for now start from head
-    level_type level = curr->m_level + 1;
-    do {
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+void sl_impl<T, C, A, G, S>::move_finger(const Key& key, level_type bottom)
+{
+    // Climb to the first level whose predecessor is still before the key and
+    // whose successor is not, every level above it is then already right.
+    level_type level = bottom;
+    if (!m_finger_valid) {
+        m_finger_valid = true;
+        level = m_levels;
+        m_finger.m_node[level] = m_head;
+        m_finger.m_rank[level] = 0;
+    }
+    // The predecessors of the levels above are not after the ones below, once
+    // one is before the key so are the others. The successor which stopped
+    // the climb is not less than the key, the descent stops there unasked.
+    bool before = false;
+    const node_type* bound = m_tail;
+    for (; level < m_levels; ++level) {
+        const node_type* pred = m_finger.m_node[level];
+        before = before || pred == m_head || m_less(pred->m_value, key);
+        if (before && (pred->next(level) == m_tail || !m_less(pred->next_value(level), key))) {
+            bound = pred->next(level);
+            break;
+        }
+    }
+    if (!before && m_finger.m_node[level] != m_head && !m_less(m_finger.m_node[level]->m_value, key)) {
+        // the key is before the whole path
+        level = m_levels;
+        m_finger.m_node[level] = m_head;
+        m_finger.m_rank[level] = 0;
+    }
+    node_type* curr = m_finger.m_node[level];
+    size_type rank = m_finger.m_rank[level];
+    for (++level; level > bottom; ) {
         --level;
-        while ((curr->m_next[level] != m_tail) && m_less(curr->m_next[level]->m_value, value)) {
-            curr = curr->m_next[level];
-            assert(level <= curr->m_level);
-        }
-        if (level <= node_level) {
-            assert(curr->m_next[level] != nullptr);
-            new_node->m_next[level] = curr->m_next[level];
-            curr->m_next[level] = new_node;
-        }
-    } while (level != 0);
-    // level is 0
-    assert(level == 0);
-    assert(curr->m_next[0] != nullptr);
-    new_node->m_prev = curr;
-    new_node->m_next[0]->m_prev = new_node;
+        node_type* next = curr->next(level);
+        while (next != bound && m_less(curr->next_value(level), key)) {
+            rank += curr->span(level);
+            m_stats.on_hop(level);
+            curr = next;
+            next = curr->next(level);
+        }
+        bound = next;
+        m_finger.m_node[level] = curr;
+        m_finger.m_rank[level] = rank;
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::find_hinted(node_type* hint, const Key& key)
+{
+    node_type* curr = hint->m_prev;
+    if (m_finger_valid) {
+        const node_type* pred = m_finger.m_node[0];
+        if ((pred == m_head || m_less(pred->m_value, key)) &&
+                (pred->next(0) == m_tail || !m_less(pred->next_value(0), key))) {
+            return pred->next(0);
+        }
+    }
+    if (curr != m_head && !m_less(curr->m_value, key)) {
+        // a hint before the key is no help, the search only climbs forward
+        return find_near(key);
+    }
+    // go up and forward from the hint as find_from() does, as long as the links land before the key
+    level_type level = 0;
+    for (;;) {
+        while (level < curr->m_level && curr->next(level + 1) != m_tail &&
+                m_less(curr->next_value(level + 1), key)) {
+            ++level;
+        }
+        node_type* next = curr->next(level);
+        if (next == m_tail || !m_less(curr->next_value(level), key)) {
+            break;
+        }
+        m_stats.on_hop(level);
+        curr = next;
+    }
+    // curr is the predecessor up to its own top, the levels above come from the finger
+    const level_type top = std::min<level_type>(curr->m_level, m_levels);
+    node_type* pred = m_head;
+    size_type rank = 0;
+    if (top < m_levels) {
+        move_finger(key, top + 1);
+        pred = m_finger.m_node[top + 1];
+        rank = m_finger.m_rank[top + 1];
+    }
+    m_finger_valid = true;
+    // the predecessor of the level above is a node of this level before curr, its rank gives curr's
+    for (; pred != curr; pred = pred->next(top)) {
+        rank += pred->span(top);
+    }
+    for (level = top + 1; level > 0; ) {
+        --level;
+        while ((curr->next(level) != m_tail) && m_less(curr->next_value(level), key)) {
+            rank += curr->span(level);
+            m_stats.on_hop(level);
+            curr = curr->next(level);
+        }
+        m_finger.m_node[level] = curr;
+        m_finger.m_rank[level] = rank;
+    }
+    return curr->next(0);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::locate(const Key& key, path_type*& path, path_type& local, bool near, node_type* hint)
+{
+    if (hint != nullptr) {
+        path = &m_finger;
+        return find_hinted(hint, key);
+    }
+    if (near || m_finger_enabled) {
+        path = &m_finger;
+        return find_near(key);
+    }
+    path = &local;
+    return find_predecessors(key, local);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::find_predecessors(const Key& value, path_type& path)
+{
+    node_type* curr = m_head;
+    const node_type* bound = m_tail;
+    size_type rank = 0;
+    for (level_type level = m_levels + 1; level > 0; ) {
+        --level;
+        node_type* next = curr->next(level);
+        while (next != bound && m_less(curr->next_value(level), value)) {
+            rank += curr->span(level);
+            m_stats.on_hop(level);
+            curr = next;
+            next = curr->next(level);
+        }
+        bound = next;
+        path.m_node[level] = curr;
+        path.m_rank[level] = rank;
+    }
+    return curr->next(0);
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::collect_predecessors(const node_type* node, path_type& path)
+{
+    // the links above the node need their spans updated as well, so descend from the top
+    node_type* curr = m_head;
+    for (level_type level = m_levels + 1; level > 0; ) {
+        --level;
+        while ((curr->next(level) != m_tail) && (curr->next(level) != node) &&
+                m_less(curr->next_value(level), node->m_value)) {
+            m_stats.on_hop(level);
+            curr = curr->next(level);
+        }
+        path.m_node[level] = curr;
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Value>
+std::pair<typename sl_impl<T, C, A, G, S>::node_type*, bool> sl_impl<T, C, A, G, S>::insert(Value&& value, bool near, node_type* hint)
+{
+    path_type local;
+    path_type* path = nullptr;
+    m_stats.on_descent(descent::insert);
+    node_type* next = locate(value, path, local, near, hint);
+    if (next != m_tail && !m_less(value, next->m_value)) {
+        return std::make_pair(next, false);
+    }
+    return std::make_pair(link_new(create_node(random_level(), std::forward<Value>(value)), *path), true);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename... Args>
+std::pair<typename sl_impl<T, C, A, G, S>::node_type*, bool> sl_impl<T, C, A, G, S>::emplace_impl(node_type* hint, Args&&... args)
+{
+    node_type* new_node = create_node(random_level(), std::forward<Args>(args)...);
+    path_type local;
+    path_type* path = nullptr;
+    m_stats.on_descent(descent::insert);
+    try {
+        node_type* next = locate(new_node->m_value, path, local, false, hint);
+        if (next != m_tail && !m_less(new_node->m_value, next->m_value)) {
+            destroy_node(new_node);
+            return std::make_pair(next, false);
+        }
+    } catch (...) {
+        destroy_node(new_node);
+        throw;
+    }
+    return std::make_pair(link_new(new_node, *path), true);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename... Args>
+std::pair<typename sl_impl<T, C, A, G, S>::node_type*, bool> sl_impl<T, C, A, G, S>::try_emplace(const Key& key, Args&&... args)
+{
+    path_type local;
+    path_type* path = nullptr;
+    m_stats.on_descent(descent::insert);
+    node_type* next = locate(key, path, local, false);
+    if (next != m_tail && !m_less(key, next->m_value)) {
+        return std::make_pair(next, false);
+    }
+    return std::make_pair(link_new(create_node(random_level(), std::forward<Args>(args)...), *path), true);
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::link_new(node_type* node, path_type& path)
+{
+    // the head links above m_levels point to the tail, so raising is enough
+    for (level_type level = m_levels + 1; level <= node->m_level; ++level) {
+        path.m_node[level] = m_head;
+        path.m_rank[level] = 0;
+        m_head->span(level) = m_size + 1;
+    }
+    m_levels = std::max<level_type>(m_levels, node->m_level);
+    link(node, path);
+    return node;
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::link(node_type* node, path_type& path)
+{
+    // the path stays valid for the key of the node, any other path leaves the finger behind
+    m_finger_valid = m_finger_valid && (&path == &m_finger);
+    const size_type rank = path.m_rank[0] + 1;
+    for (level_type level = 0; level <= node->m_level; ++level) {
+        node_type* pred = path.m_node[level];
+        assert(pred->next(level) != nullptr);
+        const size_type before = rank - path.m_rank[level];
+        node->set_next(level, pred->next(level));
+        node->span(level) = pred->span(level) + 1 - before;
+        pred->set_next(level, node);
+        pred->span(level) = before;
+    }
+    for (level_type level = node->m_level + 1; level <= m_levels; ++level) {
+        ++path.m_node[level]->span(level);
+    }
+    node->m_prev = path.m_node[0];
+    node->next(0)->m_prev = node;
     ++m_size;
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::collect_last(path_type& last)
+{
+    m_finger_valid = false;
+    node_type* curr = m_head;
+    size_type rank = 0;
+    for (level_type level = max_levels; level > 0; ) {
+        --level;
+        while (curr->next(level) != m_tail) {
+            rank += curr->span(level);
+            curr = curr->next(level);
+        }
+        last.m_node[level] = curr;
+        last.m_rank[level] = rank;
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::link_back(node_type* node, path_type& last)
+{
+    const size_type rank = m_size + 1;
+    for (level_type level = 0; level <= node->m_level; ++level) {
+        node->set_next(level, m_tail);
+        node->span(level) = 1;
+        last.m_node[level]->set_next(level, node);
+        last.m_node[level]->span(level) = rank - last.m_rank[level];
+        last.m_node[level] = node;
+        last.m_rank[level] = rank;
+    }
+    node->m_prev = m_tail->m_prev;
+    m_tail->m_prev = node;
+    m_levels = std::max<level_type>(m_levels, node->m_level);
+    ++m_size;
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::close_back(path_type& last)
+{
+    // link_back() leaves the spans to the tail of the levels above the appended node behind
+    for (level_type level = 0; level <= m_levels; ++level) {
+        last.m_node[level]->span(level) = m_size + 1 - last.m_rank[level];
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename InputIterator>
+void sl_impl<T, C, A, G, S>::insert_range(InputIterator first, InputIterator last)
+{
+    path_type tails;
+    bool tails_valid = false;
+    for (; first != last; ++first) {
+        const node_type* back_node = m_tail->m_prev;
+        if (back_node == m_head || m_less(back_node->m_value, *first)) {
+            if (!tails_valid) {
+                collect_last(tails);
+                tails_valid = true;
+            }
+            link_back(create_node(random_level(), *first), tails);
+        } else if (!m_less(*first, back_node->m_value)) {
+            continue; // equal to the last node, e.g. a run of duplicates in sorted input
+        } else {
+            if (tails_valid) {
+                close_back(tails);
+                tails_valid = false; // an insert in the middle may become the last node of its upper levels
+            }
+            insert(*first);
+        }
+    }
+    if (tails_valid) {
+        close_back(tails);
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename InputIterator>
+void sl_impl<T, C, A, G, S>::append_sorted(InputIterator first, InputIterator last)
+{
+    path_type tails;
+    collect_last(tails);
+    for (; first != last; ++first) {
+        assert(m_tail->m_prev == m_head || m_less(m_tail->m_prev->m_value, *first));
+        link_back(create_node(random_level(), *first), tails);
+    }
+    close_back(tails);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename InputIterator>
+void sl_impl<T, C, A, G, S>::append_unique(InputIterator first, InputIterator last)
+{
+    path_type tails;
+    collect_last(tails);
+    for (; first != last; ++first) {
+        if (m_size == 0 || m_less(m_tail->m_prev->m_value, *first)) {
+            link_back(create_node(random_level(), *first), tails);
+        }
+    }
+    close_back(tails);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename RandomIt>
+void sl_impl<T, C, A, G, S>::assign_sorted_parallel(RandomIt first, RandomIt last, size_type threads)
+{
+    remove_all();
+    const size_type count = static_cast<size_type>(last - first);
+    if (count == 0) {
+        return;
+    }
+    threads = sl_has_release<node_allocator>::value ? 1 : sl_thread_count(threads, count);
+    // a run of equal values stays in one segment, which keeps its first
+    std::vector<size_type> bounds(threads + 1);
+    bounds[threads] = count;
+    for (size_type i = 1; i < threads; ++i) {
+        size_type bound = std::max(bounds[i - 1], count * i / threads);
+        while (bound != 0 && bound < count && !m_less(first[bound - 1], first[bound])) {
+            ++bound;
+        }
+        bounds[i] = bound;
+    }
+    std::vector<sl_impl> parts;
+    parts.reserve(threads);
+    for (size_type i = 0; i < threads; ++i) {
+        parts.emplace_back(get_allocator());
+        parts.back().reserve(count); // the heights of the whole list
+    }
+    sl_run_parallel(threads, [&](size_type i) {
+        parts[i].append_unique(first + static_cast<std::ptrdiff_t>(bounds[i]),
+                               first + static_cast<std::ptrdiff_t>(bounds[i + 1]));
+    });
+    for (sl_impl& part : parts) {
+        join(part);
+    }
+}
 
-    return new_node;
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename Fn>
+void sl_impl<T, C, A, G, S>::for_each_parallel(const Key& lo, const Key& hi, Fn& fn, size_type threads) const
+{
+    const size_type begin = count_less(lo) + 1;
+    const size_type end = count_less(hi) + 1;
+    if (end <= begin) {
+        return;
+    }
+    threads = sl_thread_count(threads, end - begin);
+    std::vector<const node_type*> bounds(threads + 1);
+    for (size_type i = 0; i <= threads; ++i) {
+        bounds[i] = at(begin + (end - begin) * i / threads);
+    }
+    sl_run_parallel(threads, [&](size_type i) {
+        for (const node_type* node = bounds[i]; node != bounds[i + 1]; node = node->next(0)) {
+            fn(std::as_const(node->m_value));
+        }
+    });
 }
 
-template <class T, class C, class A>
-void sl_impl<T, C, A>::remove(node_type* node)
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::remove(const Key& value)
+{
+    return remove(value, [](value_type&) { });
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key, typename Dispose>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::remove(const Key& value, Dispose&& dispose)
+{
+    path_type local;
+    path_type* path = nullptr;
+    m_stats.on_descent(descent::erase);
+    node_type* node = locate(value, path, local, false);
+    if (node == m_tail || m_less(value, node->m_value)) {
+        return m_tail;
+    }
+    dispose(node->m_value);
+    return unlink(node, *path);
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::remove(node_type* node)
 {
     assert(nullptr != node);
-    assert(nullptr != node->m_next[0]);
     assert(m_head != node);
     assert(m_tail != node);
 
-    node->m_next[0]->m_prev = node->m_prev;;
+    m_stats.on_descent(descent::erase);
+    if (m_finger_enabled) {
+        find_near(node->m_value);
+        assert(m_finger.m_node[0]->next(0) == node);
+        return unlink(node, m_finger);
+    }
+    path_type path;
+    collect_predecessors(node, path);
+    return unlink(node, path);
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::remove_front()
+{
+    assert(m_size != 0);
+    path_type path;
+    std::fill(path.m_node, path.m_node + m_levels + 1, m_head);
+    std::fill(path.m_rank, path.m_rank + m_levels + 1, 0);
+    unlink(front(), path);
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::unlink(node_type* node, path_type& path)
+{
+    m_finger_valid = m_finger_valid && (&path == &m_finger);
+    assert(nullptr != node->next(0));
+    node_type* next = node->next(0);
+    for (level_type level = 0; level <= node->m_level; ++level) {
+        node_type* pred = path.m_node[level];
+        assert(pred->next(level) == node);
+        pred->set_next(level, node->next(level));
+        pred->span(level) += node->span(level) - 1;
+    }
+    for (level_type level = node->m_level + 1; level <= m_levels; ++level) {
+        --path.m_node[level]->span(level);
+    }
+    next->m_prev = node->m_prev;
+
+    destroy_node(node);
+    --m_size;
+    shrink_levels();
+    return next;
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::assign_union(const sl_impl& lhs, const sl_impl& rhs)
+{
+    remove_all();
+    path_type last;
+    collect_last(last);
+    const node_type* a = lhs.front();
+    const node_type* b = rhs.front();
+    while (a != lhs.m_tail && b != rhs.m_tail) {
+        if (m_less(b->m_value, a->m_value)) {
+            link_back(create_node(random_level(), b->m_value), last);
+            b = b->next(0);
+        } else {
+            if (!m_less(a->m_value, b->m_value)) {
+                b = b->next(0);
+            }
+            link_back(create_node(random_level(), a->m_value), last);
+            a = a->next(0);
+        }
+    }
+    for (; a != lhs.m_tail; a = a->next(0)) {
+        link_back(create_node(random_level(), a->m_value), last);
+    }
+    for (; b != rhs.m_tail; b = b->next(0)) {
+        link_back(create_node(random_level(), b->m_value), last);
+    }
+    close_back(last);
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::assign_intersection(const sl_impl& lhs, const sl_impl& rhs)
+{
+    remove_all();
+    path_type last;
+    collect_last(last);
+    // the smaller side is walked, the bigger one searched forward from the previous match
+    const bool lhs_small = gallops(lhs.m_size, rhs.m_size);
+    if (lhs_small || gallops(rhs.m_size, lhs.m_size)) {
+        const sl_impl& small = lhs_small ? lhs : rhs;
+        sl_impl& large = const_cast<sl_impl&>(lhs_small ? rhs : lhs);
+        node_type* pos = large.m_head;
+        for (const node_type* x = small.front(); x != small.m_tail; x = x->next(0)) {
+            pos = large.find_from(pos, x->m_value);
+            if (pos == large.m_tail) {
+                break;
+            }
+            if (!m_less(x->m_value, pos->m_value)) {
+                link_back(create_node(random_level(), lhs_small ? x->m_value : pos->m_value), last);
+            }
+        }
+        close_back(last);
+        return;
+    }
+    const node_type* a = lhs.front();
+    const node_type* b = rhs.front();
+    while (a != lhs.m_tail && b != rhs.m_tail) {
+        if (m_less(a->m_value, b->m_value)) {
+            a = a->next(0);
+        } else if (m_less(b->m_value, a->m_value)) {
+            b = b->next(0);
+        } else {
+            link_back(create_node(random_level(), a->m_value), last);
+            a = a->next(0);
+            b = b->next(0);
+        }
+    }
+    close_back(last);
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::assign_difference(const sl_impl& lhs, const sl_impl& rhs)
+{
+    remove_all();
+    path_type last;
+    collect_last(last);
+    const node_type* a = lhs.front();
+    if (gallops(lhs.m_size, rhs.m_size)) {
+        sl_impl& large = const_cast<sl_impl&>(rhs);
+        node_type* pos = large.m_head;
+        for (; a != lhs.m_tail; a = a->next(0)) {
+            pos = large.find_from(pos, a->m_value);
+            if (pos == large.m_tail || m_less(a->m_value, pos->m_value)) {
+                link_back(create_node(random_level(), a->m_value), last);
+            }
+        }
+        close_back(last);
+        return;
+    }
+    const node_type* b = rhs.front();
+    while (a != lhs.m_tail) {
+        if (b == rhs.m_tail || m_less(a->m_value, b->m_value)) {
+            link_back(create_node(random_level(), a->m_value), last);
+            a = a->next(0);
+        } else {
+            if (!m_less(b->m_value, a->m_value)) {
+                a = a->next(0);
+            }
+            b = b->next(0);
+        }
+    }
+    close_back(last);
+}
+
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+void sl_impl<T, C, A, G, S>::split(const Key& key, sl_impl& rest)
+{
+    path_type path;
+    find_predecessors(key, path);
+    cut(path, rest);
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::cut(path_type& path, sl_impl& rest)
+{
+    assert(this != &rest);
+    assert(rest.m_size == 0);
+    assert(m_alloc == rest.m_alloc);
+
+    rest.m_finger_valid = false;
+
+    const size_type count = path.m_rank[0]; // nodes which stay
+    node_type* first = path.m_node[0]->next(0);
+    if (first == m_tail) {
+        return;
+    }
+    path_type last;
+    collect_last(last);
+    for (level_type level = 0; level <= m_levels; ++level) {
+        node_type* pred = path.m_node[level];
+        if (pred->next(level) != m_tail) {
+            rest.m_head->set_next(level, pred->next(level));
+            rest.m_head->span(level) = pred->span(level) + path.m_rank[level] - count;
+            // the spans of the last links do not change, they end just as far from the new tail
+            last.m_node[level]->set_next(level, rest.m_tail);
+            pred->set_next(level, m_tail);
+        }
+        // no node above this height moves, but the links to the tail get shorter all the same
+        pred->span(level) = count + 1 - path.m_rank[level];
+    }
+    first->m_prev = rest.m_head;
+    rest.m_tail->m_prev = m_tail->m_prev;
+    m_tail->m_prev = path.m_node[0];
+
+    rest.m_size = m_size - count;
+    rest.m_levels = m_levels;
+    m_size = count;
+    shrink_levels();
+    rest.shrink_levels();
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::join(sl_impl& other)
+{
+    if (this == &other || other.m_size == 0) {
+        return;
+    }
+    assert(m_size == 0 || m_less(back()->m_value, other.front()->m_value));
+
+    path_type last;
+    collect_last(last);
+    if (!(m_alloc == other.m_alloc)) {
+        for (node_type* node = other.front(); node != other.m_tail; node = node->next(0)) {
+            link_back(create_node(random_level(), std::move(node->m_value)), last);
+        }
+        close_back(last);
+        other.remove_all();
+        return;
+    }
+
+    path_type other_last;
+    other.collect_last(other_last);
+    for (level_type level = 0; level <= other.m_levels; ++level) {
+        node_type* pred = last.m_node[level];
+        pred->set_next(level, other.m_head->next(level));
+        pred->span(level) = m_size - last.m_rank[level] + other.m_head->span(level);
+        other_last.m_node[level]->set_next(level, m_tail);
+    }
+    for (level_type level = other.m_levels + 1; level <= m_levels; ++level) {
+        last.m_node[level]->span(level) += other.m_size;
+    }
+    other.front()->m_prev = m_tail->m_prev;
+    m_tail->m_prev = other.m_tail->m_prev;
+    m_size += other.m_size;
+    m_levels = std::max(m_levels, other.m_levels);
+
+    for (level_type level = 0; level <= other.m_levels; ++level) {
+        other.m_head->set_next(level, other.m_tail);
+        other.m_head->span(level) = 1;
+    }
+    other.m_tail->m_prev = other.m_head;
+    other.m_size = 0;
+    other.m_levels = 0;
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::extract(node_type* first, node_type* last, sl_impl& out)
+{
+    if (first == last) {
+        return;
+    }
+    path_type path;
+    find_predecessors(first->m_value, path);
+    assert(path.m_node[0]->next(0) == first);
+    cut(path, out);
+    if (last != m_tail) {
+        // give back what follows the range
+        sl_impl rest(get_allocator());
+        out.find_predecessors(last->m_value, path);
+        out.cut(path, rest);
+        join(rest);
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::remove_range(node_type* first, node_type* last)
+{
+    if (first == last) {
+        return last;
+    }
+    path_type path;
+    find_predecessors(first->m_value, path);
+    assert(path.m_node[0]->next(0) == first);
+    m_finger_valid = false;
+
+    const size_type last_rank = rank(last);
+    const size_type count = last_rank - path.m_rank[0] - 1;
+    // every level skips its nodes of the range, O(k) over all the levels
+    for (level_type level = 0; level <= m_levels; ++level) {
+        node_type* pred = path.m_node[level];
+        node_type* next = pred->next(level);
+        size_type next_rank = path.m_rank[level] + pred->span(level);
+        while (next_rank < last_rank) {
+            next_rank += next->span(level);
+            next = next->next(level);
+        }
+        pred->set_next(level, next);
+        pred->span(level) = next_rank - count - path.m_rank[level];
+    }
+    last->m_prev = path.m_node[0];
+    m_size -= count;
+
+    // the range is still chained at level 0
+    while (first != last) {
+        node_type* next = first->next(0);
+        destroy_node(first);
+        first = next;
+    }
+    shrink_levels();
+    return last;
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::at(size_type rank)
+{
+    if (rank > m_size) {
+        return m_tail;
+    }
     node_type* curr = m_head;
-    for (level_type level = node->m_level + 1; level > 0;) {
+    size_type pos = 0;
+    for (level_type level = m_levels + 1; level > 0 && pos != rank; ) {
         --level;
-        assert(level <= curr->m_level);
-        while (curr->m_next[level] != m_tail && m_less(curr->m_next[level]->m_value, node->m_value)) {
-            curr = curr->m_next[level];
+        while ((curr->next(level) != m_tail) && (pos + curr->span(level) <= rank)) {
+            pos += curr->span(level);
+            curr = curr->next(level);
         }
-        if (curr->m_next[level] == node)
-        {
-            curr->m_next[level] = node->m_next[level];
+    }
+    return curr;
+}
+
+template <class T, class C, class A, class G, class S>
+const typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::at(size_type rank) const
+{
+    return const_cast<sl_impl*>(this)->at(rank);
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::size_type sl_impl<T, C, A, G, S>::rank(const node_type* node) const
+{
+    if (node == m_tail) {
+        return m_size + 1;
+    }
+    const node_type* curr = m_head;
+    size_type pos = 0;
+    for (level_type level = m_levels + 1; level > 0 && curr != node; ) {
+        --level;
+        while ((curr->next(level) != m_tail) &&
+                (curr->next(level) == node || m_less(curr->next_value(level), node->m_value))) {
+            pos += curr->span(level);
+            curr = curr->next(level);
         }
     }
+    assert(curr == node);
+    return pos;
+}
 
-    delete node;
-    --m_size;
+template <class T, class C, class A, class G, class S>
+template <typename Key>
+typename sl_impl<T, C, A, G, S>::size_type sl_impl<T, C, A, G, S>::count_less(const Key& value) const
+{
+    m_stats.on_descent(descent::find);
+    const node_type* curr = m_head;
+    const node_type* bound = m_tail;
+    size_type pos = 0;
+    for (level_type level = m_levels + 1; level > 0; ) {
+        --level;
+        const node_type* next = curr->next(level);
+        while (next != bound && m_less(curr->next_value(level), value)) {
+            pos += curr->span(level);
+            m_stats.on_hop(level);
+            curr = next;
+            next = curr->next(level);
+        }
+        bound = next;
+    }
+    return pos;
 }
 
-template <class T, class C, class A>
-void sl_impl<T, C, A>::remove_all()
+template <class T, class C, class A, class G, class S>
+stats_snapshot sl_impl<T, C, A, G, S>::stats() const
 {
-    node_type* node = m_head->m_next[0];
+    stats_snapshot snapshot;
+    snapshot.m_size = m_size;
+    snapshot.m_levels = m_levels;
+    for (const node_type* node = m_head->next(0); node != m_tail; node = node->next(0)) {
+        ++snapshot.m_level_histogram[node->m_level];
+        snapshot.m_node_bytes += storage_count(node->m_level) * sizeof(node_storage);
+    }
+    if (m_size != 0) {
+        snapshot.m_bytes_per_node = static_cast<double>(snapshot.m_node_bytes) / static_cast<double>(m_size);
+    }
+    m_stats.fill(snapshot);
+    if constexpr (stats_type::enabled) {
+        snapshot.m_comparisons = m_less.calls();
+    }
+    return snapshot;
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::reset_stats()
+{
+    m_stats.reset();
+    if constexpr (stats_type::enabled) {
+        m_less.reset();
+    }
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::remove_all()
+{
+    m_finger_valid = false;
+    if (releases_arena()) {
+        // every node lives in our arena, drop it in O(1)
+        detach_all();
+        if constexpr (sl_has_release<node_allocator>::value) {
+            m_alloc.release();
+        }
+        return;
+    }
+    if (m_size == 0) {
+        return;
+    }
+    node_type* node = detach_all();
     while (node != m_tail) {
-        node_type* next = node->m_next[0];
-        delete node;
+        node_type* next = node->next(0);
+        destroy_node(node);
         node = next;
     }
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::detach_all()
+{
+    node_type* first = m_head->next(0);
     for (level_type level = 0; level < m_levels + 1; ++level) {
-        m_head->m_next[level] = m_tail;
+        m_head->set_next(level, m_tail);
+        m_head->span(level) = 1;
     }
     m_tail->m_prev = m_head;
+    m_levels = 0;
     m_size = 0;
+    m_finger_valid = false;
+    return first;
 }
 
-template <class T, class C, class A>
-void sl_impl<T, C, A>::dump() const
+template <class T, class C, class A, class G, class S>
+bool sl_impl<T, C, A, G, S>::compact_step(size_type count, bool rebalance)
+{
+    if (m_compact_rank == 0 || m_compact_rank > m_size) {
+        m_compact_rank = 1;
+    }
+    size_type rank = m_compact_rank;
+    count = std::min(count, m_size + 1 - rank);
+    path_type path;
+    node_type* node = find_rank_predecessors(rank, path);
+    const level_type limit = level_limit();
+    while (count != 0) {
+        // the heights of the next nodes size their slab
+        size_type units = slab_header_units;
+        size_type slab_count = 0;
+        for (const node_type* next = node; slab_count < std::min(count, compact_slab_size); next = next->next(0)) {
+            const size_type more = storage_count(rebalance ? ideal_level(rank + slab_count, limit) : next->m_level);
+            if (units + more > max_slab_units) {
+                break;
+            }
+            units += more;
+            ++slab_count;
+        }
+        node = relocate(node, slab_count, units, rank, limit, rebalance, path);
+        rank += slab_count;
+        count -= slab_count;
+        m_compact_rank = rank;
+    }
+    if (rank <= m_size) {
+        return false;
+    }
+    // the next call starts over, even if the list grows past the rank in between
+    m_compact_rank = 0;
+    return true;
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::compact(bool rebalance)
+{
+    m_compact_rank = 0;
+    compact_step(m_size, rebalance);
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::find_rank_predecessors(size_type rank, path_type& path)
+{
+    node_type* curr = m_head;
+    size_type pos = 0;
+    for (level_type level = m_levels + 1; level > 0; ) {
+        --level;
+        while ((curr->next(level) != m_tail) && (pos + curr->span(level) < rank)) {
+            pos += curr->span(level);
+            curr = curr->next(level);
+        }
+        path.m_node[level] = curr;
+        path.m_rank[level] = pos;
+    }
+    return curr->next(0);
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::node_type* sl_impl<T, C, A, G, S>::relocate(node_type* node, size_type count, size_type units, size_type rank,
+                                                                               level_type limit, bool rebalance, path_type& path)
+{
+    assert(count != 0 && units <= max_slab_units);
+    node_storage* slab = node_alloc_traits::allocate(m_alloc, units);
+    m_stats.on_allocate(units * sizeof(node_storage));
+    slab_header* header = ::new (static_cast<void*>(slab)) slab_header(units);
+    size_type offset = slab_header_units;
+    try {
+        for (; count != 0; --count, ++rank) {
+            const level_type level = rebalance ? ideal_level(rank, limit) : node->m_level;
+            node_type* moved = ::new (static_cast<void*>(slab + offset)) node_type(level, std::move(node->m_value));
+            moved->m_slab = static_cast<std::uint32_t>(offset);
+            header->m_live.fetch_add(1, std::memory_order_relaxed);
+            offset += storage_count(level);
+            // the new node takes the place of the old one, whose block may be the last of an older slab
+            node_type* next = unlink(node, path);
+            link_new(moved, path);
+            for (level_type i = 0; i <= level; ++i) {
+                path.m_node[i] = moved;
+                path.m_rank[i] = rank;
+            }
+            node = next;
+        }
+    } catch (...) {
+        if (header->m_live.load(std::memory_order_relaxed) == 0) {
+            header->~slab_header();
+            node_alloc_traits::deallocate(m_alloc, slab, units);
+            m_stats.on_deallocate(units * sizeof(node_storage));
+        }
+        throw;
+    }
+    return node;
+}
+
+template <class T, class C, class A, class G, class S>
+typename sl_impl<T, C, A, G, S>::level_type sl_impl<T, C, A, G, S>::ideal_level(size_type rank, level_type limit)
+{
+    // the rank reaches level L when rank * p^L crosses an integer, one rank in 1 / p^L does
+    constexpr long double p = sl_promotion<level_generator_type>::value;
+    const long double above = static_cast<long double>(rank);
+    const long double below = static_cast<long double>(rank - 1);
+    long double scale = 1;
+    level_type level = 0;
+    while (level < limit) {
+        scale *= p;
+        if (static_cast<size_type>(above * scale) == static_cast<size_type>(below * scale)) {
+            break;
+        }
+        ++level;
+    }
+    return level;
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::merge(sl_impl& other)
+{
+    if (this == &other || other.m_size == 0) {
+        return;
+    }
+    path_type other_last;
+    if (!(m_alloc == other.m_alloc)) {
+        // the nodes cannot change hands, move the values instead
+        node_type* node = other.detach_all();
+        other.collect_last(other_last);
+        while (node != other.m_tail) {
+            node_type* next = node->next(0);
+            if (insert(std::move(node->m_value), true).second) {
+                other.destroy_node(node);
+            } else {
+                other.link_back(node, other_last);
+            }
+            node = next;
+        }
+        other.close_back(other_last);
+        return;
+    }
+
+    const size_type other_size = other.m_size;
+    node_type* b = other.detach_all();
+    other.collect_last(other_last);
+    if (gallops(other_size, m_size)) {
+        // few nodes, each one is linked in from where the previous one went
+        while (b != other.m_tail) {
+            node_type* next = b->next(0);
+            node_type* found = find_near(b->m_value);
+            if (found != m_tail && !m_less(b->m_value, found->m_value)) {
+                other.link_back(b, other_last);
+            } else {
+                link_new(b, m_finger);
+            }
+            b = next;
+        }
+        other.close_back(other_last);
+        return;
+    }
+
+    path_type last;
+    node_type* a = detach_all();
+    collect_last(last);
+    while (a != m_tail && b != other.m_tail) {
+        if (m_less(b->m_value, a->m_value)) {
+            node_type* next = b->next(0);
+            link_back(b, last);
+            b = next;
+        } else {
+            if (!m_less(a->m_value, b->m_value)) {
+                // equal values stay where they are
+                node_type* next = b->next(0);
+                other.link_back(b, other_last);
+                b = next;
+            }
+            node_type* next = a->next(0);
+            link_back(a, last);
+            a = next;
+        }
+    }
+    for (; a != m_tail; ) {
+        node_type* next = a->next(0);
+        link_back(a, last);
+        a = next;
+    }
+    for (; b != other.m_tail; ) {
+        node_type* next = b->next(0);
+        link_back(b, last);
+        b = next;
+    }
+    close_back(last);
+    other.close_back(other_last);
+}
+
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::dump() const
 {
     for (level_type level = 0; level <= m_levels; ++level) {
         std::cout << "L" << level << ": " << std::flush;
-        node_type* curr = m_head->m_next[level];
-        std::cout << m_head->m_value << " -> "<< std::flush;
+        node_type* curr = m_head->next(level);
+        std::cout << "head -> "<< std::flush;
         while (curr != m_tail) {
-            std::cout << curr->m_value << "(" << curr->m_prev->m_value << ") -> "<< std::flush;
-            curr = curr->m_next[level];
+            std::cout << curr->m_value << "(";
+            if (curr->m_prev == m_head) {
+                std::cout << "head";
+            } else {
+                std::cout << curr->m_prev->m_value;
+            }
+            std::cout << ") -> "<< std::flush;
+            curr = curr->next(level);
         }
-        std::cout << m_tail->m_value << "(" << m_tail->m_prev->m_value << ")" << std::endl;
+        std::cout << "tail" << std::endl;
     }
 }
 
-template <class T, class C, class A>
-void sl_impl<T, C, A>::pretty_dump() const
+template <class T, class C, class A, class G, class S>
+void sl_impl<T, C, A, G, S>::pretty_dump() const
 {
 
     for (level_type level = m_levels + 1; level > 0; ) {
         --level;
         std::cout << "L" << level << ": ";
-        for (node_type* curr = m_head->m_next[0]; curr != m_tail; curr = curr->m_next[0]) {
+        for (node_type* curr = m_head->next(0); curr != m_tail; curr = curr->next(0)) {
             if (curr->m_level >= level) {
                 std::cout << "-->" << curr->m_value;
             } else {
@@ -0,0 +1,79 @@
+#pragma once
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+template <typename T, typename Allocator>
+sl_slab<T, Allocator>::sl_slab(const Allocator& alloc)
+    : m_alloc(alloc)
+    , m_free(nullptr)
+    , m_chunks(nullptr)
+{ }
+
+template <typename T, typename Allocator>
+sl_slab<T, Allocator>::sl_slab(sl_slab&& other) noexcept
+    : m_alloc(other.m_alloc)
+    , m_free(other.m_free)
+    , m_chunks(other.m_chunks)
+{
+    other.m_free = nullptr;
+    other.m_chunks = nullptr;
+}
+
+template <typename T, typename Allocator>
+void sl_slab<T, Allocator>::swap(sl_slab& other) noexcept
+{
+    using std::swap;
+    swap(m_alloc, other.m_alloc);
+    swap(m_free, other.m_free);
+    swap(m_chunks, other.m_chunks);
+}
+
+template <typename T, typename Allocator>
+sl_slab<T, Allocator>::~sl_slab()
+{
+    release();
+}
+
+template <typename T, typename Allocator>
+T* sl_slab<T, Allocator>::allocate()
+{
+    if (m_free == nullptr) {
+        slot* chunk = slot_alloc_traits::allocate(m_alloc, chunk_slots + 1);
+        chunk->m_next = m_chunks;
+        m_chunks = chunk;
+        for (size_type i = chunk_slots; i > 0; --i) {
+            chunk[i].m_next = m_free;
+            m_free = &chunk[i];
+        }
+    }
+    slot* free_slot = m_free;
+    m_free = free_slot->m_next;
+    return reinterpret_cast<T*>(&free_slot->m_storage);
+}
+
+template <typename T, typename Allocator>
+void sl_slab<T, Allocator>::deallocate(T* ptr)
+{
+    slot* free_slot = reinterpret_cast<slot*>(ptr);
+    free_slot->m_next = m_free;
+    m_free = free_slot;
+}
+
+template <typename T, typename Allocator>
+void sl_slab<T, Allocator>::release()
+{
+    while (m_chunks != nullptr) {
+        slot* next = m_chunks->m_next;
+        slot_alloc_traits::deallocate(m_alloc, m_chunks, chunk_slots + 1);
+        m_chunks = next;
+    }
+    m_free = nullptr;
+}
+
+} // namespace internal
+
+} // namespace skip_list
@@ -0,0 +1,81 @@
+#pragma once
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+inline std::size_t sl_thread_count(std::size_t requested, std::size_t work)
+{
+    if (requested != 0) {
+        return std::max<std::size_t>(1, std::min(requested, work));
+    }
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    return std::max<std::size_t>(1, std::min<std::size_t>(hardware, work / sl_parallel_grain));
+}
+
+template <typename Task>
+void sl_run_parallel(std::size_t count, Task&& task)
+{
+    if (count == 0) {
+        return;
+    }
+    std::vector<std::exception_ptr> errors(count);
+    const auto run = [&](std::size_t i) {
+        try {
+            task(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(count - 1);
+    try {
+        for (std::size_t i = 0; i + 1 < count; ++i) {
+            workers.emplace_back(run, i);
+        }
+    } catch (...) {
+        // no thread may outlive the references it holds
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+    run(count - 1);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+template <typename RandomIt, typename Less>
+void sl_parallel_sort(RandomIt first, RandomIt last, Less less, std::size_t threads)
+{
+    const std::size_t count = static_cast<std::size_t>(last - first);
+    threads = std::max<std::size_t>(1, std::min(threads, count));
+    std::vector<RandomIt> bounds(threads + 1);
+    for (std::size_t i = 0; i <= threads; ++i) {
+        bounds[i] = first + static_cast<std::ptrdiff_t>(count * i / threads);
+    }
+    sl_run_parallel(threads, [&](std::size_t i) {
+        // stable, as the merges are: of equal values the build keeps the first
+        std::stable_sort(bounds[i], bounds[i + 1], Less(less));
+    });
+    // every round merges neighbouring runs, halving their number
+    for (std::size_t width = 1; width < threads; width *= 2) {
+        const std::size_t merges = (threads - width + 2 * width - 1) / (2 * width);
+        sl_run_parallel(merges, [&](std::size_t m) {
+            const std::size_t lo = 2 * width * m;
+            std::inplace_merge(bounds[lo], bounds[lo + width], bounds[std::min(lo + 2 * width, threads)], Less(less));
+        });
+    }
+}
+
+} // namespace internal
+
+} // namespace skip_list
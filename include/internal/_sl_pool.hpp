@@ -0,0 +1,82 @@
+#pragma once
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+inline sl_pool::sl_pool(size_type chunk_size)
+    : m_chunk_size(chunk_size)
+    , m_reserved(0)
+    , m_free()
+    , m_chunks(nullptr)
+    , m_cursor(nullptr)
+    , m_end(nullptr)
+{ }
+
+inline sl_pool::~sl_pool()
+{
+    release();
+}
+
+inline void* sl_pool::allocate(size_type bytes)
+{
+    const size_type index = size_class(bytes);
+    if (index < m_free.size() && m_free[index] != nullptr) {
+        free_block* block = m_free[index];
+        m_free[index] = block->m_next;
+        return block;
+    }
+    const size_type size = index * granule;
+    if (size > m_chunk_size / 4) {
+        // big blocks get a chunk of their own, no point to split a chunk for them
+        return allocate_chunk(size);
+    }
+    if (static_cast<size_type>(m_end - m_cursor) < size) {
+        m_cursor = static_cast<char*>(allocate_chunk(m_chunk_size - header_size()));
+        m_end = m_cursor + (m_chunk_size - header_size());
+    }
+    void* ptr = m_cursor;
+    m_cursor += size;
+    return ptr;
+}
+
+inline void sl_pool::deallocate(void* ptr, size_type bytes)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    const size_type index = size_class(bytes);
+    if (index >= m_free.size()) {
+        m_free.resize(index + 1, nullptr);
+    }
+    free_block* block = ::new (ptr) free_block{m_free[index]};
+    m_free[index] = block;
+}
+
+inline void sl_pool::release()
+{
+    while (m_chunks != nullptr) {
+        chunk* next = m_chunks->m_next;
+        ::operator delete(m_chunks);
+        m_chunks = next;
+    }
+    m_free.clear();
+    m_reserved = 0;
+    m_cursor = nullptr;
+    m_end = nullptr;
+}
+
+inline void* sl_pool::allocate_chunk(size_type bytes)
+{
+    const size_type size = header_size() + bytes;
+    chunk* new_chunk = ::new (::operator new(size)) chunk{m_chunks, size};
+    m_chunks = new_chunk;
+    m_reserved += size;
+    return reinterpret_cast<char*>(new_chunk) + header_size();
+}
+
+} // namespace internal
+
+} // namespace skip_list
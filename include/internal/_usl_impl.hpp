@@ -0,0 +1,481 @@
+#pragma once
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+template <class T, class C, class A, class G, std::size_t B>
+usl_impl<T, C, A, G, B>::usl_impl(const allocator_type& alloc)
+    : m_alloc(alloc)
+    , m_levels(0)
+    , m_size(0)
+    , m_nodes(0)
+    , m_head(nullptr)
+    , m_tail(nullptr)
+{
+    create_sentinels();
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+usl_impl<T, C, A, G, B>::usl_impl(const usl_impl& other)
+    : usl_impl(other, allocator_type(node_alloc_traits::select_on_container_copy_construction(other.m_alloc)))
+{ }
+
+template <class T, class C, class A, class G, std::size_t B>
+usl_impl<T, C, A, G, B>::usl_impl(const usl_impl& other, const allocator_type& alloc)
+    : m_alloc(alloc)
+    , m_levels(0)
+    , m_size(0)
+    , m_nodes(0)
+    , m_head(nullptr)
+    , m_tail(nullptr)
+    , m_less(other.m_less)
+    , m_level_generator(other.m_level_generator)
+{
+    create_sentinels();
+    // the blocks are copied whole with their levels, no search is needed
+    path_type last;
+    std::fill(last.m_node, last.m_node + max_levels, m_head);
+    for (const node_type* node = other.front(); node != other.m_tail; node = node->next(0)) {
+        node_type* copy = create_node(node->m_level);
+        std::copy(node->m_keys, node->m_keys + B, copy->m_keys);
+        copy->m_count = node->m_count;
+        copy->m_prev = last.m_node[0];
+        for (level_type level = 0; level <= node->m_level; ++level) {
+            last.m_node[level]->next(level) = copy;
+            copy->next(level) = m_tail;
+            last.m_node[level] = copy;
+        }
+    }
+    m_tail->m_prev = last.m_node[0];
+    m_levels = other.m_levels;
+    m_size = other.m_size;
+    m_nodes = other.m_nodes;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+usl_impl<T, C, A, G, B>::usl_impl(usl_impl&& other) noexcept
+    : m_alloc(other.m_alloc)
+    , m_levels(0)
+    , m_size(0)
+    , m_nodes(0)
+    , m_head(nullptr)
+    , m_tail(nullptr)
+    , m_less(other.m_less)
+    , m_level_generator(other.m_level_generator)
+{
+    create_sentinels();
+    swap_contents(other);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+usl_impl<T, C, A, G, B>::~usl_impl()
+{
+    remove_all();
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+usl_impl<T, C, A, G, B>& usl_impl<T, C, A, G, B>::operator=(const usl_impl& other)
+{
+    if (this == &other) {
+        return *this;
+    }
+    // the copy takes the allocator the list keeps, so only the contents change hands
+    if constexpr (node_alloc_traits::propagate_on_container_copy_assignment::value) {
+        usl_impl copy(other, allocator_type(other.m_alloc));
+        using std::swap;
+        swap(m_alloc, copy.m_alloc);
+        swap_contents(copy);
+    } else {
+        usl_impl copy(other, allocator_type(m_alloc));
+        swap_contents(copy);
+    }
+    return *this;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+usl_impl<T, C, A, G, B>& usl_impl<T, C, A, G, B>::operator=(usl_impl&& other) noexcept(move_assign_steals)
+{
+    if (this == &other) {
+        return *this;
+    }
+    if constexpr (!move_assign_steals) {
+        if (!(m_alloc == other.m_alloc)) {
+            // the blocks cannot change hands, the keys are copied with the allocator of the list
+            usl_impl copy(other, allocator_type(m_alloc));
+            swap_contents(copy);
+            other.remove_all();
+            return *this;
+        }
+    }
+    remove_all();
+    if constexpr (node_alloc_traits::propagate_on_container_move_assignment::value) {
+        m_alloc = other.m_alloc;
+    }
+    swap_contents(other);
+    return *this;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::swap(usl_impl& other) noexcept
+{
+    if constexpr (node_alloc_traits::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(m_alloc, other.m_alloc);
+    } else {
+        assert(m_alloc == other.m_alloc);
+    }
+    swap_contents(other);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::swap_contents(usl_impl& other) noexcept
+{
+    // the last block of every level is found from the one of the level above, as for a key past the end
+    node_type* last = m_head;
+    node_type* other_last = other.m_head;
+    for (level_type level = std::max(m_levels, other.m_levels) + 1; level > 0; ) {
+        --level;
+        while (last->next(level) != m_tail) {
+            last = last->next(level);
+        }
+        while (other_last->next(level) != other.m_tail) {
+            other_last = other_last->next(level);
+        }
+        node_type* first = m_head->next(level);
+        node_type* other_first = other.m_head->next(level);
+        m_head->next(level) = (other_first == other.m_tail) ? m_tail : other_first;
+        other.m_head->next(level) = (first == m_tail) ? other.m_tail : first;
+        if (last != m_head) {
+            last->next(level) = other.m_tail;
+        }
+        if (other_last != other.m_head) {
+            other_last->next(level) = m_tail;
+        }
+    }
+    node_type* back = m_tail->m_prev;
+    node_type* other_back = other.m_tail->m_prev;
+    m_tail->m_prev = (other_back == other.m_head) ? m_head : other_back;
+    other.m_tail->m_prev = (back == m_head) ? other.m_head : back;
+    m_head->next(0)->m_prev = m_head;
+    other.m_head->next(0)->m_prev = other.m_head;
+
+    using std::swap;
+    swap(m_levels, other.m_levels);
+    swap(m_size, other.m_size);
+    swap(m_nodes, other.m_nodes);
+    swap(m_less, other.m_less);
+    swap(m_level_generator, other.m_level_generator);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::create_sentinels() noexcept
+{
+    m_head = ::new (static_cast<void*>(m_head_storage)) node_type(max_levels - 1);
+    m_tail = ::new (static_cast<void*>(m_tail_storage)) node_type(0);
+    for (size_type i = 0; i < max_levels; ++i) {
+        m_head->next(i) = m_tail;
+    }
+    m_tail->m_prev = m_head;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename usl_impl<T, C, A, G, B>::node_type* usl_impl<T, C, A, G, B>::create_node(level_type level)
+{
+    const size_type count = storage_count(level);
+    node_storage* storage = node_alloc_traits::allocate(m_alloc, count);
+    node_type* node = ::new (static_cast<void*>(storage)) node_type(level);
+    if constexpr (simd_search) {
+        // the whole block is compared, the free slots must never count as less
+        std::fill(node->m_keys, node->m_keys + B, std::numeric_limits<value_type>::max());
+    }
+    return node;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::destroy_node(node_type* node)
+{
+    const size_type count = storage_count(node->m_level);
+    node->~node_type();
+    node_alloc_traits::deallocate(m_alloc, reinterpret_cast<node_storage*>(node), count);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename usl_impl<T, C, A, G, B>::position_type usl_impl<T, C, A, G, B>::lower_bound(const_reference key) const
+{
+    node_type* curr = m_head;
+    for (level_type level = m_levels + 1; level > 0; ) {
+        --level;
+        for (node_type* next = curr->next(level); next != m_tail && m_less(next->min(), key); next = curr->next(level)) {
+            curr = next;
+        }
+    }
+    // curr is the last block starting below the key, the answer is in it or starts the next one
+    if (curr != m_head) {
+        const size_type index = block_lower_bound(curr, key);
+        if (index < curr->m_count) {
+            return position_type(curr, index);
+        }
+    }
+    return position_type(curr->next(0), 0);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename usl_impl<T, C, A, G, B>::position_type usl_impl<T, C, A, G, B>::find(const_reference key) const
+{
+    const position_type pos = lower_bound(key);
+    if (pos.first != m_tail && !m_less(key, pos.first->m_keys[pos.second])) {
+        return pos;
+    }
+    return position_type(m_tail, 0);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename usl_impl<T, C, A, G, B>::node_type* usl_impl<T, C, A, G, B>::find_predecessors(const_reference key, path_type& path)
+{
+    std::fill(path.m_node + m_levels + 1, path.m_node + max_levels, m_head);
+    node_type* curr = m_head;
+    for (level_type level = m_levels + 1; level > 0; ) {
+        --level;
+        for (node_type* next = curr->next(level); next != m_tail && m_less(next->min(), key); next = curr->next(level)) {
+            curr = next;
+        }
+        path.m_node[level] = curr;
+    }
+    return curr->next(0);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+std::pair<typename usl_impl<T, C, A, G, B>::position_type, bool> usl_impl<T, C, A, G, B>::insert(const_reference key)
+{
+    path_type path;
+    node_type* next = find_predecessors(key, path);
+    if (next != m_tail && !m_less(key, next->min())) {
+        return std::make_pair(position_type(next, 0), false);
+    }
+    node_type* node = path.m_node[0];
+    size_type index = 0;
+    if (node == m_head) {
+        if (next == m_tail) {
+            node = create_node(random_level());
+            link(node, path);
+        } else {
+            node = next; // the key becomes the first one of the first block
+        }
+    } else {
+        index = block_lower_bound(node, key);
+        if (index < node->m_count && !m_less(key, node->m_keys[index])) {
+            return std::make_pair(position_type(node, index), false);
+        }
+    }
+    if (node->m_count == B) {
+        split(node, path);
+        if (index > node->m_count) {
+            index -= node->m_count;
+            node = node->next(0);
+        }
+    }
+    insert_at(node, index, key);
+    ++m_size;
+    return std::make_pair(position_type(node, index), true);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+bool usl_impl<T, C, A, G, B>::erase(const_reference key)
+{
+    path_type path;
+    node_type* node = find_predecessors(key, path);
+    size_type index = 0;
+    if (node == m_tail || m_less(key, node->min())) {
+        // not the first key of a block, the path ends at the block itself
+        node = path.m_node[0];
+        if (node == m_head) {
+            return false;
+        }
+        index = block_lower_bound(node, key);
+        if (index == node->m_count || m_less(key, node->m_keys[index])) {
+            return false;
+        }
+    }
+    remove(node, index, path);
+    return true;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename usl_impl<T, C, A, G, B>::position_type usl_impl<T, C, A, G, B>::erase(position_type pos)
+{
+    // the search by the first key of the block stops before it, the block itself is known
+    path_type path;
+    find_predecessors(pos.first->min(), path);
+    return remove(pos.first, pos.second, path);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename usl_impl<T, C, A, G, B>::position_type usl_impl<T, C, A, G, B>::remove(node_type* node, size_type index, path_type& path)
+{
+    erase_at(node, index);
+    --m_size;
+    if (node->m_count == 0) {
+        assert(path.m_node[0] != node);
+        node_type* next = node->next(0);
+        unlink(node, path);
+        return position_type(next, 0);
+    }
+    if (node->m_count < B / 2) {
+        return refill(node, index, path);
+    }
+    return normalize(node, index);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+typename usl_impl<T, C, A, G, B>::position_type usl_impl<T, C, A, G, B>::refill(node_type* node, size_type index, path_type& path)
+{
+    node_type* left = node;
+    node_type* right = node->next(0);
+    if (right == m_tail) {
+        left = node->m_prev;
+        right = node;
+        if (left == m_head) {
+            return normalize(node, index); // a lone block may hold any number of keys
+        }
+    }
+    // the keys only move across the boundary, the offset from the start of left stays
+    const size_type offset = (left == node) ? index : left->m_count + index;
+    if (left->m_count + right->m_count > B) {
+        // both hold half a block once the keys are spread evenly, no link changes
+        const size_type half = (left->m_count + right->m_count) / 2;
+        if (left->m_count < half) {
+            shift_left(left, right, half - left->m_count);
+        } else {
+            shift_right(left, right, left->m_count - half);
+        }
+        return offset < left->m_count ? position_type(left, offset) : normalize(right, offset - left->m_count);
+    }
+    // the path may end at the block itself, unlinking the right one needs its predecessors
+    if (left == node) {
+        for (level_type level = 0; level <= node->m_level; ++level) {
+            path.m_node[level] = node;
+        }
+    } else {
+        find_predecessors(right->min(), path);
+    }
+    shift_left(left, right, right->m_count);
+    unlink(right, path);
+    return normalize(left, offset);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::shift_left(node_type* left, node_type* right, size_type count)
+{
+    assert(left->m_count + count <= B && count <= right->m_count);
+    std::copy(right->m_keys, right->m_keys + count, left->m_keys + left->m_count);
+    std::copy(right->m_keys + count, right->m_keys + right->m_count, right->m_keys);
+    left->m_count += count;
+    right->m_count -= count;
+    if constexpr (simd_search) {
+        std::fill(right->m_keys + right->m_count, right->m_keys + B, std::numeric_limits<value_type>::max());
+    }
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::shift_right(node_type* left, node_type* right, size_type count)
+{
+    assert(right->m_count + count <= B && count <= left->m_count);
+    std::copy_backward(right->m_keys, right->m_keys + right->m_count, right->m_keys + right->m_count + count);
+    std::copy(left->m_keys + left->m_count - count, left->m_keys + left->m_count, right->m_keys);
+    left->m_count -= count;
+    right->m_count += count;
+    if constexpr (simd_search) {
+        std::fill(left->m_keys + left->m_count, left->m_keys + B, std::numeric_limits<value_type>::max());
+    }
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::remove_all()
+{
+    node_type* node = m_head->next(0);
+    while (node != m_tail) {
+        node_type* next = node->next(0);
+        destroy_node(node);
+        node = next;
+    }
+    for (size_type i = 0; i < max_levels; ++i) {
+        m_head->next(i) = m_tail;
+    }
+    m_tail->m_prev = m_head;
+    m_levels = 0;
+    m_size = 0;
+    m_nodes = 0;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::link(node_type* node, const path_type& path)
+{
+    m_levels = std::max(m_levels, node->m_level);
+    for (level_type level = 0; level <= node->m_level; ++level) {
+        node_type* pred = path.m_node[level];
+        node->next(level) = pred->next(level);
+        pred->next(level) = node;
+    }
+    node->m_prev = path.m_node[0];
+    node->next(0)->m_prev = node;
+    ++m_nodes;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::unlink(node_type* node, const path_type& path)
+{
+    for (level_type level = 0; level <= node->m_level; ++level) {
+        node_type* pred = path.m_node[level];
+        assert(pred->next(level) == node);
+        pred->next(level) = node->next(level);
+    }
+    node->next(0)->m_prev = node->m_prev;
+    destroy_node(node);
+    --m_nodes;
+    shrink_levels();
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::split(node_type* node, const path_type& path)
+{
+    // the new block goes right after the node, which is its predecessor wherever it is tall enough
+    path_type preds = path;
+    for (level_type level = 0; level <= node->m_level; ++level) {
+        preds.m_node[level] = node;
+    }
+    node_type* upper = create_node(random_level());
+    constexpr size_type half = B / 2;
+    std::copy(node->m_keys + half, node->m_keys + B, upper->m_keys);
+    upper->m_count = B - half;
+    node->m_count = half;
+    if constexpr (simd_search) {
+        std::fill(node->m_keys + half, node->m_keys + B, std::numeric_limits<value_type>::max());
+    }
+    link(upper, preds);
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::insert_at(node_type* node, size_type index, const_reference key)
+{
+    assert(node->m_count < B);
+    std::copy_backward(node->m_keys + index, node->m_keys + node->m_count, node->m_keys + node->m_count + 1);
+    node->m_keys[index] = key;
+    ++node->m_count;
+}
+
+template <class T, class C, class A, class G, std::size_t B>
+void usl_impl<T, C, A, G, B>::erase_at(node_type* node, size_type index)
+{
+    std::copy(node->m_keys + index + 1, node->m_keys + node->m_count, node->m_keys + index);
+    --node->m_count;
+    if constexpr (simd_search) {
+        node->m_keys[node->m_count] = std::numeric_limits<value_type>::max();
+    }
+}
+
+} // namespace internal
+
+} // namespace skip_list
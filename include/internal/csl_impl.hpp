@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sl_epoch.hpp"
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+/**
+ * @brief Detects level generators which can derive independent ones
+ * (see level_generator::split()).
+ */
+template <typename LevelGenerator, typename = void>
+struct csl_has_split : std::false_type { };
+
+template <typename LevelGenerator>
+struct csl_has_split<LevelGenerator, std::void_t<decltype(std::declval<LevelGenerator&>().split())>>
+    : std::true_type { };
+
+/**
+ * @brief Node of the lock-free skip list
+ * One block holds the node and its tower of atomic links. The lowest bit
+ * of a link marks the owner node as logically deleted at that level.
+ */
+template <typename T>
+class csl_node
+{
+public:
+    using value_type                = T;
+    using size_type                 = std::size_t;
+    using self_type                 = csl_node<T>;
+    using link_type                 = std::atomic<std::uintptr_t>;
+
+    struct sentinel_tag { };
+
+    csl_node(sentinel_tag, size_type level);
+
+    template <typename... Args>
+    explicit csl_node(size_type level, Args&&... args);
+
+    csl_node(const csl_node&) = delete;
+    csl_node& operator=(const csl_node&) = delete;
+
+    /// The value is destroyed by the owner, sentinels have none.
+    ~csl_node() { }
+
+    static constexpr size_type allocation_size(size_type level)
+    {
+        return sizeof(self_type) + (level + 1) * sizeof(link_type);
+    }
+
+    link_type& next(size_type level) { return tower()[level]; }
+    const link_type& next(size_type level) const { return tower()[level]; }
+
+    static self_type* to_node(std::uintptr_t link) { return reinterpret_cast<self_type*>(link & ~std::uintptr_t(1)); }
+    static std::uintptr_t to_link(const self_type* node) { return reinterpret_cast<std::uintptr_t>(node); }
+    static bool is_marked(std::uintptr_t link) { return (link & 1) != 0; }
+
+    union { value_type m_value; };
+    size_type m_level;
+    std::atomic<int> m_refs; // the inserter and the list, the last one to let go retires the node
+
+private:
+    link_type* tower() { return reinterpret_cast<link_type*>(this + 1); }
+    const link_type* tower() const { return reinterpret_cast<const link_type*>(this + 1); }
+
+}; // csl_node
+
+/**
+ * @brief Lock-free skip list
+ *
+ * Insertion links a node bottom-up with CAS. Removal marks the links of the
+ * node top-down, the thread which marks level 0 owns the removal, and any
+ * search passing a marked node snips it out. Unlinked nodes are handed to
+ * an epoch domain, so lookups never touch freed memory.
+ *
+ * Every operation except remove_all() must run with the epoch pinned.
+ */
+template <typename T,
+          typename Compare,
+          typename Allocator,
+          typename LevelGenerator>
+class csl_impl
+{
+public:
+    using size_type                   = std::size_t;
+    using allocator_type              = Allocator;
+    using value_type                  = typename allocator_type::value_type;
+    using reference                   = value_type&;
+    using const_reference             = const value_type&;
+    using pointer                     = typename std::allocator_traits<allocator_type>::pointer;
+    using const_pointer               = typename std::allocator_traits<allocator_type>::const_pointer;
+    using compare                     = Compare;
+    using level_generator_type        = LevelGenerator;
+
+    using level_type                  = std::size_t;
+
+    /// Hard limit of the tower height, the head tower is allocated with this many links.
+    static constexpr level_type max_levels = 32;
+
+    using node_type = csl_node<T>;
+
+private:
+    using node_storage = std::aligned_storage_t<alignof(node_type), alignof(node_type)>;
+    using node_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<node_storage>;
+    using node_alloc_traits = std::allocator_traits<node_allocator>;
+
+public:
+    explicit csl_impl(const allocator_type& alloc = allocator_type());
+
+    csl_impl(const csl_impl&) = delete;
+    csl_impl& operator=(const csl_impl&) = delete;
+
+    ~csl_impl();
+
+    allocator_type get_allocator() const { return allocator_type(m_alloc); }
+    /// Exact when there are no concurrent modifications.
+    size_type size() const;
+    /// Not thread-safe, the per-thread generators are split from it.
+    level_generator_type& get_level_generator() { return m_level_generator; }
+    const level_generator_type& get_level_generator() const { return m_level_generator; }
+    sl_epoch& epoch() const { return m_epoch; }
+
+    node_type* front() const { return next_of(m_head); }
+    /// The first node after the given one at the level which is not logically deleted.
+    static node_type* next_of(const node_type* node, level_type level = 0);
+
+    node_type* find(const_reference value) const;
+    node_type* lower_bound(const_reference value) const;
+    node_type* upper_bound(const_reference value) const;
+
+    /**
+     * @brief Insert the value unless an equal one is present
+     * @return The node of the value and whether it was inserted
+     */
+    std::pair<node_type*, bool> insert(const value_type& value);
+
+    /// @return Whether this call removed the value
+    bool remove(const_reference value);
+
+    /**
+     * @brief Remove the first node and copy its value out
+     * Every caller competes for the same node.
+     * @return false if the list is empty
+     */
+    bool remove_min(value_type& value);
+    /**
+     * @brief Remove a node picked at random near the front and copy its value out
+     * SprayList walk: start log p + 1 levels up and jump forward up to
+     * log^3 p live nodes on every level down, p being the number of
+     * threads removing at once. The callers land on different nodes among
+     * the first O(p log^3 p) instead of all fighting for the first one.
+     * After a few landings on nodes already being removed it falls back to
+     * remove_min().
+     * @return false if the list is empty
+     */
+    bool spray_remove_min(value_type& value, size_type threads);
+
+    /// Not thread-safe, no other thread may access the list.
+    void remove_all();
+
+private:
+    /**
+     * @brief Descent recording the predecessor and successor of the value
+     * Fills at least the levels [0, top] and snips every marked node on the way.
+     * @return Whether the value is present
+     */
+    bool find_predecessors(const_reference value, node_type** preds, node_type** succs, level_type top);
+
+    /// Read-only descent to the first live node for which before() is false.
+    template <typename Before>
+    node_type* search(Before before) const;
+
+    /// Mark the tower top-down, true if this call marked level 0 and so owns the removal.
+    static bool claim(node_type* victim);
+    /// Count a claimed node out, unlink it from every level and release it.
+    void finish_remove(node_type* victim);
+    /// Claim the node and copy its value out.
+    bool take(node_type* victim, value_type& value);
+
+    /// Sprays landing on a node already being removed before giving up on spreading.
+    static constexpr size_type spray_attempts = 4;
+
+    /**
+     * @brief What a thread keeps per list: its level generator and its share of the size
+     * Only the owner thread writes it, so the hot path shares no counter
+     * with the other threads. The states live as long as the list, like
+     * the records of the epoch domain.
+     */
+    struct alignas(64) thread_state
+    {
+        thread_state(std::thread::id owner, level_generator_type&& generator)
+            : m_owner(owner)
+            , m_level_generator(std::move(generator))
+            , m_size(0)
+            , m_unpublished(0)
+            , m_next(nullptr)
+        { }
+
+        const std::thread::id m_owner;
+        level_generator_type m_level_generator;
+        std::atomic<std::ptrdiff_t> m_size; // inserts minus removals of this thread
+        std::ptrdiff_t m_unpublished;       // not yet added to m_size_estimate
+        thread_state* m_next;
+    };
+
+    /// Size changes a thread makes before it adds them to m_size_estimate.
+    static constexpr std::ptrdiff_t publish_period = 64;
+    /// Lists remembered per thread before the oldest entry is dropped.
+    static constexpr size_type cache_size = 16;
+
+    /// The state of the calling thread, created with a generator split from the list's on first use.
+    thread_state& local_state();
+    void count(thread_state& state, std::ptrdiff_t delta);
+
+    static std::uint64_t next_id()
+    {
+        static std::atomic<std::uint64_t> counter(0);
+        return ++counter;
+    }
+
+    level_type random_level(thread_state& state);
+    void raise_levels(level_type level);
+    void release(node_type* node);
+
+    template <typename... Args>
+    node_type* create_node(level_type level, Args&&... args);
+    void destroy_node(node_type* node);
+    static void dispose(void* context, void* object);
+
+    static constexpr size_type storage_count(level_type level)
+    {
+        return (node_type::allocation_size(level) + sizeof(node_storage) - 1) / sizeof(node_storage);
+    }
+
+private:
+    node_allocator m_alloc;
+    std::atomic<level_type> m_levels;
+    std::atomic<thread_state*> m_states;
+    std::mutex m_states_mutex; // a new state splits m_level_generator
+    /// Size up to publish_period per thread, cheap to read for the level limit.
+    std::atomic<std::ptrdiff_t> m_size_estimate;
+    const std::uint64_t m_id;
+    node_type* m_head;
+    compare m_less;
+    level_generator_type m_level_generator;
+    mutable sl_epoch m_epoch;
+
+}; // csl_impl
+
+/**
+ * @brief Weakly consistent forward iterator of the lock-free skip list
+ * It sees the elements present when it passes them and keeps the epoch
+ * pinned until it reaches the end, so it must stay on its thread.
+ */
+template <typename SkipList>
+class csl_iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename SkipList::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+private:
+    using node_type = typename SkipList::node_type;
+    using self_type = csl_iterator<SkipList>;
+
+public:
+    csl_iterator()
+        : m_node(nullptr)
+        , m_guard()
+    { }
+
+    csl_iterator(node_type* node, sl_epoch::guard guard)
+        : m_node(node)
+        , m_guard(node != nullptr ? std::move(guard) : sl_epoch::guard())
+    { }
+
+    self_type& operator++()
+    {
+        m_node = SkipList::next_of(m_node);
+        if (m_node == nullptr) {
+            m_guard = sl_epoch::guard();
+        }
+        return *this;
+    }
+    self_type operator++(int)
+    {
+        self_type tmp(*this);
+        operator++();
+        return tmp;
+    }
+
+    reference operator*() const { return m_node->m_value; }
+    pointer   operator->() const { return &m_node->m_value; }
+
+    bool operator==(const self_type& other) const { return m_node == other.m_node; }
+    bool operator!=(const self_type& other) const { return !operator==(other); }
+
+    /**
+     * @brief Get pointer to the current node
+     * @internal
+     */
+    node_type* get_node() const { return m_node; }
+
+private:
+    node_type* m_node;
+    sl_epoch::guard m_guard;
+
+}; // csl_iterator
+
+} // namespace internal
+
+} // namespace skip_list
+
+#include "_csl_impl.hpp"
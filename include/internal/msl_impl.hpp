@@ -0,0 +1,353 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if !(defined(__unix__) || defined(__APPLE__))
+#error "mapped_skip_list needs POSIX mmap"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+/// First bytes of the journal of a sync, the runs of changed pages follow as offset, length and bytes.
+struct msl_journal_header
+{
+    static constexpr std::uint64_t magic = 0x6c6e72756f6a6c73; // "sljournl"
+
+    std::uint64_t m_magic;
+    std::uint64_t m_file_size;
+    std::uint64_t m_length;   ///< Bytes of the runs
+    std::uint64_t m_checksum; ///< FNV-1a of the fields above and the runs, tells a whole journal from a torn one
+
+}; // msl_journal_header
+
+/**
+ * @brief A whole file mapped private and read-write, changed through a journal
+ * Nothing written to the mapping reaches the file before sync(): the pages
+ * changed since the last one go to the journal, path + "-journal", then to
+ * the file. A sync cut short by a crash is replayed from a whole journal by
+ * the next open(), a torn journal is ignored and the file is still the one
+ * of the sync before. The mapping moves when the file grows, only offsets
+ * into it stay valid.
+ */
+class msl_mapping
+{
+public:
+    using size_type = std::size_t;
+
+    msl_mapping() = default;
+
+    msl_mapping(const msl_mapping&) = delete;
+    msl_mapping& operator=(const msl_mapping&) = delete;
+
+    ~msl_mapping() { close(); }
+
+    /// Create or truncate the file to size bytes of zeros and map it.
+    void create(const std::string& path, size_type size);
+    /// Map an existing file, once the journal of an interrupted sync is replayed.
+    void open(const std::string& path);
+    /// Extend the file to size bytes and map it again, the changed pages come along.
+    void grow(size_type size);
+    /// The bytes of [offset, offset + length), to be written by the next sync.
+    char* write(size_type offset, size_type length);
+    /// Write the changed pages to the journal, then to the file, and wait for both.
+    void sync();
+    /// Unmap the file, the changes since the last sync are dropped.
+    void close();
+
+    bool is_open() const { return m_data != nullptr; }
+    const char* data() const { return m_data; }
+    size_type size() const { return m_size; }
+
+private:
+    void map(size_type size);
+    /// Open the journal next to the file and make its name durable.
+    void open_journal(const std::string& path, bool truncate);
+    /// Copy a whole journal to the file, then empty it.
+    void replay();
+
+    size_type page_count(size_type size) const { return (size + m_page - 1) / m_page; }
+    bool is_dirty(size_type page) const { return (m_dirty[page / 64] >> (page % 64) & 1) != 0; }
+
+    static constexpr std::uint64_t checksum_basis = 0xcbf29ce484222325;
+    /// FNV-1a of the bytes, going on from hash.
+    static std::uint64_t checksum(const void* data, size_type length, std::uint64_t hash);
+    static void write_all(int fd, const void* data, size_type length, size_type offset);
+    static void read_all(int fd, void* data, size_type length, size_type offset);
+
+    [[noreturn]] static void fail(const char* what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+private:
+    int m_fd = -1;
+    int m_journal = -1;
+    std::string m_journal_path;
+    char* m_data = nullptr;
+    size_type m_size = 0;
+    size_type m_page = 0;
+    std::vector<std::uint64_t> m_dirty; ///< One bit per page changed since the last sync
+
+}; // msl_mapping
+
+/// First bytes of a mapped_skip_list file, every link is an offset from the file start.
+struct msl_header
+{
+    static constexpr std::uint64_t magic = 0x3274736c70696b73; // "skiplst2"
+    static constexpr std::size_t max_levels = 32;
+
+    std::uint64_t m_magic;
+    std::uint64_t m_value_size;
+    std::uint64_t m_value_align;
+    std::uint64_t m_capacity;  ///< Bytes of the file, which a growth not synced yet may have extended
+    std::uint64_t m_used;      ///< End of the allocated nodes
+    std::uint64_t m_first;     ///< End of the sentinels, where the elements start
+    std::uint64_t m_size;
+    std::uint64_t m_levels;
+    std::uint64_t m_head;
+    std::uint64_t m_tail;
+    std::uint64_t m_free[max_levels]; ///< Erased nodes by level, linked through m_prev
+
+}; // msl_header
+
+/**
+ * @brief Node of a mapped skip list
+ * Same layout as sl_node with offsets in place of pointers: the value, the
+ * level and the back link, then the tower of m_level + 1 next offsets.
+ */
+template <typename T>
+struct msl_node
+{
+    using size_type = std::size_t;
+
+    static constexpr size_type alignment = std::max(alignof(T), alignof(std::uint64_t));
+
+    /// Bytes of a node with a tower of level + 1 links, a multiple of the alignment.
+    static constexpr size_type allocation_size(size_type level)
+    {
+        const size_type size = sizeof(msl_node) + (level + 1) * sizeof(std::uint64_t);
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    struct sentinel_tag { };
+
+    msl_node(const T& value, std::uint64_t level)
+        : m_value(value)
+        , m_level(level)
+        , m_prev(0)
+    { }
+
+    /// Head or tail, the node holds no value.
+    msl_node(sentinel_tag, std::uint64_t level)
+        : m_level(level)
+        , m_prev(0)
+    { }
+
+    std::uint64_t& next(size_type level) { return reinterpret_cast<std::uint64_t*>(this + 1)[level]; }
+    std::uint64_t next(size_type level) const { return reinterpret_cast<const std::uint64_t*>(this + 1)[level]; }
+
+    union { T m_value; };
+    std::uint64_t m_level;
+    std::uint64_t m_prev;
+
+}; // msl_node
+
+template <typename T,
+          typename Compare,
+          typename LevelGenerator>
+class msl_impl
+{
+public:
+    using size_type                   = std::size_t;
+    using value_type                  = T;
+    using const_reference             = const value_type&;
+    using compare                     = Compare;
+    using level_generator_type        = LevelGenerator;
+    using level_type                  = std::size_t;
+    using node_type                   = msl_node<T>;
+    using offset_type                 = std::uint64_t;
+
+    static constexpr level_type max_levels = msl_header::max_levels;
+    static constexpr size_type default_capacity = size_type(1) << 20;
+
+    static_assert(std::is_trivially_copyable_v<T>, "the values are stored as raw bytes in the file");
+    static_assert(sizeof(msl_header) % node_type::alignment == 0, "the nodes must be aligned after the header");
+
+private:
+    struct path_type
+    {
+        offset_type m_node[max_levels];
+    };
+
+public:
+    msl_impl() = default;
+
+    msl_impl(const msl_impl&) = delete;
+    msl_impl& operator=(const msl_impl&) = delete;
+
+    /// Syncs an open file, errors are lost, call close() to see them.
+    ~msl_impl();
+
+    void create(const std::string& path, size_type capacity);
+    void open(const std::string& path);
+    void close();
+    void sync();
+    bool is_open() const { return m_file.is_open(); }
+
+    level_generator_type& get_level_generator() { return m_level_generator; }
+    size_type size() const { return is_open() ? header().m_size : 0; }
+    size_type file_size() const { return m_file.size(); }
+
+    offset_type head() const { return header().m_head; }
+    offset_type tail() const { return header().m_tail; }
+    offset_type front() const { return node(head())->next(0); }
+
+    const node_type* node(offset_type offset) const { return reinterpret_cast<const node_type*>(m_file.data() + offset); }
+
+    /// First node not less than the key.
+    offset_type lower_bound(const_reference key) const;
+    /// The node equal to the key, tail() if there is none.
+    offset_type find(const_reference key) const;
+
+    std::pair<offset_type, bool> insert(const_reference value);
+    bool erase(const_reference key);
+    void remove_all();
+
+    bool is_less(const_reference lhs, const_reference rhs) const { return m_less(lhs, rhs); }
+
+private:
+    /// Every change goes through these, which mark the pages for the next sync.
+    msl_header& write_header() { return *reinterpret_cast<msl_header*>(m_file.write(0, sizeof(msl_header))); }
+    node_type* write_node(offset_type offset)
+    {
+        return reinterpret_cast<node_type*>(m_file.write(offset, node_type::allocation_size(node(offset)->m_level)));
+    }
+
+    const msl_header& header() const { return *reinterpret_cast<const msl_header*>(m_file.data()); }
+
+    /// Storage for a node of the level, reused from the free list or taken at the end, growing the file.
+    offset_type allocate(level_type level);
+    void deallocate(offset_type offset);
+    offset_type create_node(level_type level, const_reference value);
+    offset_type create_sentinel();
+
+    offset_type find_predecessors(const_reference key, path_type& path) const;
+
+    level_type random_level()
+    {
+        size_type count = header().m_size + 1;
+        level_type limit = 0;
+        while ((count >>= 1) != 0) {
+            ++limit;
+        }
+        return m_level_generator(std::min(limit, max_levels - 1));
+    }
+
+    void shrink_levels()
+    {
+        const msl_header& head_info = header();
+        level_type levels = head_info.m_levels;
+        while (levels > 0 && node(head_info.m_head)->next(levels) == head_info.m_tail) {
+            --levels;
+        }
+        if (levels != head_info.m_levels) {
+            write_header().m_levels = levels;
+        }
+    }
+
+private:
+    msl_mapping m_file;
+    compare m_less;
+    level_generator_type m_level_generator;
+
+}; // msl_impl
+
+/// Bidirectional iterator over the values, holds an offset so it survives the growth of the file.
+template <typename MappedList>
+class msl_iterator
+{
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = typename MappedList::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+private:
+    using offset_type = typename MappedList::offset_type;
+    using self_type = msl_iterator<MappedList>;
+
+public:
+    msl_iterator()
+        : m_list(nullptr)
+        , m_offset(0)
+    { }
+
+    msl_iterator(const MappedList* list, offset_type offset)
+        : m_list(list)
+        , m_offset(offset)
+    { }
+
+    self_type& operator++()
+    {
+        m_offset = m_list->node(m_offset)->next(0);
+        return *this;
+    }
+    self_type operator++(int)
+    {
+        self_type tmp(*this);
+        ++*this;
+        return tmp;
+    }
+    self_type& operator--()
+    {
+        m_offset = m_list->node(m_offset)->m_prev;
+        return *this;
+    }
+    self_type operator--(int)
+    {
+        self_type tmp(*this);
+        --*this;
+        return tmp;
+    }
+
+    reference operator*() const { return m_list->node(m_offset)->m_value; }
+    pointer operator->() const { return &m_list->node(m_offset)->m_value; }
+
+    bool operator==(const self_type& other) const { return m_offset == other.m_offset; }
+    bool operator!=(const self_type& other) const { return m_offset != other.m_offset; }
+
+    offset_type get_offset() const { return m_offset; }
+
+private:
+    const MappedList* m_list;
+    offset_type m_offset;
+
+}; // msl_iterator
+
+} // namespace internal
+
+} // namespace skip_list
+
+#include "_msl_impl.hpp"
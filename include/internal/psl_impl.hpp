@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+/// Tag of the constructors of the head and the tail, which hold no value.
+struct psl_sentinel_tag { };
+
+/// Header of a packed node with a back link.
+template <typename T, bool Backward>
+struct psl_node_fields
+{
+    psl_node_fields(const T& value, std::uint8_t level)
+        : m_value(value)
+        , m_prev(0)
+        , m_level(level)
+    { }
+
+    psl_node_fields(psl_sentinel_tag, std::uint8_t level)
+        : m_prev(0)
+        , m_level(level)
+    { }
+
+    union { T m_value; };
+    std::uint32_t m_prev;
+    std::uint8_t m_level;
+
+}; // psl_node_fields
+
+/// Header of a packed node of a forward only list.
+template <typename T>
+struct psl_node_fields<T, false>
+{
+    psl_node_fields(const T& value, std::uint8_t level)
+        : m_value(value)
+        , m_level(level)
+    { }
+
+    psl_node_fields(psl_sentinel_tag, std::uint8_t level)
+        : m_level(level)
+    { }
+
+    union { T m_value; };
+    std::uint8_t m_level;
+
+}; // psl_node_fields
+
+/**
+ * @brief Node of a packed skip list
+ * The value, the back link if the list has them and a one byte level, then
+ * the tower of m_level + 1 next links. Every link is the 32-bit index of a
+ * node in the arena of the list, counted in allocation units. An int node
+ * of level L takes 12 + 4 * (L + 1) bytes, 8 + 4 * (L + 1) without the back
+ * link, and no allocator header. The header is padded to the alignment of
+ * the links, e.g. a char node without the back link takes 4 + 4 * (L + 1).
+ */
+template <typename T, bool Backward>
+struct alignas(std::max(alignof(T), alignof(std::uint32_t))) psl_node : psl_node_fields<T, Backward>
+{
+    using size_type = std::size_t;
+    using index_type = std::uint32_t;
+
+    using psl_node_fields<T, Backward>::psl_node_fields;
+
+    static constexpr size_type alignment = std::max(alignof(T), alignof(index_type));
+
+    /// Allocation units of a node with a tower of level + 1 links, the padded header included.
+    static constexpr size_type unit_count(size_type level)
+    {
+        return (sizeof(psl_node) + (level + 1) * sizeof(index_type) + alignment - 1) / alignment;
+    }
+
+    // the tower is placed right after the node, alignas pads sizeof(psl_node) to keep it aligned
+    index_type& next(size_type level) { return reinterpret_cast<index_type*>(this + 1)[level]; }
+    index_type next(size_type level) const { return reinterpret_cast<const index_type*>(this + 1)[level]; }
+
+}; // psl_node
+
+template <typename T,
+          typename Compare,
+          typename LevelGenerator,
+          bool Backward>
+class psl_impl
+{
+public:
+    using size_type                   = std::size_t;
+    using value_type                  = T;
+    using const_reference             = const value_type&;
+    using compare                     = Compare;
+    using level_generator_type        = LevelGenerator;
+    using level_type                  = std::size_t;
+    using node_type                   = psl_node<T, Backward>;
+    using index_type                  = typename node_type::index_type;
+
+    static constexpr bool backward = Backward;
+    static constexpr level_type max_levels = 32;
+
+    static_assert(std::is_trivially_copyable_v<T>, "the arena is copied and grown as raw bytes");
+    static_assert(sizeof(node_type) % alignof(index_type) == 0 && alignof(node_type) == node_type::alignment,
+                  "the tower right after the node header must be aligned");
+
+private:
+    using unit_type = std::aligned_storage_t<node_type::alignment, node_type::alignment>;
+
+    struct path_type
+    {
+        index_type m_node[max_levels];
+    };
+
+    /// The sentinels come first in the arena, at fixed indices.
+    static constexpr index_type head_index = 0;
+    static constexpr index_type tail_index = static_cast<index_type>(node_type::unit_count(max_levels - 1));
+    static constexpr size_type sentinel_units = 2 * node_type::unit_count(max_levels - 1);
+    /// Every index must fit in 32 bits.
+    static constexpr size_type max_units = UINT32_MAX;
+
+public:
+    /// No allocation, the arena is created by the first insertion.
+    psl_impl() = default;
+    /// The links are indices, a copy of the arena is a copy of the list.
+    psl_impl(const psl_impl&) = default;
+    psl_impl(psl_impl&& other) noexcept;
+
+    psl_impl& operator=(const psl_impl&) = default;
+    psl_impl& operator=(psl_impl&& other) noexcept;
+    void swap(psl_impl& other) noexcept;
+
+    level_generator_type& get_level_generator() { return m_level_generator; }
+    size_type size() const { return m_size; }
+    /// Bytes of the arena, used or not.
+    size_type capacity_bytes() const { return m_arena.size() * sizeof(unit_type); }
+    /// Make room for count more nodes of the average height.
+    void reserve(size_type count);
+
+    index_type tail() const { return tail_index; }
+    index_type front() const { return m_arena.empty() ? tail_index : node(head_index)->next(0); }
+    /// The last node, the head if the list is empty.
+    index_type back() const;
+
+    const node_type* node(index_type index) const { return reinterpret_cast<const node_type*>(&m_arena[index]); }
+
+    /// First node not less than the key.
+    index_type lower_bound(const_reference key) const;
+    /// The node equal to the key, tail() if there is none.
+    index_type find(const_reference key) const;
+
+    std::pair<index_type, bool> insert(const_reference value);
+    bool erase(const_reference key);
+    void remove_all();
+
+    bool is_less(const_reference lhs, const_reference rhs) const { return m_less(lhs, rhs); }
+
+private:
+    node_type* node(index_type index) { return reinterpret_cast<node_type*>(&m_arena[index]); }
+
+    /// Room for a node of the level, reused from the free list or taken at the end of the arena.
+    index_type allocate(level_type level);
+    void deallocate(index_type index);
+    /// Create the sentinels of a list which has no arena yet.
+    void init();
+
+    index_type find_predecessors(const_reference key, path_type& path) const;
+
+    level_type random_level()
+    {
+        size_type count = m_size + 1;
+        level_type limit = 0;
+        while ((count >>= 1) != 0) {
+            ++limit;
+        }
+        return m_level_generator(std::min(limit, max_levels - 1));
+    }
+
+    void shrink_levels()
+    {
+        while (m_levels > 0 && node(head_index)->next(m_levels) == tail_index) {
+            --m_levels;
+        }
+    }
+
+private:
+    std::vector<unit_type> m_arena; ///< Its size is the capacity, m_used units are given out
+    size_type m_used = 0;
+    size_type m_size = 0;
+    level_type m_levels = 0;
+    index_type m_free[max_levels] = {}; ///< Erased nodes by level, linked through next(0), 0 ends
+    compare m_less;
+    level_generator_type m_level_generator;
+
+}; // psl_impl
+
+/// Iterator over the values, holds an index so it survives the growth of the arena.
+template <typename PackedList>
+class psl_iterator
+{
+public:
+    using iterator_category = std::conditional_t<PackedList::backward, std::bidirectional_iterator_tag, std::forward_iterator_tag>;
+    using value_type = typename PackedList::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+private:
+    using index_type = typename PackedList::index_type;
+    using self_type = psl_iterator<PackedList>;
+
+public:
+    psl_iterator()
+        : m_list(nullptr)
+        , m_index(0)
+    { }
+
+    psl_iterator(const PackedList* list, index_type index)
+        : m_list(list)
+        , m_index(index)
+    { }
+
+    self_type& operator++()
+    {
+        m_index = m_list->node(m_index)->next(0);
+        return *this;
+    }
+    self_type operator++(int)
+    {
+        self_type tmp(*this);
+        ++*this;
+        return tmp;
+    }
+    self_type& operator--()
+    {
+        static_assert(PackedList::backward, "a list without back links only iterates forward");
+        m_index = m_list->node(m_index)->m_prev;
+        return *this;
+    }
+    self_type operator--(int)
+    {
+        self_type tmp(*this);
+        --*this;
+        return tmp;
+    }
+
+    reference operator*() const { return m_list->node(m_index)->m_value; }
+    pointer operator->() const { return &m_list->node(m_index)->m_value; }
+
+    bool operator==(const self_type& other) const { return m_index == other.m_index; }
+    bool operator!=(const self_type& other) const { return m_index != other.m_index; }
+
+    index_type get_index() const { return m_index; }
+
+private:
+    const PackedList* m_list;
+    index_type m_index;
+
+}; // psl_iterator
+
+} // namespace internal
+
+} // namespace skip_list
+
+#include "_psl_impl.hpp"
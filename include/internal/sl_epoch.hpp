@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+/**
+ * @brief Epoch-based memory reclamation domain
+ *
+ * Threads pin the domain for the duration of an operation. An object
+ * unlinked from a shared structure is retired with the global epoch of
+ * that moment and disposed of only after the global epoch advanced twice,
+ * i.e. when no thread which could have seen it is still pinned.
+ *
+ * Every thread gets its own record in the domain on first use, records
+ * live as long as the domain.
+ */
+class sl_epoch
+{
+public:
+    using size_type = std::size_t;
+    using dispose_function = void (*)(void* context, void* object);
+
+private:
+    struct record
+    {
+        explicit record(std::thread::id owner)
+            : m_epoch(0)
+            , m_owner(owner)
+            , m_nesting(0)
+            , m_retired(0)
+            , m_limbo()
+            , m_next(nullptr)
+        { }
+
+        std::atomic<std::uint64_t> m_epoch; // (epoch << 1) | 1 while pinned, zero otherwise
+        const std::thread::id m_owner;
+        size_type m_nesting;
+        size_type m_retired;
+        std::vector<std::pair<std::uint64_t, void*>> m_limbo; // (retire epoch, object)
+        record* m_next;
+    };
+
+public:
+    /**
+     * @brief Keeps the domain pinned by the current thread while alive
+     * Guards nest, copies pin again. A guard must stay on the thread which created it.
+     */
+    class guard
+    {
+    public:
+        guard() noexcept : m_domain(nullptr), m_record(nullptr) { }
+        explicit guard(sl_epoch& domain);
+        guard(const guard& other);
+        guard(guard&& other) noexcept;
+        guard& operator=(guard other) noexcept;
+        ~guard();
+
+        void swap(guard& other) noexcept
+        {
+            std::swap(m_domain, other.m_domain);
+            std::swap(m_record, other.m_record);
+        }
+
+        bool is_pinned() const { return m_record != nullptr; }
+
+    private:
+        friend class sl_epoch;
+
+        sl_epoch* m_domain;
+        record* m_record;
+
+    }; // guard
+
+    sl_epoch(dispose_function dispose, void* context);
+
+    sl_epoch(const sl_epoch&) = delete;
+    sl_epoch& operator=(const sl_epoch&) = delete;
+
+    ~sl_epoch();
+
+    guard pin() { return guard(*this); }
+
+    /// Dispose of the object once no pinned thread can reference it, the caller must be pinned.
+    void retire(void* object);
+
+    /// Dispose of every retired object, no thread may be pinned.
+    void reclaim_all();
+
+private:
+    /// Try to advance the epoch and dispose of what became safe, every this many retires.
+    static constexpr size_type collect_period = 64;
+    /// Domains remembered per thread before the oldest entry is dropped.
+    static constexpr size_type cache_size = 16;
+
+    record* local_record();
+    void enter(record* rec);
+    void leave(record* rec);
+    void try_advance();
+    void collect(record* rec, std::uint64_t safe_epoch);
+
+    static std::uint64_t next_id()
+    {
+        static std::atomic<std::uint64_t> counter(0);
+        return ++counter;
+    }
+
+private:
+    std::atomic<std::uint64_t> m_global;
+    std::atomic<record*> m_records;
+    const std::uint64_t m_id;
+    dispose_function m_dispose;
+    void* m_context;
+
+}; // sl_epoch
+
+} // namespace internal
+
+} // namespace skip_list
+
+#include "_sl_epoch.hpp"
@@ -2,18 +2,57 @@
 
 #include <iostream>
 #include <functional>
+#include <cstring>
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../stats_policy.hpp"
+#include "sl_parallel.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SKIP_LIST_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define SKIP_LIST_PREFETCH(address) ((void)(address))
+#endif
 
 namespace skip_list
 {
 
+/**
+ * @brief Opt-in layout copying the value of every successor into the tower of its predecessor
+ * A descent then decides whether to move right from the node it stands on and
+ * only loads the nodes it actually moves to, at the price of sizeof(T) more
+ * per link. Meant for small trivially copyable keys of read-heavy lists,
+ * specialize as std::true_type to enable it. The values must then never be
+ * modified in place.
+ */
+template <typename T>
+struct key_in_tower : std::false_type { };
+
 namespace internal
 {
 
 template <typename SkipList> class sl_iterator;
 template <typename SkipList> class sl_const_iterator;
 
-template <typename T>
+/**
+ * @brief Skip list node
+ * The node is allocated as one variable-size block: the node header is
+ * followed by the tower of m_level + 1 next pointers and then by the
+ * spans of these links, i.e. the number of level 0 steps each one skips.
+ * With TowerKeys the values of the successors come last, one per link.
+ *
+ * Links are only changed through set_next(), which keeps these copies right.
+ */
+template <typename T, bool TowerKeys = false>
 class sl_node
 {
 public:
@@ -21,28 +60,152 @@ public:
     using size_type                 = std::size_t;
     using reference                 = value_type&;
     using const_reference           = const value_type&;
-    using self_type = sl_node<T>;
+    using self_type = sl_node<T, TowerKeys>;
+
+    static_assert(!TowerKeys || (std::is_trivially_copyable_v<T> && alignof(T) <= alignof(size_type)),
+                  "only small trivially copyable values can be copied into the towers");
+
+    struct sentinel_tag { };
 
-    sl_node() = default;
+    /// Head or tail, the node holds no value.
+    sl_node(sentinel_tag, size_type level);
 
-    sl_node(value_type value, size_type level);
+    /// The value is constructed in place from the arguments.
+    template <typename... Args>
+    explicit sl_node(size_type level, Args&&... args);
+
+    sl_node(const sl_node&) = delete;
+    sl_node& operator=(const sl_node&) = delete;
+
+    /// The value is destroyed by the owner, sentinels have none.
+    ~sl_node() { }
+
+    /// Number of bytes of a node with a tower of level + 1 links.
+    static constexpr size_type allocation_size(size_type level)
+    {
+        return sizeof(self_type) + (level + 1) * (sizeof(self_type*) + sizeof(size_type) + (TowerKeys ? sizeof(T) : 0));
+    }
+
+    self_type* next(size_type level) const { return tower()[level]; }
+
+    void set_next(size_type level, self_type* node)
+    {
+        tower()[level] = node;
+        if constexpr (TowerKeys) {
+            if (node != nullptr) {
+                tower_keys()[level] = node->m_value;
+            }
+        }
+    }
+
+    /// Value of the successor at the level, without loading it if the towers hold the values.
+    const value_type& next_value(size_type level) const
+    {
+        if constexpr (TowerKeys) {
+            return tower_keys()[level];
+        } else {
+            return tower()[level]->m_value;
+        }
+    }
 
-    ~sl_node();
+    size_type& span(size_type level) { return spans()[level]; }
+    size_type span(size_type level) const { return spans()[level]; }
 
-    value_type m_value;
-    size_type m_level;
+    union { value_type m_value; };
+    std::uint32_t m_level;
+    /// Allocation units from the header of the compaction slab holding the node, 0 for a block of its own.
+    std::uint32_t m_slab;
     self_type* m_prev;
-    self_type** m_next; // node_type*[m_level + 1]
+
+private:
+    // the tower is placed right after the node, sizeof(self_type) keeps it aligned
+    self_type** tower() { return reinterpret_cast<self_type**>(this + 1); }
+    self_type* const* tower() const { return reinterpret_cast<self_type* const*>(this + 1); }
+    size_type* spans() { return reinterpret_cast<size_type*>(tower() + m_level + 1); }
+    const size_type* spans() const { return reinterpret_cast<const size_type*>(tower() + m_level + 1); }
+    value_type* tower_keys() { return reinterpret_cast<value_type*>(spans() + m_level + 1); }
+    const value_type* tower_keys() const { return reinterpret_cast<const value_type*>(spans() + m_level + 1); }
 
 }; // sl_node
 
+/// Tag of the private constructors which fill a new container through its impl.
+struct sl_build_t { explicit sl_build_t() = default; };
+inline constexpr sl_build_t sl_build{};
+
+/**
+ * @brief Detects allocators which can drop all their memory at once
+ * (see pool_allocator).
+ */
+template <typename Allocator, typename = void>
+struct sl_has_release : std::false_type { };
+
+template <typename Allocator>
+struct sl_has_release<Allocator, std::void_t<decltype(std::declval<Allocator&>().release()),
+                                             decltype(std::declval<const Allocator&>().unique())>>
+    : std::true_type { };
+
+/// Promotion probability of a level generator, 1/2 unless it has a probability ratio (see level_generator).
+template <typename LevelGenerator, typename = void>
+struct sl_promotion
+{
+    static constexpr long double value = 0.5L;
+};
+
+template <typename LevelGenerator>
+struct sl_promotion<LevelGenerator, std::void_t<typename LevelGenerator::probability>>
+{
+    static constexpr long double value = static_cast<long double>(LevelGenerator::probability::num) /
+                                         static_cast<long double>(LevelGenerator::probability::den);
+};
+
+/**
+ * @brief Detects comparators which accept any type comparable with the values
+ * Only those enable the lookups by a key which is not a value_type.
+ */
+template <typename Compare, typename = void>
+struct sl_is_transparent : std::false_type { };
+
+template <typename Compare>
+struct sl_is_transparent<Compare, std::void_t<typename Compare::is_transparent>> : std::true_type { };
+
+/// Comparator counting its calls, stands for the comparator of a list collecting stats.
+template <typename Compare>
+class sl_counted_compare
+{
+public:
+    template <typename L, typename R>
+    bool operator()(const L& lhs, const R& rhs) const
+    {
+        ++m_calls;
+        return m_comp(lhs, rhs);
+    }
+
+    sl_counted_compare() = default;
+    explicit sl_counted_compare(const Compare& comp)
+        : m_comp(comp)
+    { }
+
+    const Compare& comp() const { return m_comp; }
+    Compare& comp() { return m_comp; }
+
+    std::size_t calls() const { return m_calls; }
+    void reset() { m_calls = 0; }
+
+private:
+    Compare m_comp;
+    mutable std::size_t m_calls = 0;
+
+}; // sl_counted_compare
+
 template <typename T,
           typename Compare,
-          typename Allocator>
+          typename Allocator,
+          typename LevelGenerator,
+          typename Stats>
 class sl_impl
 {
 private:
-    using self = sl_impl<T, Compare, Allocator>;
+    using self = sl_impl<T, Compare, Allocator, LevelGenerator, Stats>;
 
 public:
     // using value_type                = T;
@@ -50,29 +213,91 @@ public:
     using allocator_type              = Allocator;
     // using difference_type             = typename allocator_type::difference_type; // not sure
     using value_type                  = typename allocator_type::value_type;
-    using reference                   = typename allocator_type::reference;
-    using const_reference             = typename allocator_type::const_reference;
-    using pointer                     = typename allocator_type::pointer;
-    using const_pointer               = typename allocator_type::const_pointer;
+    using reference                   = value_type&;
+    using const_reference             = const value_type&;
+    using pointer                     = typename std::allocator_traits<allocator_type>::pointer;
+    using const_pointer               = typename std::allocator_traits<allocator_type>::const_pointer;
     using compare                     = Compare;
+    using level_generator_type        = LevelGenerator;
+    using stats_type                  = Stats;
 
     using level_type                  = std::size_t;
 
-private:
-    static inline level_type max_levels = 5; // make this a class member: = log(size)
+    /// Hard limit of the tower height, the head tower is allocated with this many links.
+    static constexpr level_type max_levels = 32;
 
 public:
-    using node_type = sl_node<T>;
+    using node_type = sl_node<T, key_in_tower<T>::value>;
 
+private:
+    /// Allocation unit of the nodes, the node block is a whole number of units.
+    using node_storage = std::aligned_storage_t<alignof(node_type), alignof(node_type)>;
+    using node_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<node_storage>;
+    using node_alloc_traits = std::allocator_traits<node_allocator>;
+
+    using less_type = std::conditional_t<Stats::enabled, sl_counted_compare<Compare>, Compare>;
+
+    static_assert(stats_snapshot::max_levels >= max_levels, "the snapshot must hold every level");
+
+    static constexpr bool nothrow_move = std::is_nothrow_move_constructible_v<less_type> &&
+                                         std::is_nothrow_move_constructible_v<level_generator_type>;
+    /// Whether a move assignment can always take the nodes of the other list.
+    static constexpr bool move_assign_steals = node_alloc_traits::propagate_on_container_move_assignment::value ||
+                                               node_alloc_traits::is_always_equal::value;
+
+public:
+    /// No allocation, the sentinels are part of the list.
     explicit sl_impl(const allocator_type& alloc = allocator_type());
+    sl_impl(const compare& comp, const allocator_type& alloc);
+    /// Copy of the nodes and the comparator of other with the same tower heights, O(n) without any comparison.
+    sl_impl(const sl_impl& other);
+    sl_impl(const sl_impl& other, const allocator_type& alloc);
+    /// Takes the nodes of other, which is left empty, O(log n) to relink them to the sentinels of this list.
+    sl_impl(sl_impl&& other) noexcept(nothrow_move);
 
     ~sl_impl();
 
-    allocator_type get_allocator() const { return m_alloc; }
+    sl_impl& operator=(const sl_impl& other);
+    /// O(log n) unless the allocators differ and do not propagate, then the values are moved one by one.
+    sl_impl& operator=(sl_impl&& other) noexcept(nothrow_move && move_assign_steals);
+    /// O(log n + log m), the allocators must be equal unless they propagate on swap.
+    void swap(sl_impl& other) noexcept;
+
+    /// Replace the contents and the comparator with copies of those of other, same tower heights, O(n).
+    void assign_copy(const sl_impl& other);
+    /**
+     * @brief assign_copy() with the copies built from args(value)
+     * args returns the constructor arguments of the copy as a tuple, e.g.
+     * for values whose parts live in storage owned by the container.
+     */
+    template <typename Args>
+    void assign_copy(const sl_impl& other, Args&& args);
+    /// Same as assign_copy() with the values moved, other is left empty.
+    void assign_move(sl_impl& other);
+
+    allocator_type get_allocator() const { return allocator_type(m_alloc); }
+    compare key_comp() const;
+    level_generator_type& get_level_generator() { return m_level_generator; }
+    const level_generator_type& get_level_generator() const { return m_level_generator; }
     size_type size() const { return m_size; }
 
-    node_type* front() { return m_head->m_next[0]; }
-    const node_type* front() const { return m_head->m_next[0]; }
+    /// Highest level currently linked from the head.
+    level_type levels() const { return m_levels; }
+
+    /// Shape of the list and the counters of the stats policy, O(n).
+    stats_snapshot stats() const;
+    void reset_stats();
+
+    /**
+     * @brief Hint the expected number of elements
+     * The tower height limit is derived from max(size(), count), so a list
+     * expected to hold count elements starts with the right height.
+     */
+    void reserve(size_type count) { m_capacity = std::max(m_capacity, count); }
+    size_type capacity() const { return m_capacity; }
+
+    node_type* front() { return m_head->next(0); }
+    const node_type* front() const { return m_head->next(0); }
 
     node_type* back() { return m_tail->m_prev; }
     const node_type* back() const { return m_tail->m_prev; }
@@ -82,50 +307,404 @@ public:
     node_type* tail() { return m_tail; }
     const node_type* tail() const { return m_tail; }
 
-    node_type* find(const_reference value);
-    const node_type* find(const_reference value) const;
+    /// The lookups take a value_type or any key the comparator accepts along with it.
+    /// The node equal to the key, the tail if there is none.
+    template <typename Key>
+    node_type* find(const Key& key);
+    template <typename Key>
+    const node_type* find(const Key& key) const;
 
-    node_type* find_first(const value_type& value);
-    const node_type* find_first(const_reference value) const;
+    /// The first node not less than the key, one comparison per node visited.
+    template <typename Key>
+    node_type* find_first(const Key& key);
+    template <typename Key>
+    const node_type* find_first(const Key& key) const;
 
-    node_type* insert(const value_type& value, node_type* hint = nullptr);
+    /// Number of searches find_first_batch() advances together.
+    static constexpr size_type batch_width = 16;
+
+    /**
+     * @brief find_first() of every key, visit(key, node) is called in the order of the keys
+     * The searches of batch_width keys take one hop each in turn and
+     * prefetch the node their next hop reads, so the cache misses of the
+     * group overlap instead of stalling every hop of a lone search.
+     */
+    template <typename ForwardIterator, typename Visit>
+    void find_first_batch(ForwardIterator first, ForwardIterator last, Visit&& visit) const;
+
+    /**
+     * @brief First node not less than the key, searched forward from the start node
+     * The search climbs the towers from the start and descends again, so it
+     * costs O(log d) for a key d elements after the start. A key before the
+     * start is searched from the head unless it belongs right before it.
+     */
+    template <typename Key>
+    node_type* find_from(node_type* start, const Key& key);
 
-    void remove(node_type* node);
+    ///@{ @name Finger
+    /// The finger is the search path of the last position searched through it,
+    /// the next search climbs only as far as needed from there: O(log d) for a
+    /// key d elements away. The hinted operations always go through it, the
+    /// others only if it is enabled, which makes the const lookups write to it.
+
+    void enable_finger(bool enabled) { m_finger_enabled = enabled; }
+    bool finger_enabled() const { return m_finger_enabled; }
+
+    ///@}
+
+    /**
+     * @brief Insert the value unless an equal one is present
+     * The value is copied or moved into the node only if it is inserted.
+     * @param near Search from the finger
+     * @param hint Node the value belongs right before, the search climbs from it
+     * @return The node of the value and whether it was inserted
+     */
+    template <typename Value>
+    std::pair<node_type*, bool> insert(Value&& value, bool near = false, node_type* hint = nullptr);
+
+    /**
+     * @brief Construct a value in a new node and link it unless an equal one is present
+     * The value has to exist before it can be compared, so a duplicate costs a node.
+     */
+    template <typename... Args>
+    std::pair<node_type*, bool> emplace(Args&&... args) { return emplace_impl(nullptr, std::forward<Args>(args)...); }
+    /// emplace() searching from the hint, see insert().
+    template <typename... Args>
+    std::pair<node_type*, bool> emplace_hint(node_type* hint, Args&&... args) { return emplace_impl(hint, std::forward<Args>(args)...); }
+
+    /**
+     * @brief Construct a value from the arguments only if no value is equal to the key
+     * The value built from the arguments must be equal to the key.
+     */
+    template <typename Key, typename... Args>
+    std::pair<node_type*, bool> try_emplace(const Key& key, Args&&... args);
+
+    /**
+     * @brief Remove the node equal to the key
+     * @return The node after the removed one, or the tail if there is no such value
+     */
+    template <typename Key>
+    node_type* remove(const Key& key);
+    /// Same as remove(key), dispose is called with the value right before the node is destroyed.
+    template <typename Key, typename Dispose>
+    node_type* remove(const Key& key, Dispose&& dispose);
+    /**
+     * @brief Remove the node
+     * @return The node after the removed one
+     */
+    node_type* remove(node_type* node);
+    /// Remove the first node without a search, O(levels): the head precedes it at every level.
+    void remove_front();
     void remove_all();
 
+    /**
+     * @brief Insert a range, appending in O(1) every value greater than the last one
+     * Sorted input is linked in a single left-to-right pass, values out of
+     * order fall back to the regular insert.
+     */
+    template <typename InputIterator>
+    void insert_range(InputIterator first, InputIterator last);
+
+    /**
+     * @brief Append a strictly increasing range greater than all present values
+     * No comparisons are made, the order is only checked by assertions.
+     */
+    template <typename InputIterator>
+    void append_sorted(InputIterator first, InputIterator last);
+
+    ///@{ @name Parallel
+    /// threads = 0 picks the count with sl_thread_count().
+
+    /**
+     * @brief Replace the contents with a sorted random access range, linked by several threads
+     * Only the first of equal values is kept. Every thread links a segment
+     * into a list of its own with the tower heights of the whole size, the
+     * segments are joined at the end in O(threads log n). The threads
+     * allocate at once, so a list with a pool allocator is built by one.
+     */
+    template <typename RandomIt>
+    void assign_sorted_parallel(RandomIt first, RandomIt last, size_type threads);
+
+    /**
+     * @brief Call fn with every value in [lo, hi), from several threads
+     * The range is cut at evenly spaced ranks, found through the spans in
+     * O(log n) each, and every thread walks its part in order.
+     */
+    template <typename Key, typename Fn>
+    void for_each_parallel(const Key& lo, const Key& hi, Fn& fn, size_type threads) const;
+
+    ///@}
+
+    ///@{ @name Compaction
+    /// The nodes are reallocated in key order into slabs, blocks of up to
+    /// compact_slab_size nodes. A slab is freed with the last of its nodes,
+    /// the room of the ones erased before is given back by compacting again.
+
+    static constexpr size_type compact_slab_size = size_type(1) << 16;
+
+    /**
+     * @brief Relocate the next count nodes of the current pass, O(count + log n)
+     * The pass goes on from the rank where the previous step stopped, the
+     * list may change in between.
+     * @param rebalance Give the nodes the ideal tower heights of their ranks instead of their own
+     * @return Whether the pass reached the end, the next step starts another one from the front
+     */
+    bool compact_step(size_type count, bool rebalance);
+    /// A whole pass from the front, O(n).
+    void compact(bool rebalance);
+
+    ///@}
+
+    ///@{ @name Set operations
+
+    /**
+     * @brief Move in the nodes of other which have no equal value here
+     * Both lists are relinked in one pass, O(n + m) without any allocation.
+     * A much smaller other is linked in node by node through the finger
+     * instead, O(m log(n / m)). With unequal allocators the values are moved.
+     */
+    void merge(sl_impl& other);
+
+    /// Replace the contents with the result of the operation, O(n + m), or
+    /// O(m log(n / m)) when one side is much smaller and the output can be too.
+    void assign_union(const sl_impl& lhs, const sl_impl& rhs);
+    void assign_intersection(const sl_impl& lhs, const sl_impl& rhs);
+    void assign_difference(const sl_impl& lhs, const sl_impl& rhs);
+
+    ///@}
+
+    ///@{ @name Splicing, the nodes change lists without being reallocated
+    /// The lists must have equal allocators.
+
+    /// Move the nodes not less than the key to the empty rest, O(log n).
+    template <typename Key>
+    void split(const Key& key, sl_impl& rest);
+    /**
+     * @brief Append the nodes of other, which must all be greater, O(log n + log m)
+     * With unequal allocators the values are moved instead, O(m).
+     */
+    void join(sl_impl& other);
+    /// Move [first, last) to the empty out, O(log n).
+    void extract(node_type* first, node_type* last, sl_impl& out);
+    /**
+     * @brief Unlink [first, last) and destroy it, O(log n + k)
+     * @return last
+     */
+    node_type* remove_range(node_type* first, node_type* last);
+
+    ///@}
+
+    ///@{ @name Ranks, the head has rank 0, the elements 1..size() and the tail size() + 1
+
+    /// The node of the rank, the tail if it is greater than size().
+    node_type* at(size_type rank);
+    const node_type* at(size_type rank) const;
+    size_type rank(const node_type* node) const;
+    /// The number of elements less than the key.
+    template <typename Key>
+    size_type count_less(const Key& key) const;
+
+    ///@}
+
     void dump() const;
     void pretty_dump() const;
 
 public:
-    bool is_less(const_reference lhs, const_reference rhs) const { return m_less(lhs, rhs); }
-    bool is_great(const_reference lhs, const_reference rhs) const { return m_less(rhs, lhs); }
-    bool is_less_or_equal(const_reference lhs, const_reference rhs) const { return !m_less(rhs, lhs); }
-    bool is_great_or_equal(const_reference lhs, const_reference rhs) const { return !m_less(lhs, rhs); }
-    bool is_equal(const_reference lhs, const_reference rhs) const { return !(m_less(lhs, rhs) || m_less(rhs, lhs)); }
+    template <typename L, typename R>
+    bool is_less(const L& lhs, const R& rhs) const { return m_less(lhs, rhs); }
+    template <typename L, typename R>
+    bool is_great(const L& lhs, const R& rhs) const { return m_less(rhs, lhs); }
+    template <typename L, typename R>
+    bool is_less_or_equal(const L& lhs, const R& rhs) const { return !m_less(rhs, lhs); }
+    template <typename L, typename R>
+    bool is_great_or_equal(const L& lhs, const R& rhs) const { return !m_less(lhs, rhs); }
+    template <typename L, typename R>
+    bool is_equal(const L& lhs, const R& rhs) const { return !(m_less(lhs, rhs) || m_less(rhs, lhs)); }
 
 private:
+    static constexpr size_type storage_count(level_type level)
+    {
+        return (node_type::allocation_size(level) + sizeof(node_storage) - 1) / sizeof(node_storage);
+    }
+
+    /// The head has a link on every level, the tail none but the one it is given.
+    static constexpr size_type head_storage = (node_type::allocation_size(max_levels - 1) + sizeof(node_storage) - 1) / sizeof(node_storage);
+    static constexpr size_type tail_storage = (node_type::allocation_size(0) + sizeof(node_storage) - 1) / sizeof(node_storage);
 
-    bool toss_a_coin() const
+    /// The last node before a position at every level, with its rank.
+    struct path_type
     {
-        return rand() % 2 == 0;
+        node_type* m_node[max_levels];
+        size_type m_rank[max_levels];
+    };
+
+    /**
+     * @brief Single descent recording the last node before the value at every level
+     * @return The first node not less than the value
+     */
+    template <typename Key>
+    node_type* find_predecessors(const Key& key, path_type& path);
+    /// Link a node built for the position found by find_predecessors().
+    node_type* link_new(node_type* node, path_type& path);
+
+    /// First node not less than the key, the path to it is left in the finger.
+    template <typename Key>
+    node_type* find_near(const Key& key);
+    /// Bring the levels of the finger from the bottom one up to the key, the lower ones are left as they were.
+    template <typename Key>
+    void move_finger(const Key& key, level_type bottom);
+    /**
+     * @brief find_near() climbing from the node before the hint when the finger is away from the key
+     * Only the levels above the climb come from the finger, or from the head
+     * if it is not valid. O(log d) for a key d elements from the hint or the
+     * finger, whichever is nearer.
+     */
+    template <typename Key>
+    node_type* find_hinted(node_type* hint, const Key& key);
+    /**
+     * @brief Search with the hint or the finger if asked or enabled, otherwise with a fresh path from the head
+     * A hinted search always leaves its path in the finger.
+     */
+    template <typename Key>
+    node_type* locate(const Key& key, path_type*& path, path_type& local, bool near, node_type* hint = nullptr);
+
+    /// A null hint searches from the finger only if it is enabled.
+    template <typename... Args>
+    std::pair<node_type*, bool> emplace_impl(node_type* hint, Args&&... args);
+    /// Predecessors of a linked node at every level, without ranks.
+    void collect_predecessors(const node_type* node, path_type& path);
+    void link(node_type* node, path_type& path);
+    node_type* unlink(node_type* node, path_type& path);
+    /// Last node of every level, reached by walking to the tail without comparisons.
+    void collect_last(path_type& last);
+    /// Link a node after all the others, last is updated to include it.
+    void link_back(node_type* node, path_type& last);
+    /// Fix the spans to the tail after a series of link_back().
+    void close_back(path_type& last);
+    /// Append a sorted range, skipping the values not greater than the last one.
+    template <typename InputIterator>
+    void append_unique(InputIterator first, InputIterator last);
+    /// Empty the list without freeing the nodes, they stay chained at level 0 up to the tail.
+    node_type* detach_all();
+    /// Move the nodes from the position of the path on to the empty rest.
+    void cut(path_type& path, sl_impl& rest);
+
+    /// Whether searching count times in a list of size beats walking it.
+    static bool gallops(size_type count, size_type size)
+    {
+        level_type depth = 1;
+        for (size_type rest = size; rest > 1; rest >>= 1) {
+            ++depth;
+        }
+        return count * depth < size;
     }
 
-    level_type random_level() const
+    template <typename... Args>
+    node_type* create_node(level_type level, Args&&... args);
+    void destroy_node(node_type* node);
+    /// Free the block of a node whose value is destroyed.
+    void deallocate_node(node_type* node);
+
+    /// First units of a compaction slab, the nodes follow.
+    struct slab_header
+    {
+        explicit slab_header(size_type units)
+            : m_live(0)
+            , m_units(units)
+        { }
+
+        /// Atomic as the nodes of a slab may be split between lists owned by different threads.
+        std::atomic<size_type> m_live;
+        size_type m_units;
+    };
+
+    static constexpr size_type slab_header_units = (sizeof(slab_header) + sizeof(node_storage) - 1) / sizeof(node_storage);
+    /// The offsets of the nodes in their slab must fit in sl_node::m_slab.
+    static constexpr size_type max_slab_units = UINT32_MAX;
+
+    /// Last node before the rank at every level.
+    node_type* find_rank_predecessors(size_type rank, path_type& path);
+    /**
+     * @brief Move the values of count nodes from node on into new nodes of one slab of units
+     * The path leads to node, which has the rank, and is kept up to date.
+     * @return The node after the relocated ones
+     */
+    node_type* relocate(node_type* node, size_type count, size_type units, size_type rank, level_type limit,
+                        bool rebalance, path_type& path);
+    /// Level of the rank in a list where every node of rank r * (1 / p)^L reaches level L, up to limit.
+    static level_type ideal_level(size_type rank, level_type limit);
+
+    /// Build the head and the tail in the storage of the list and link them.
+    void create_sentinels() noexcept;
+    /**
+     * @brief Exchange the nodes, sizes and stats with other, each list keeps its sentinels
+     * Only the first and the last link of every level and the ends of level 0
+     * change, O(log n + log m).
+     */
+    void swap_nodes(sl_impl& other) noexcept;
+    /// Link copies of the nodes of other, or the moved values, with the same tower heights.
+    template <typename Other>
+    void clone(Other& other);
+    /// clone() with the values built from the tuple of arguments args(value).
+    template <typename Other, typename Args>
+    void clone(Other& other, Args&& args);
+    void copy_compare(const sl_impl& other);
+
+    /**
+     * @brief Whether the nodes can be freed by releasing the arena of the allocator
+     * Only if no one else uses the arena and no destructor has to run.
+     */
+    bool releases_arena() const
     {
-        level_type level = 1;
-        while (level < max_levels && toss_a_coin()) {
-            ++level;
+        if constexpr (std::is_trivially_destructible_v<value_type> && sl_has_release<node_allocator>::value) {
+            return m_alloc.unique();
+        } else {
+            return false;
+        }
+    }
+
+    /**
+     * @brief The highest level a new node may get: log2(max(size + 1, capacity))
+     * Grows with the number of elements, so searches stay O(log n) at any size.
+     */
+    level_type level_limit() const
+    {
+        size_type count = std::max(m_size + 1, m_capacity);
+        level_type limit = 0;
+        while ((count >>= 1) != 0) {
+            ++limit;
+        }
+        return std::min(limit, max_levels - 1);
+    }
+
+    level_type random_level() { return m_level_generator(level_limit()); }
+
+    /// Lower m_levels while the top levels of the head are empty.
+    void shrink_levels()
+    {
+        while (m_levels > 0 && m_head->next(m_levels) == m_tail) {
+            --m_levels;
         }
-        return level;
     }
 
 private:
-    allocator_type m_alloc;
+    node_allocator m_alloc;
     level_type m_levels;
     size_type m_size;
+    size_type m_capacity;
+    size_type m_compact_rank; ///< Where the current compaction pass goes on, 0 between passes
     node_type* m_head;
     node_type* m_tail;
-    compare m_less;
+    less_type m_less;
+    level_generator_type m_level_generator;
+    path_type m_finger;
+    bool m_finger_valid; ///< Cleared by any change made with another path
+    bool m_finger_enabled;
+    // after the flags, an empty policy then fits in their padding
+    mutable stats_type m_stats; ///< Lookups on a const list are counted too
+    /// The sentinels live as long as the list, so an end() stays the end whatever the list goes through.
+    node_storage m_head_storage[head_storage];
+    node_storage m_tail_storage[tail_storage];
 
 }; // sl_impl
 
@@ -146,19 +725,23 @@ private:
     using self_type = sl_iterator<SkipList>;
 
 public:
+    sl_iterator()
+        : m_node(nullptr)
+    { }
+
     explicit sl_iterator(node_type* node)
         : m_node(node)
     { }
 
     self_type& operator++()
     {
-        m_node = m_node->m_next[0];
+        m_node = m_node->next(0);
         return *this;
     }
     self_type operator++(int)
     {
         self_type tmp(*this);
-        m_node = m_node->m_next[0];
+        m_node = m_node->next(0);
         return tmp;
     }
 
@@ -174,8 +757,8 @@ public:
         return tmp;
     }
 
-    reference operator*()  { return m_node->m_value; }
-    pointer   operator->() { return m_node->m_value; }
+    reference operator*() const  { return m_node->m_value; }
+    pointer   operator->() const { return &m_node->m_value; }
 
     bool operator==(const self_type& other) const { return m_node == other.m_node; }
     bool operator!=(const self_type& other) const { return !operator==(other); }
@@ -199,33 +782,37 @@ public:
     using iterator_category = std::bidirectional_iterator_tag;
     using value_type = typename SkipList::value_type;
     using difference_type = std::ptrdiff_t;
-    using pointer = typename SkipList::pointer;
+    using pointer = typename SkipList::const_pointer;
     using const_pointer = typename SkipList::const_pointer;
-    using reference = typename SkipList::reference;
+    using reference = typename SkipList::const_reference;
     using const_reference = typename SkipList::const_reference;
 
 private:
-    using node_type = typename SkipList::node_type;
+    using node_type = const typename SkipList::node_type;
     using self_type = sl_const_iterator<SkipList>;
 
 public:
+    sl_const_iterator()
+        : m_node(nullptr)
+    { }
+
     explicit sl_const_iterator(node_type* node)
         : m_node(node)
     { }
 
-    sl_const_iterator(sl_iterator<SkipList>& it)
+    sl_const_iterator(const sl_iterator<SkipList>& it)
         : m_node(it.get_node())
     { }
 
     self_type& operator++()
     {
-        m_node = m_node->m_next[0];
+        m_node = m_node->next(0);
         return *this;
     }
     self_type operator++(int)
     {
         self_type tmp(*this);
-        m_node = m_node->m_next[0];
+        m_node = m_node->next(0);
         return tmp;
     }
 
@@ -241,8 +828,8 @@ public:
         return tmp;
     }
 
-    const_reference operator*()  { return m_node->m_value; }
-    const_pointer   operator->() { return m_node->m_value; }
+    const_reference operator*() const  { return m_node->m_value; }
+    const_pointer   operator->() const { return &m_node->m_value; }
 
     bool operator==(const self_type& other) const { return m_node == other.m_node; }
     bool operator!=(const self_type& other) const { return !operator==(other); }
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "sl_impl.hpp"
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+/// Mapped values up to this size are kept in the node, bigger ones out of line.
+template <typename Mapped>
+inline constexpr bool sl_map_inline = sizeof(Mapped) <= sizeof(void*);
+
+/**
+ * @brief Value of a skip_map node
+ * The key comes first so a search only touches the key, the node header and
+ * the tower. A mapped value too big to share the node is kept behind a
+ * pointer, the map owns that storage.
+ *
+ * The mapped value is produced by a callable, so it is only built once the
+ * node is known to be needed: a Mapped for inline values, a Mapped* already
+ * constructed out of line otherwise.
+ */
+template <typename Key, typename Mapped, bool Inline = sl_map_inline<Mapped>>
+class sl_map_entry
+{
+public:
+    template <typename K, typename Make>
+    sl_map_entry(K&& key, Make&& make)
+        : m_key(std::forward<K>(key))
+        , m_mapped(make())
+    { }
+
+    const Key& key() const { return m_key; }
+    Mapped& mapped() { return m_mapped; }
+    const Mapped& mapped() const { return m_mapped; }
+
+private:
+    Key m_key;
+    Mapped m_mapped;
+
+}; // sl_map_entry
+
+template <typename Key, typename Mapped>
+class sl_map_entry<Key, Mapped, false>
+{
+public:
+    template <typename K, typename Make>
+    sl_map_entry(K&& key, Make&& make)
+        : m_key(std::forward<K>(key))
+        , m_mapped(make())
+    { }
+
+    const Key& key() const { return m_key; }
+    Mapped& mapped() { return *m_mapped; }
+    const Mapped& mapped() const { return *m_mapped; }
+    Mapped* storage() const { return m_mapped; }
+
+private:
+    Key m_key;
+    Mapped* m_mapped;
+
+}; // sl_map_entry
+
+/**
+ * @brief Orders the entries by their keys with the comparator of the map
+ * Transparent so the impl can be searched by a bare key.
+ */
+template <typename Compare>
+class sl_map_compare
+{
+public:
+    using is_transparent = void;
+
+    sl_map_compare() = default;
+    explicit sl_map_compare(const Compare& comp)
+        : m_comp(comp)
+    { }
+
+    template <typename L, typename R>
+    bool operator()(const L& lhs, const R& rhs) const { return m_comp(key_of(lhs), key_of(rhs)); }
+
+    const Compare& key_comp() const { return m_comp; }
+
+private:
+    template <typename K, typename M, bool I>
+    static const K& key_of(const sl_map_entry<K, M, I>& entry) { return entry.key(); }
+    template <typename K>
+    static const K& key_of(const K& key) { return key; }
+
+private:
+    Compare m_comp;
+
+}; // sl_map_compare
+
+/**
+ * @brief Fixed-size slots for the out of line mapped values
+ * Slots are carved from chunks of chunk_slots and recycled through a free
+ * list, so the cold values are packed together instead of being spread over
+ * the heap. The slab never constructs or destroys values.
+ */
+template <typename T, typename Allocator>
+class sl_slab
+{
+public:
+    using size_type = std::size_t;
+
+    static constexpr size_type chunk_slots = 64;
+
+    explicit sl_slab(const Allocator& alloc);
+    /// Takes the chunks of other, which is left without any.
+    sl_slab(sl_slab&& other) noexcept;
+
+    sl_slab(const sl_slab&) = delete;
+    sl_slab& operator=(const sl_slab&) = delete;
+
+    /// The chunks change hands with the allocator they came from.
+    void swap(sl_slab& other) noexcept;
+
+    ~sl_slab();
+
+    /// Uninitialized storage for one T.
+    T* allocate();
+    void deallocate(T* ptr);
+
+    /// Free every chunk, the values must have been destroyed.
+    void release();
+
+private:
+    union slot
+    {
+        slot* m_next;
+        std::aligned_storage_t<sizeof(T), alignof(T)> m_storage;
+    };
+
+    using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+    using slot_alloc_traits = std::allocator_traits<slot_allocator>;
+
+private:
+    slot_allocator m_alloc;
+    slot* m_free;
+    slot* m_chunks; // the first slot of a chunk links the chunks
+
+}; // sl_slab
+
+/**
+ * @brief skip_map iterator
+ * The key and the mapped value are not stored as a pair, so the iterator
+ * yields a pair of references.
+ */
+template <typename Node, typename Key, typename Mapped, bool Const>
+class sl_map_iterator
+{
+    template <typename N, typename K, typename M, bool C> friend class sl_map_iterator;
+
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<const Key, Mapped>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const Key&, std::conditional_t<Const, const Mapped&, Mapped&>>;
+
+    /// operator-> has to return something holding the pair of references.
+    class pointer
+    {
+    public:
+        explicit pointer(const reference& ref)
+            : m_ref(ref)
+        { }
+        const reference* operator->() const { return &m_ref; }
+
+    private:
+        reference m_ref;
+    };
+
+private:
+    using self_type = sl_map_iterator<Node, Key, Mapped, Const>;
+
+public:
+    sl_map_iterator()
+        : m_node(nullptr)
+    { }
+
+    explicit sl_map_iterator(Node* node)
+        : m_node(node)
+    { }
+
+    template <bool C, typename = std::enable_if_t<Const && !C>>
+    sl_map_iterator(const sl_map_iterator<Node, Key, Mapped, C>& other)
+        : m_node(other.m_node)
+    { }
+
+    self_type& operator++()
+    {
+        m_node = m_node->next(0);
+        return *this;
+    }
+    self_type operator++(int)
+    {
+        self_type tmp(*this);
+        m_node = m_node->next(0);
+        return tmp;
+    }
+    self_type& operator--()
+    {
+        m_node = m_node->m_prev;
+        return *this;
+    }
+    self_type operator--(int)
+    {
+        self_type tmp(*this);
+        m_node = m_node->m_prev;
+        return tmp;
+    }
+
+    reference operator*() const { return reference(m_node->m_value.key(), m_node->m_value.mapped()); }
+    pointer operator->() const { return pointer(**this); }
+
+    bool operator==(const self_type& other) const { return m_node == other.m_node; }
+    bool operator!=(const self_type& other) const { return m_node != other.m_node; }
+
+    Node* get_node() const { return m_node; }
+
+private:
+    Node* m_node;
+
+}; // sl_map_iterator
+
+} // namespace internal
+
+} // namespace skip_list
+
+#include "_sl_map.hpp"
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+/// Below this many elements per thread, starting the thread costs more than it saves.
+inline constexpr std::size_t sl_parallel_grain = std::size_t(1) << 14;
+
+/**
+ * @brief Number of threads to use for work elements
+ * A requested count of zero means one per hardware thread, as long as each
+ * gets sl_parallel_grain elements. A requested count is only capped by the work.
+ */
+std::size_t sl_thread_count(std::size_t requested, std::size_t work);
+
+/**
+ * @brief Run task(i) for every i in [0, count), each on its own thread
+ * The calling thread runs the last one and waits for the others. The first
+ * exception thrown by a task is rethrown once they are all done.
+ */
+template <typename Task>
+void sl_run_parallel(std::size_t count, Task&& task);
+
+/// std::stable_sort with the range cut in threads chunks sorted at once, then merged pairwise.
+template <typename RandomIt, typename Less>
+void sl_parallel_sort(RandomIt first, RandomIt last, Less less, std::size_t threads);
+
+} // namespace internal
+
+} // namespace skip_list
+
+#include "_sl_parallel.hpp"
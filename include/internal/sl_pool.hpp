@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+/**
+ * @brief Arena with per-size free lists
+ * Memory is carved from large chunks. Freed blocks are kept in a free list
+ * of their size class and reused before the arena grows, so the nodes of
+ * every tower height are recycled without touching the system allocator.
+ * All the memory is returned at once by release() or on destruction.
+ */
+class sl_pool
+{
+public:
+    using size_type = std::size_t;
+
+    /// Alignment and size granularity of the blocks.
+    static constexpr size_type granule = alignof(std::max_align_t);
+    static constexpr size_type default_chunk_size = 64 * 1024;
+
+    explicit sl_pool(size_type chunk_size = default_chunk_size);
+
+    sl_pool(const sl_pool&) = delete;
+    sl_pool& operator=(const sl_pool&) = delete;
+
+    ~sl_pool();
+
+    void* allocate(size_type bytes);
+    void deallocate(void* ptr, size_type bytes);
+
+    /// Drop every block, all the memory given out becomes invalid.
+    void release();
+
+    /// Bytes reserved from the system allocator.
+    size_type reserved() const { return m_reserved; }
+    size_type chunk_size() const { return m_chunk_size; }
+
+private:
+    struct free_block
+    {
+        free_block* m_next;
+    };
+
+    struct chunk
+    {
+        chunk* m_next;
+        size_type m_size;
+    };
+
+    static size_type size_class(size_type bytes) { return (bytes + granule - 1) / granule; }
+    static size_type header_size() { return size_class(sizeof(chunk)) * granule; }
+
+    void* allocate_chunk(size_type bytes);
+
+private:
+    size_type m_chunk_size;
+    size_type m_reserved;
+    std::vector<free_block*> m_free; // indexed by size class
+    chunk* m_chunks;
+    char* m_cursor;
+    char* m_end;
+
+}; // sl_pool
+
+} // namespace internal
+
+} // namespace skip_list
+
+#include "_sl_pool.hpp"
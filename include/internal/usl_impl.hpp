@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace skip_list
+{
+
+namespace internal
+{
+
+/**
+ * @brief Whether blocks of T ordered by Compare are searched with SIMD compares
+ * Only 32 and 64 bit integers in their natural order qualify.
+ */
+template <typename T, typename Compare>
+inline constexpr bool usl_simd_searchable =
+    std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8) &&
+    (std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::less<>>);
+
+inline unsigned usl_popcount(unsigned bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcount(bits));
+#else
+    unsigned count = 0;
+    for (; bits != 0; bits &= bits - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Number of keys less than the key among a whole block
+ * The block is compared entirely, branch free, unused slots must hold the
+ * maximum of T. Unsigned keys are compared as signed with the sign bit flipped.
+ */
+template <typename T, std::size_t Count>
+std::size_t usl_count_less(const T* keys, T key)
+{
+    std::size_t count = 0;
+#if defined(__AVX2__)
+    if constexpr (sizeof(T) == 4) {
+        static_assert(Count % 8 == 0, "the block is searched 8 keys at a time");
+        const __m256i bias = _mm256_set1_epi32(std::is_signed_v<T> ? 0 : std::numeric_limits<std::int32_t>::min());
+        const __m256i needle = _mm256_xor_si256(_mm256_set1_epi32(static_cast<std::int32_t>(key)), bias);
+        for (std::size_t i = 0; i < Count; i += 8) {
+            const __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), bias);
+            const __m256i less = _mm256_cmpgt_epi32(needle, block);
+            count += usl_popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(less))));
+        }
+        return count;
+    } else {
+        static_assert(Count % 4 == 0, "the block is searched 4 keys at a time");
+        const __m256i bias = _mm256_set1_epi64x(std::is_signed_v<T> ? 0 : std::numeric_limits<std::int64_t>::min());
+        const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<std::int64_t>(key)), bias);
+        for (std::size_t i = 0; i < Count; i += 4) {
+            const __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), bias);
+            const __m256i less = _mm256_cmpgt_epi64(needle, block);
+            count += usl_popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(less))));
+        }
+        return count;
+    }
+#elif defined(__SSE2__)
+    if constexpr (sizeof(T) == 4) {
+        static_assert(Count % 4 == 0, "the block is searched 4 keys at a time");
+        const __m128i bias = _mm_set1_epi32(std::is_signed_v<T> ? 0 : std::numeric_limits<std::int32_t>::min());
+        const __m128i needle = _mm_xor_si128(_mm_set1_epi32(static_cast<std::int32_t>(key)), bias);
+        for (std::size_t i = 0; i < Count; i += 4) {
+            const __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), bias);
+            const __m128i less = _mm_cmpgt_epi32(needle, block);
+            count += usl_popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(less))));
+        }
+        return count;
+    }
+#if defined(__SSE4_2__)
+    if constexpr (sizeof(T) == 8) {
+        static_assert(Count % 2 == 0, "the block is searched 2 keys at a time");
+        const __m128i bias = _mm_set1_epi64x(std::is_signed_v<T> ? 0 : std::numeric_limits<std::int64_t>::min());
+        const __m128i needle = _mm_xor_si128(_mm_set1_epi64x(static_cast<std::int64_t>(key)), bias);
+        for (std::size_t i = 0; i < Count; i += 2) {
+            const __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), bias);
+            const __m128i less = _mm_cmpgt_epi64(needle, block);
+            count += usl_popcount(static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(less))));
+        }
+        return count;
+    }
+#endif
+#endif
+    for (std::size_t i = 0; i < Count; ++i) {
+        count += (keys[i] < key) ? 1 : 0;
+    }
+    return count;
+}
+
+/**
+ * @brief Unrolled skip list node
+ * Holds a sorted block of up to Capacity keys and is routed by its first
+ * one. Like sl_node the tower of next pointers follows the node in the
+ * same allocation.
+ */
+template <typename T, std::size_t Capacity>
+class usl_node
+{
+public:
+    using value_type                = T;
+    using size_type                 = std::size_t;
+    using self_type = usl_node<T, Capacity>;
+
+    static constexpr size_type capacity = Capacity;
+
+    explicit usl_node(size_type level)
+        : m_keys()
+        , m_count(0)
+        , m_level(level)
+        , m_prev(nullptr)
+    {
+        for (size_type i = 0; i <= level; ++i) {
+            next(i) = nullptr;
+        }
+    }
+
+    usl_node(const usl_node&) = delete;
+    usl_node& operator=(const usl_node&) = delete;
+
+    static constexpr size_type allocation_size(size_type level)
+    {
+        return sizeof(self_type) + (level + 1) * sizeof(self_type*);
+    }
+
+    self_type*& next(size_type level) { return tower()[level]; }
+    self_type* next(size_type level) const { return tower()[level]; }
+
+    const value_type& min() const { return m_keys[0]; }
+
+    value_type m_keys[Capacity];
+    size_type m_count;
+    size_type m_level;
+    self_type* m_prev;
+
+private:
+    self_type** tower() { return reinterpret_cast<self_type**>(this + 1); }
+    self_type* const* tower() const { return reinterpret_cast<self_type* const*>(this + 1); }
+
+}; // usl_node
+
+template <typename T,
+          typename Compare,
+          typename Allocator,
+          typename LevelGenerator,
+          std::size_t BlockSize>
+class usl_impl
+{
+public:
+    using size_type                   = std::size_t;
+    using allocator_type              = Allocator;
+    using value_type                  = typename allocator_type::value_type;
+    using reference                   = value_type&;
+    using const_reference             = const value_type&;
+    using pointer                     = typename std::allocator_traits<allocator_type>::pointer;
+    using const_pointer               = typename std::allocator_traits<allocator_type>::const_pointer;
+    using compare                     = Compare;
+    using level_generator_type        = LevelGenerator;
+
+    using level_type                  = std::size_t;
+    using node_type                   = usl_node<T, BlockSize>;
+    /// An element: its node and its index in the block.
+    using position_type               = std::pair<node_type*, size_type>;
+
+    static constexpr level_type max_levels = 32;
+    static constexpr bool simd_search = usl_simd_searchable<T, Compare>;
+
+    static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+                  "the keys are shifted inside the blocks as raw values");
+    static_assert(BlockSize >= 4 && BlockSize % 8 == 0, "the block size must be a multiple of 8");
+
+private:
+    using node_storage = std::aligned_storage_t<alignof(node_type), alignof(node_type)>;
+    using node_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<node_storage>;
+    using node_alloc_traits = std::allocator_traits<node_allocator>;
+
+    /// Whether a move assignment always takes the blocks over, without any allocation.
+    static constexpr bool move_assign_steals =
+        node_alloc_traits::propagate_on_container_move_assignment::value || node_alloc_traits::is_always_equal::value;
+
+    struct path_type
+    {
+        node_type* m_node[max_levels];
+    };
+
+public:
+    explicit usl_impl(const allocator_type& alloc = allocator_type());
+    usl_impl(const usl_impl& other);
+    /// Copy of the blocks of other, made with the allocator.
+    usl_impl(const usl_impl& other, const allocator_type& alloc);
+    /// Takes the blocks over, other is left empty with its own sentinels.
+    usl_impl(usl_impl&& other) noexcept;
+
+    /// A copy built aside and swapped in, the list is left as it was if the copy throws.
+    usl_impl& operator=(const usl_impl& other);
+    /// Takes the blocks over, unless the allocators differ and do not propagate: the keys are copied then.
+    usl_impl& operator=(usl_impl&& other) noexcept(move_assign_steals);
+    /// The allocators must be equal unless they propagate on swap.
+    void swap(usl_impl& other) noexcept;
+
+    ~usl_impl();
+
+    allocator_type get_allocator() const { return allocator_type(m_alloc); }
+    level_generator_type& get_level_generator() { return m_level_generator; }
+    size_type size() const { return m_size; }
+    /// Number of blocks.
+    size_type nodes() const { return m_nodes; }
+
+    node_type* front() const { return m_head->next(0); }
+    node_type* back() const { return m_tail->m_prev; }
+    node_type* tail() const { return m_tail; }
+
+    /// First element not less than the key, (tail, 0) if there is none.
+    position_type lower_bound(const_reference key) const;
+    /// The element equal to the key, (tail, 0) if there is none.
+    position_type find(const_reference key) const;
+
+    /**
+     * @brief Insert the key unless it is present
+     * A full block is split in two halves first.
+     */
+    std::pair<position_type, bool> insert(const_reference key);
+    /**
+     * @brief Erase the key if present
+     * A block left with less than half a block of keys takes keys from a
+     * neighbour, the next one or else the previous one, or takes it in whole
+     * if both fit in a block. Every block but a lone one keeps B / 2 keys.
+     */
+    bool erase(const_reference key);
+    /// Erase the element at the position, @return the position of the next one.
+    position_type erase(position_type pos);
+    void remove_all();
+
+    bool is_less(const_reference lhs, const_reference rhs) const { return m_less(lhs, rhs); }
+
+private:
+    /// Index of the first key of the block not less than the key.
+    size_type block_lower_bound(const node_type* node, const_reference key) const
+    {
+        if constexpr (simd_search) {
+            return usl_count_less<T, BlockSize>(node->m_keys, key);
+        } else {
+            return static_cast<size_type>(std::lower_bound(node->m_keys, node->m_keys + node->m_count, key, m_less) - node->m_keys);
+        }
+    }
+
+    /// Last node of every level whose first key is less than the key.
+    node_type* find_predecessors(const_reference key, path_type& path);
+    /// The position of the key at the index of the node, the first key of the next block past its end.
+    position_type normalize(node_type* node, size_type index) const
+    {
+        return index < node->m_count ? position_type(node, index) : position_type(node->next(0), 0);
+    }
+
+    /**
+     * @brief Exchange everything but the allocators and the sentinels
+     * The first and the last block of every level are relinked to the
+     * sentinels of the other list, O(log n + log m).
+     */
+    void swap_contents(usl_impl& other) noexcept;
+    void create_sentinels() noexcept;
+    node_type* create_node(level_type level);
+    void destroy_node(node_type* node);
+    void link(node_type* node, const path_type& path);
+    void unlink(node_type* node, const path_type& path);
+    /// Move the upper half of the full node to a new node right after it.
+    void split(node_type* node, const path_type& path);
+    /// Erase the key at the index of the node, path leads to the node. @return The position of the next key
+    position_type remove(node_type* node, size_type index, path_type& path);
+    /**
+     * @brief Bring a block under half a block back to B / 2 keys with a neighbour, path leads to the block
+     * @return Where the key at the index of the block went, normalized
+     */
+    position_type refill(node_type* node, size_type index, path_type& path);
+    /// Move the first count keys of right to the end of left.
+    void shift_left(node_type* left, node_type* right, size_type count);
+    /// Move the last count keys of left to the front of right.
+    void shift_right(node_type* left, node_type* right, size_type count);
+    void insert_at(node_type* node, size_type index, const_reference key);
+    void erase_at(node_type* node, size_type index);
+
+    static constexpr size_type storage_count(level_type level)
+    {
+        return (node_type::allocation_size(level) + sizeof(node_storage) - 1) / sizeof(node_storage);
+    }
+
+    /// The head links every level, the tail none.
+    static constexpr size_type head_storage = (node_type::allocation_size(max_levels - 1) + sizeof(node_storage) - 1) / sizeof(node_storage);
+    static constexpr size_type tail_storage = (node_type::allocation_size(0) + sizeof(node_storage) - 1) / sizeof(node_storage);
+
+    /// log2 of the number of blocks, as sl_impl does with the number of elements.
+    level_type level_limit() const
+    {
+        size_type count = m_nodes + 1;
+        level_type limit = 0;
+        while ((count >>= 1) != 0) {
+            ++limit;
+        }
+        return std::min(limit, max_levels - 1);
+    }
+
+    level_type random_level() { return m_level_generator(level_limit()); }
+
+    /// Lower m_levels while the top levels of the head are empty.
+    void shrink_levels()
+    {
+        while (m_levels > 0 && m_head->next(m_levels) == m_tail) {
+            --m_levels;
+        }
+    }
+
+private:
+    node_allocator m_alloc;
+    level_type m_levels;
+    size_type m_size;
+    size_type m_nodes;
+    node_type* m_head;
+    node_type* m_tail;
+    compare m_less;
+    level_generator_type m_level_generator;
+    /// The sentinels are part of the list, an empty list, a move and a swap allocate nothing.
+    node_storage m_head_storage[head_storage];
+    node_storage m_tail_storage[tail_storage];
+
+}; // usl_impl
+
+/// Element of an unrolled skip list: a node and an index in its block.
+template <typename UnrolledList, bool Const>
+class usl_iterator
+{
+    template <typename L, bool C> friend class usl_iterator;
+
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = typename UnrolledList::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+    using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+private:
+    using node_type = typename UnrolledList::node_type;
+    using self_type = usl_iterator<UnrolledList, Const>;
+
+public:
+    usl_iterator()
+        : m_node(nullptr)
+        , m_index(0)
+    { }
+
+    usl_iterator(node_type* node, std::size_t index)
+        : m_node(node)
+        , m_index(index)
+    { }
+
+    template <bool C, typename = std::enable_if_t<Const && !C>>
+    usl_iterator(const usl_iterator<UnrolledList, C>& other)
+        : m_node(other.m_node)
+        , m_index(other.m_index)
+    { }
+
+    self_type& operator++()
+    {
+        if (++m_index == m_node->m_count) {
+            m_node = m_node->next(0);
+            m_index = 0;
+        }
+        return *this;
+    }
+    self_type operator++(int)
+    {
+        self_type tmp(*this);
+        ++*this;
+        return tmp;
+    }
+    self_type& operator--()
+    {
+        if (m_index == 0) {
+            m_node = m_node->m_prev;
+            m_index = m_node->m_count;
+        }
+        --m_index;
+        return *this;
+    }
+    self_type operator--(int)
+    {
+        self_type tmp(*this);
+        --*this;
+        return tmp;
+    }
+
+    reference operator*() const { return m_node->m_keys[m_index]; }
+    pointer operator->() const { return &m_node->m_keys[m_index]; }
+
+    bool operator==(const self_type& other) const { return m_node == other.m_node && m_index == other.m_index; }
+    bool operator!=(const self_type& other) const { return !operator==(other); }
+
+    node_type* get_node() const { return m_node; }
+    std::size_t get_index() const { return m_index; }
+
+private:
+    node_type* m_node;
+    std::size_t m_index;
+
+}; // usl_iterator
+
+} // namespace internal
+
+} // namespace skip_list
+
+#include "_usl_impl.hpp"
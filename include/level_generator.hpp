@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ratio>
+
+namespace skip_list
+{
+
+/**
+ * @brief Draws the tower heights of new nodes
+ *
+ * A node gets level L with probability p^L * (1 - p). The whole height is
+ * computed from a single 64-bit word of a xorshift64* generator owned by
+ * the generator object, so lists used from different threads never share
+ * any state and there is no global lock as with rand().
+ *
+ * For p = 1/2^k the height is the count of leading zeros of the word
+ * divided by k (the high bits are the strongest ones of xorshift64*), any
+ * other p compares the word against precomputed thresholds p^L * 2^64.
+ *
+ * @tparam Probability The promotion probability p as std::ratio, 0 < p < 1
+ */
+template <typename Probability = std::ratio<1, 2>>
+class level_generator
+{
+public:
+    using level_type = std::size_t;
+    using probability = Probability;
+
+    static_assert(0 < Probability::num && Probability::num < Probability::den,
+                  "the promotion probability must be in (0, 1)");
+
+    /// Seeded from a per-thread sequence, different for every generator.
+    level_generator()
+        : level_generator(default_seed())
+    { }
+
+    /// Deterministic seeding, e.g. for reproducible benchmarks.
+    explicit level_generator(std::uint64_t seed_value)
+        : m_state(0)
+    {
+        seed(seed_value);
+    }
+
+    void seed(std::uint64_t seed_value)
+    {
+        // zero is a fixed point of xorshift
+        m_state = splitmix(seed_value);
+        if (m_state == 0) {
+            m_state = 0x9E3779B97F4A7C15ull;
+        }
+    }
+
+    /**
+     * @brief A generator of its own, seeded from the next word of this one
+     * The same seed gives the same splits, e.g. one generator per thread
+     * which draws independently of the others.
+     */
+    level_generator split() { return level_generator(next()); }
+
+    /// Random level in [0, limit].
+    level_type operator()(level_type limit)
+    {
+        const std::uint64_t word = next();
+        level_type level = 0;
+        if constexpr (shift != 0) {
+            level = static_cast<level_type>(count_leading_zeros(word)) / shift;
+        } else {
+            const auto& bounds = thresholds();
+            while (level < limit && level + 1 < bounds.size() && word < bounds[level + 1]) {
+                ++level;
+            }
+        }
+        return level < limit ? level : limit;
+    }
+
+private:
+    static constexpr unsigned log2_denominator()
+    {
+        unsigned bits = 0;
+        for (std::intmax_t den = Probability::den; den > 1 && den % 2 == 0; den /= 2) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    /// k if p = 1/2^k, zero otherwise.
+    static constexpr unsigned shift =
+        (Probability::num == 1 && (std::intmax_t(1) << log2_denominator()) == Probability::den)
+        ? log2_denominator() : 0;
+
+    /// thresholds[L] = p^L * 2^64, a word below it gives level L or higher.
+    static const std::array<std::uint64_t, 64>& thresholds()
+    {
+        static const std::array<std::uint64_t, 64> bounds = [] {
+            std::array<std::uint64_t, 64> result{};
+            const long double p = static_cast<long double>(Probability::num) / static_cast<long double>(Probability::den);
+            long double bound = 18446744073709551616.0L; // 2^64
+            result[0] = ~std::uint64_t(0);
+            for (std::size_t level = 1; level < result.size(); ++level) {
+                bound *= p;
+                result[level] = static_cast<std::uint64_t>(bound);
+            }
+            return result;
+        }();
+        return bounds;
+    }
+
+    static unsigned count_leading_zeros(std::uint64_t word)
+    {
+        if (word == 0) {
+            return 64;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_clzll(word));
+#else
+        unsigned count = 0;
+        while ((word & (std::uint64_t(1) << 63)) == 0) {
+            word <<= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    static std::uint64_t splitmix(std::uint64_t value)
+    {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    static std::uint64_t default_seed()
+    {
+        thread_local std::uint64_t sequence = std::random_device{}();
+        sequence += 0x9E3779B97F4A7C15ull;
+        return sequence;
+    }
+
+    /// xorshift64*
+    std::uint64_t next()
+    {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1Dull;
+    }
+
+private:
+    std::uint64_t m_state;
+
+}; // level_generator
+
+/// p = 1/2, the classic coin toss.
+using half_level_generator = level_generator<std::ratio<1, 2>>;
+/// p = 1/4, fewer links per node and slightly longer searches.
+using quarter_level_generator = level_generator<std::ratio<1, 4>>;
+/// p = 1/e, the theoretical optimum of the expected search cost.
+using inv_e_level_generator = level_generator<std::ratio<367879441171, 1000000000000>>;
+
+} // namespace skip_list
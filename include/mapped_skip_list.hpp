@@ -0,0 +1,155 @@
+#pragma once
+
+#include <functional>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include "internal/msl_impl.hpp"
+#include "level_generator.hpp"
+
+namespace skip_list
+{
+
+/**
+ * @brief Ordered set of unique values kept in a memory-mapped file
+ *
+ * The nodes live in a file mapped with mmap and link each other by their
+ * offset in the file, so the list is usable as soon as open() has mapped
+ * it: no value is read or inserted again. The file grows by doubling as
+ * nodes are added, erased nodes are reused.
+ *
+ * The file is mapped private: a change stays in memory until sync() writes
+ * the changed pages, first to a journal next to the file, path +
+ * "-journal", then to the file. close() and the destructor sync. A process
+ * which dies between two syncs leaves the file as the last one made it, and
+ * open() finishes a sync cut short by replaying its journal.
+ *
+ * The values must be trivially copyable and are stored as raw bytes: the
+ * file is only readable on machines with the same value layout and
+ * endianness. Inserting may move the mapping, which invalidates references
+ * to the values but not the iterators. The list is not shared between
+ * processes, a file must be opened by one list at a time.
+ */
+template <typename T,
+          typename Compare = std::less<T>,
+          typename LevelGenerator = level_generator<>>
+class mapped_skip_list
+{
+private:
+    using impl_type = internal::msl_impl<T, Compare, LevelGenerator>;
+
+public:
+    using value_type                = typename impl_type::value_type;
+    using size_type                 = typename impl_type::size_type;
+    using difference_type           = std::ptrdiff_t;
+    using const_reference           = typename impl_type::const_reference;
+    using reference                 = const_reference;
+    using compare                   = typename impl_type::compare;
+    using level_generator_type      = typename impl_type::level_generator_type;
+
+    using iterator                  = internal::msl_iterator<impl_type>;
+    using const_iterator            = iterator;
+    using reverse_iterator          = std::reverse_iterator<iterator>;
+    using const_reverse_iterator    = reverse_iterator;
+
+    static constexpr size_type default_capacity = impl_type::default_capacity;
+
+    ///@{ @name Member functions
+
+    ///@{ @name Constructors and destructor
+
+    /// A list without a file, create() or open() one before use.
+    mapped_skip_list() = default;
+    mapped_skip_list(const mapped_skip_list&) = delete;
+
+    ~mapped_skip_list() = default;
+
+    ///@}
+
+    mapped_skip_list& operator=(const mapped_skip_list&) = delete;
+
+    ///@{ @name File
+
+    /**
+     * @brief Create an empty list in a new file of capacity bytes, replacing any existing file
+     *
+     * The file open before, if any, is closed first as by close().
+     * @throw std::system_error if the file cannot be created or mapped
+     */
+    void create(const std::string& path, size_type capacity = default_capacity) { m_impl.create(path, capacity); }
+    /**
+     * @brief Map the list stored in the file
+     *
+     * The file open before, if any, is closed first as by close().
+     * @throw std::system_error if the file cannot be opened or mapped
+     * @throw std::runtime_error if it holds no list of value_type
+     */
+    void open(const std::string& path) { m_impl.open(path); }
+    /// Sync and unmap the file.
+    void close() { m_impl.close(); }
+    /// Make the file durable as it is now: all the changes since the last sync reach it, or none.
+    void sync() { m_impl.sync(); }
+
+    bool is_open() const { return m_impl.is_open(); }
+    size_type file_size() const { return m_impl.file_size(); }
+
+    level_generator_type& get_level_generator() { return m_impl.get_level_generator(); }
+
+    ///@}
+
+    ///@{ @name Iterators
+
+    iterator                begin() const   { return iterator(&m_impl, m_impl.front()); }
+    iterator                cbegin() const  { return begin(); }
+    iterator                end() const     { return iterator(&m_impl, m_impl.tail()); }
+    iterator                cend() const    { return end(); }
+
+    reverse_iterator        rbegin() const  { return reverse_iterator(end()); }
+    reverse_iterator        crbegin() const { return rbegin(); }
+    reverse_iterator        rend() const    { return reverse_iterator(begin()); }
+    reverse_iterator        crend() const   { return rend(); }
+
+    ///@}
+
+    ///@{ @name Capacity
+
+    bool      empty() const         { return size() == 0; }
+    size_type size() const          { return m_impl.size(); }
+
+    ///@}
+
+    ///@{ @name Modifiers
+
+    void clear() { m_impl.remove_all(); }
+
+    std::pair<iterator, bool> insert(const value_type& value);
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last);
+
+    /// @return The number of erased elements
+    size_type erase(const value_type& value) { return m_impl.erase(value) ? 1 : 0; }
+
+    ///@}
+
+    ///@{ @name Lookup
+
+    iterator find(const value_type& value) const { return iterator(&m_impl, m_impl.find(value)); }
+    bool contains(const value_type& value) const { return m_impl.find(value) != m_impl.tail(); }
+    size_type count(const value_type& value) const { return contains(value) ? 1 : 0; }
+
+    iterator lower_bound(const value_type& value) const { return iterator(&m_impl, m_impl.lower_bound(value)); }
+    iterator upper_bound(const value_type& value) const;
+
+    ///@}
+
+    ///@}
+
+private:
+    impl_type m_impl;
+
+}; // mapped_skip_list
+
+} // namespace skip_list
+
+#include "_mapped_skip_list.hpp"
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "internal/psl_impl.hpp"
+#include "level_generator.hpp"
+
+namespace skip_list
+{
+
+/**
+ * @brief Ordered set of unique values with small nodes, for very large indexes
+ *
+ * The nodes live in one arena, a growable array, and link each other by
+ * their 32-bit index in it instead of a pointer. Each node stores its level
+ * in a single byte, and there is no allocator header per node. With
+ * p = 1/2 an int node takes 20 bytes on average, where a skip_list node
+ * takes 56 plus the header of its allocation. Backward = false drops the
+ * back links, and with them the reverse iteration, for 16 bytes. Erased
+ * nodes are reused, the arena grows by doubling and is only given back by
+ * the destructor.
+ *
+ * The values must be trivially copyable, the arena is copied as raw bytes.
+ * The 32-bit indices address 2^32 units of max(alignof(T), 4) bytes.
+ * Inserting may move the arena, which invalidates references to the values
+ * but not the iterators.
+ *
+ * @tparam Backward Keep a back link per node, for reverse iteration and O(1) back()
+ */
+template <typename T,
+          typename Compare = std::less<T>,
+          typename LevelGenerator = level_generator<>,
+          bool Backward = true>
+class packed_skip_list
+{
+private:
+    using impl_type = internal::psl_impl<T, Compare, LevelGenerator, Backward>;
+
+public:
+    using value_type                = typename impl_type::value_type;
+    using size_type                 = typename impl_type::size_type;
+    using difference_type           = std::ptrdiff_t;
+    using const_reference           = typename impl_type::const_reference;
+    using reference                 = const_reference;
+    using compare                   = typename impl_type::compare;
+    using level_generator_type      = typename impl_type::level_generator_type;
+
+    using iterator                  = internal::psl_iterator<impl_type>;
+    using const_iterator            = iterator;
+    /// Only with Backward.
+    using reverse_iterator          = std::reverse_iterator<iterator>;
+    using const_reverse_iterator    = reverse_iterator;
+
+    ///@{ @name Member functions
+
+    ///@{ @name Constructors and destructor
+
+    /// No allocation until the first insertion.
+    packed_skip_list() = default;
+    /// Copies the arena in O(bytes), without any comparison.
+    packed_skip_list(const packed_skip_list&) = default;
+    /// O(1), other is left empty.
+    packed_skip_list(packed_skip_list&&) noexcept = default;
+
+    ~packed_skip_list() = default;
+
+    ///@}
+
+    ///@{ @name Assignment
+
+    packed_skip_list& operator=(const packed_skip_list&) = default;
+    packed_skip_list& operator=(packed_skip_list&&) noexcept = default;
+
+    ///@}
+
+    level_generator_type& get_level_generator() { return m_impl.get_level_generator(); }
+
+    ///@{ @name Element access
+
+    const_reference front() const   { return *begin(); }
+    /// O(1) with Backward, O(log n) without.
+    const_reference back() const    { return *iterator(&m_impl, m_impl.back()); }
+
+    ///@}
+
+    ///@{ @name Iterators
+
+    iterator                begin() const   { return iterator(&m_impl, m_impl.front()); }
+    iterator                cbegin() const  { return begin(); }
+    iterator                end() const     { return iterator(&m_impl, m_impl.tail()); }
+    iterator                cend() const    { return end(); }
+
+    reverse_iterator        rbegin() const  { return reverse_iterator(end()); }
+    reverse_iterator        crbegin() const { return rbegin(); }
+    reverse_iterator        rend() const    { return reverse_iterator(begin()); }
+    reverse_iterator        crend() const   { return rend(); }
+
+    ///@}
+
+    ///@{ @name Capacity
+
+    bool      empty() const         { return size() == 0; }
+    size_type size() const          { return m_impl.size(); }
+
+    /**
+     * @brief Grow the arena for count more elements at once
+     * @throw std::length_error if the arena would outgrow the 32-bit indices
+     */
+    void reserve(size_type count)   { m_impl.reserve(count); }
+    /// Bytes of the arena, the whole memory of the list but for the object itself.
+    size_type capacity_bytes() const { return m_impl.capacity_bytes(); }
+
+    ///@}
+
+    ///@{ @name Modifiers
+
+    /// Keeps the arena for the next elements.
+    void clear() { m_impl.remove_all(); }
+
+    /// @throw std::length_error if the arena would outgrow the 32-bit indices
+    std::pair<iterator, bool> insert(const value_type& value);
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last);
+
+    /// @return The number of erased elements
+    size_type erase(const value_type& value) { return m_impl.erase(value) ? 1 : 0; }
+
+    void swap(packed_skip_list& other) noexcept { m_impl.swap(other.m_impl); }
+    friend void swap(packed_skip_list& lhs, packed_skip_list& rhs) noexcept { lhs.swap(rhs); }
+
+    ///@}
+
+    ///@{ @name Lookup
+
+    iterator find(const value_type& value) const { return iterator(&m_impl, m_impl.find(value)); }
+    bool contains(const value_type& value) const { return m_impl.find(value) != m_impl.tail(); }
+    size_type count(const value_type& value) const { return contains(value) ? 1 : 0; }
+
+    iterator lower_bound(const value_type& value) const { return iterator(&m_impl, m_impl.lower_bound(value)); }
+    iterator upper_bound(const value_type& value) const;
+
+    ///@}
+
+    ///@}
+
+private:
+    impl_type m_impl;
+
+}; // packed_skip_list
+
+} // namespace skip_list
+
+#include "_packed_skip_list.hpp"
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#include "internal/sl_pool.hpp"
+
+namespace skip_list
+{
+
+/**
+ * @brief Allocator backed by a shared arena with per-size free lists
+ *
+ * A skip list node is one block whose size depends on the tower height, so
+ * the size classes of the arena are effectively per-height free lists:
+ * erased nodes are reused by the next insert of the same height.
+ *
+ * Copies and rebound copies share the arena. A copy-constructed container
+ * gets a fresh arena of the same chunk size (see
+ * select_on_container_copy_construction()), and a container which is the
+ * only owner of its arena with trivially destructible elements clears
+ * itself by releasing the arena in O(1).
+ */
+template <typename T>
+class pool_allocator
+{
+    template <typename U> friend class pool_allocator;
+
+public:
+    using value_type                                = T;
+    using size_type                                 = std::size_t;
+    using difference_type                           = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment    = std::false_type;
+    using propagate_on_container_move_assignment    = std::true_type;
+    using propagate_on_container_swap               = std::true_type;
+    using is_always_equal                           = std::false_type;
+
+    static_assert(alignof(T) <= internal::sl_pool::granule, "over-aligned types are not supported");
+
+    explicit pool_allocator(size_type chunk_size = internal::sl_pool::default_chunk_size)
+        : m_pool(std::make_shared<internal::sl_pool>(chunk_size))
+    { }
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept
+        : m_pool(other.m_pool)
+    { }
+
+    T* allocate(size_type count)
+    {
+        return static_cast<T*>(m_pool->allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_type count)
+    {
+        m_pool->deallocate(ptr, count * sizeof(T));
+    }
+
+    /// A fresh arena with the same chunk size.
+    pool_allocator select_on_container_copy_construction() const
+    {
+        return pool_allocator(m_pool->chunk_size());
+    }
+
+    /// Free the whole arena, every block allocated from it becomes invalid.
+    void release() { m_pool->release(); }
+
+    /// Whether this is the only allocator using the arena.
+    bool unique() const { return m_pool.use_count() == 1; }
+
+    /// Bytes reserved by the arena from the system allocator.
+    size_type reserved() const { return m_pool->reserved(); }
+
+    template <typename U>
+    bool operator==(const pool_allocator<U>& other) const { return m_pool == other.m_pool; }
+    template <typename U>
+    bool operator!=(const pool_allocator<U>& other) const { return !operator==(other); }
+
+private:
+    std::shared_ptr<internal::sl_pool> m_pool;
+
+}; // pool_allocator
+
+} // namespace skip_list
@@ -2,37 +2,63 @@
 
 #include <memory>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
 #include "internal/sl_impl.hpp"
+#include "level_generator.hpp"
+#include "pool_allocator.hpp"
+#include "stats_policy.hpp"
 
 namespace skip_list
 {
+
+/// Tag telling that an input range is sorted and free of duplicates.
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+inline constexpr sorted_unique_t sorted_unique{};
+
+/// Tag asking for a build spread over several threads.
+struct parallel_t { explicit parallel_t() = default; };
+inline constexpr parallel_t parallel{};
+
 template <typename T,
           typename Compare = std::less<T>,
-          typename Allocator = std::allocator<T>>
+          typename Allocator = std::allocator<T>,
+          typename LevelGenerator = level_generator<>,
+          typename Stats = null_stats>
 class skip_list
 {
 private:
-    using impl_type = internal::sl_impl<T, Compare, Allocator>;
+    using impl_type = internal::sl_impl<T, Compare, Allocator, LevelGenerator, Stats>;
     using node_type = typename impl_type::node_type;
 
 public:
     using value_type                = typename impl_type::value_type;
     using size_type                 = typename impl_type::size_type;
     using allocator_type            = typename impl_type::allocator_type;
-    using difference_type           = typename allocator_type::difference_type;
-    using reference                 = typename allocator_type::reference;
-    using const_reference           = typename allocator_type::const_reference;
-    using pointer                   = typename allocator_type::pointer;
-    using const_pointer             = typename allocator_type::const_pointer;
+    using difference_type           = typename std::allocator_traits<allocator_type>::difference_type;
+    using reference                 = typename impl_type::reference;
+    using const_reference           = typename impl_type::const_reference;
+    using pointer                   = typename impl_type::pointer;
+    using const_pointer             = typename impl_type::const_pointer;
     using compare                   = typename impl_type::compare;
+    using level_generator_type      = typename impl_type::level_generator_type;
+    using stats_type                = typename impl_type::stats_type;
 
     using iterator                  = internal::sl_iterator<impl_type>;
     using const_iterator            = internal::sl_const_iterator<impl_type>;
     using reverse_iterator          = std::reverse_iterator<iterator>;
     using const_reverse_iterator    = std::reverse_iterator<const_iterator>;
 
+private:
+    /// Enables an overload for keys other than value_type if the comparator is transparent.
+    template <typename Key, typename Result = void>
+    using if_transparent = std::enable_if_t<internal::sl_is_transparent<compare>::value &&
+                                            !std::is_convertible_v<Key, iterator> &&
+                                            !std::is_convertible_v<Key, const_iterator>, Result>;
+
+public:
+
     ///@{ @name Member functions
 
     ///@{ @name Constructors and destructor
@@ -40,9 +66,17 @@ public:
     explicit skip_list(const allocator_type& alloc = allocator_type());
     template <class InputIterator>
     skip_list(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type());
+    template <class InputIterator>
+    skip_list(sorted_unique_t, InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type());
+    /// Built with assign(parallel, first, last) on every hardware thread.
+    template <class InputIterator>
+    skip_list(parallel_t, InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type());
+    /// The copy has the same tower heights, O(n) without any comparison.
     skip_list(const skip_list& other);
     skip_list(const skip_list& other, const allocator_type& alloc);
-    skip_list(skip_list&& other);
+    /// O(log n) to relink the nodes to the sentinels of this list, other is left empty.
+    skip_list(skip_list&& other) noexcept(std::is_nothrow_move_constructible_v<impl_type>);
+    /// O(log n) if the allocators are equal, otherwise the values are moved one by one.
     skip_list(skip_list&& other, const allocator_type &alloc);
     skip_list(std::initializer_list<T> init, const allocator_type& alloc = allocator_type());
 
@@ -53,17 +87,38 @@ public:
     ///@{ @name Assignment
 
     skip_list& operator=(const skip_list& other);
-    skip_list& operator=(skip_list&& other);
+    /// O(log n) unless the allocators differ and do not propagate on move assignment.
+    skip_list& operator=(skip_list&& other) noexcept(std::is_nothrow_move_assignable_v<impl_type>);
     skip_list& operator=(std::initializer_list<T> init);
 
+    /// Linear time if the range is sorted, elements out of order are inserted one by one.
     template <typename InputIterator>
     void assign(InputIterator first, InputIterator last);
+    /// Linear time without any comparisons, the range must be sorted and unique.
+    template <typename InputIterator>
+    void assign(sorted_unique_t, InputIterator first, InputIterator last);
+    /**
+     * @brief Build from an unsorted range with several threads
+     * The values are copied out and sorted in chunks by the threads, then
+     * every thread links a segment of them and the segments are joined:
+     * O(n log n / threads + n) against O(n log n) searches one by one.
+     * Only the first of equal values is kept. threads = 0 uses every
+     * hardware thread, or fewer for a small range. The allocator is used
+     * from all the threads at once, except a pool_allocator which is not
+     * thread safe: its lists are linked by one thread.
+     */
+    template <typename InputIterator>
+    void assign(parallel_t, InputIterator first, InputIterator last, size_type threads = 0);
     void assign(std::initializer_list<T> init);
 
     ///@}
 
     allocator_type get_allocator() const { return m_impl.get_allocator(); }
 
+    /// The generator of the tower heights, e.g. to seed it for reproducible runs.
+    level_generator_type& get_level_generator() { return m_impl.get_level_generator(); }
+    const level_generator_type& get_level_generator() const { return m_impl.get_level_generator(); }
+
     ///@{ @name Element access
 
     reference front();
@@ -96,7 +151,53 @@ public:
 
     bool      empty() const         { return m_impl.size() == 0; }
     size_type size() const          { return m_impl.size(); }
-    size_type max_size() const      { return m_impl.get_allocator().max_size(); }
+    size_type max_size() const      { return std::allocator_traits<allocator_type>::max_size(m_impl.get_allocator()); }
+
+    /**
+     * @brief Hint that the list is expected to hold count elements
+     * Towers are sized for max(size(), count) elements from the start
+     * instead of growing with the list.
+     */
+    void reserve(size_type count)   { m_impl.reserve(count); }
+
+    ///@}
+
+    ///@{ @name Compaction
+    /// Churn scatters the nodes over the heap and a scan then misses the cache
+    /// at almost every element. Compacting reallocates the nodes next to each
+    /// other in key order, towers included, in blocks of up to 2^16 nodes. A
+    /// block is freed with the last of its nodes. The iterators and references
+    /// to the relocated elements are invalidated.
+
+    /**
+     * @brief Relocate every node, O(n)
+     * @param rebalance Also give the towers the ideal heights for their positions,
+     *        e.g. every second node gets level 1 and every fourth level 2 for p = 1/2
+     */
+    void compact(bool rebalance = false)    { m_impl.compact(rebalance); }
+    /// compact() keeping the heights, also gives back the room of the nodes erased since the last one.
+    void shrink_to_fit()                    { m_impl.compact(false); }
+    /**
+     * @brief compact() in bounded slices, relocates the next count nodes in O(count + log n)
+     * Every call goes on at the position where the previous one stopped, so
+     * the list may change in between, e.g. slices run between requests.
+     * @return Whether the pass reached the end, the next call starts over from the front
+     */
+    bool compact_step(size_type count, bool rebalance = false) { return m_impl.compact_step(count, rebalance); }
+
+    ///@}
+
+    ///@{ @name Finger search
+
+    /**
+     * @brief Make every search start from where the previous one ended
+     * Searches then cost O(log d) for a key d elements away from the last one
+     * instead of O(log n), but a random key costs up to twice the comparisons.
+     * While enabled the const lookups update the finger, so the list must not
+     * be searched concurrently even through const members.
+     */
+    void enable_finger(bool enabled = true) { m_impl.enable_finger(enabled); }
+    bool finger_enabled() const             { return m_impl.finger_enabled(); }
 
     ///@}
 
@@ -105,27 +206,246 @@ public:
     void clear() { m_impl.remove_all(); }
 
     std::pair<iterator, bool> insert(const value_type& value);
+    std::pair<iterator, bool> insert(value_type&& value);
+    /**
+     * @brief Insert searching from the hint, the element the value belongs right before
+     * Hinted inserts keep the search path of the last one. When it does not
+     * lead to the value the search climbs from the element before the hint,
+     * and only the levels above the climb are taken from the previous path,
+     * as every link over the new element counts it. A run of nearby values,
+     * e.g. `hint = insert(hint, value)` over almost sorted input, costs
+     * O(log d) per value where d is the distance between them.
+     * @return The element equal to the value
+     */
+    iterator insert(const_iterator hint, const value_type& value);
+    iterator insert(const_iterator hint, value_type&& value);
+    /// Elements greater than the current last one are appended without a search.
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last);
     void insert(std::initializer_list<T> init);
 
+    /// Construct the value in place, it is destroyed again if an equal one is present.
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args);
+
+    /**
+     * @brief Construct value_type(key, args...) only if no element is equal to the key
+     * With a transparent comparator the key can be any type the values compare with,
+     * e.g. a std::string_view for std::string values, and nothing is built for a duplicate.
+     * Otherwise a key other than value_type makes it the same as emplace().
+     */
+    template <typename Key, typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args);
+
+    /// emplace() searching from the hint, see insert(const_iterator, const value_type&).
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args);
+
+    /// @return Iterator after the erased element, end() if there is no such element
     iterator erase(const value_type& value);
+    /// Erase the node of the iterator, one descent collects its predecessors.
+    iterator erase(const_iterator pos);
+    /// Unlinks the range at once, O(log n + k).
+    iterator erase(const_iterator first, const_iterator last);
+    template <typename Key, typename = if_transparent<Key>>
+    iterator erase(const Key& key) { return iterator(m_impl.remove(key)); }
+
+    ///@{ @name Priority queue
+    /// The list must not be empty.
+
+    /// Erase the first element in O(levels) without a search, the head precedes it at every level.
+    void pop_front();
+    /// Erase the last element, O(log n).
+    void pop_back();
+    /// Move the first element out and erase it like pop_front(), e.g. to drain a scheduler queue.
+    value_type extract_min();
+
+    ///@}
+
+    /**
+     * @brief Exchange the contents in O(log n + log m), the iterators but end() follow their elements
+     * The allocators must be equal unless they propagate on swap.
+     */
+    void swap(skip_list& other) noexcept        { m_impl.swap(other.m_impl); }
+    friend void swap(skip_list& lhs, skip_list& rhs) noexcept { lhs.swap(rhs); }
 
     ///@}
 
     ///@{ @name Lookup
 
+    // The Key overloads take anything the transparent comparator accepts.
+
     iterator find(const value_type& value);
     const_iterator find(const value_type& value) const;
+    template <typename Key, typename = if_transparent<Key>>
+    iterator find(const Key& key);
+    template <typename Key, typename = if_transparent<Key>>
+    const_iterator find(const Key& key) const;
 
     iterator lower_bound(const value_type& value);
     const_iterator lower_bound(const value_type& value) const;
+    template <typename Key, typename = if_transparent<Key>>
+    iterator lower_bound(const Key& key);
+    template <typename Key, typename = if_transparent<Key>>
+    const_iterator lower_bound(const Key& key) const;
 
     iterator upper_bound(const value_type& value);
     const_iterator upper_bound(const value_type& value) const;
+    template <typename Key, typename = if_transparent<Key>>
+    iterator upper_bound(const Key& key);
+    template <typename Key, typename = if_transparent<Key>>
+    const_iterator upper_bound(const Key& key) const;
+
+    /**
+     * @brief lower_bound() of every key in [first, last), written to out in the same order
+     * Batches of searches advance in lockstep with software prefetching, so
+     * on lists bigger than the cache their memory latency overlaps. The keys
+     * are value_type or anything the transparent comparator accepts.
+     */
+    template <typename ForwardIterator, typename OutputIterator>
+    OutputIterator lower_bound_batch(ForwardIterator first, ForwardIterator last, OutputIterator out);
+    template <typename ForwardIterator, typename OutputIterator>
+    OutputIterator lower_bound_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const;
+    /// find() of every key in [first, last), see lower_bound_batch().
+    template <typename ForwardIterator, typename OutputIterator>
+    OutputIterator find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out);
+    template <typename ForwardIterator, typename OutputIterator>
+    OutputIterator find_batch(ForwardIterator first, ForwardIterator last, OutputIterator out) const;
+
+    /**
+     * @brief find() starting at pos instead of the head
+     * O(log d) for a key d elements after pos. Only the element right
+     * before pos is found cheaply backwards, other keys before pos are
+     * searched from the head.
+     */
+    iterator find_from(const_iterator pos, const value_type& value);
+    const_iterator find_from(const_iterator pos, const value_type& value) const;
+    template <typename Key, typename = if_transparent<Key>>
+    iterator find_from(const_iterator pos, const Key& key);
+    template <typename Key, typename = if_transparent<Key>>
+    const_iterator find_from(const_iterator pos, const Key& key) const;
+
+    ///@}
+
+    ///@{ @name Set operations
+
+    /**
+     * @brief Move in the elements of other which have no equal element here
+     * The nodes change lists without being reallocated, both are relinked in
+     * a single pass: O(n + m). If other is much smaller its nodes are linked
+     * in one by one, each searched from the previous one: O(m log(n / m)).
+     * Unequal allocators fall back to moving the values.
+     */
+    void merge(skip_list& other)    { m_impl.merge(other.m_impl); }
+    void merge(skip_list&& other)   { m_impl.merge(other.m_impl); }
+
+    // Build a new list in one pass over both, O(n + m). The intersection and
+    // the difference of a much smaller lhs search the other side instead.
+
+    friend skip_list set_union(const skip_list& lhs, const skip_list& rhs)
+    {
+        return skip_list(internal::sl_build, lhs.copy_allocator(),
+                         [&](impl_type& impl) { impl.assign_union(lhs.m_impl, rhs.m_impl); });
+    }
+    friend skip_list set_intersection(const skip_list& lhs, const skip_list& rhs)
+    {
+        return skip_list(internal::sl_build, lhs.copy_allocator(),
+                         [&](impl_type& impl) { impl.assign_intersection(lhs.m_impl, rhs.m_impl); });
+    }
+    friend skip_list set_difference(const skip_list& lhs, const skip_list& rhs)
+    {
+        return skip_list(internal::sl_build, lhs.copy_allocator(),
+                         [&](impl_type& impl) { impl.assign_difference(lhs.m_impl, rhs.m_impl); });
+    }
+
+    ///@}
+
+    ///@{ @name Splicing
+    /// The nodes move between the lists without being reallocated, the
+    /// iterators stay valid but point into the list which got the element.
+
+    /// Move the elements not less than the key to the returned list, O(log n).
+    skip_list split(const value_type& key);
+    /**
+     * @brief Append other, all its elements must be greater than the ones here
+     * O(log n + log m), other is left empty. With unequal allocators the
+     * values are moved instead, O(m).
+     */
+    void join(skip_list& other)     { m_impl.join(other.m_impl); }
+    void join(skip_list&& other)    { m_impl.join(other.m_impl); }
+    /**
+     * @brief Move [first, last) to the returned list, O(log n)
+     * Lets a big range be destroyed later or by another thread: the
+     * elements are only destroyed with the returned list.
+     */
+    skip_list extract(const_iterator first, const_iterator last);
+
+    ///@}
+
+    ///@{ @name Order statistics, O(log n) each
+
+    /// The element at the zero-based index, end() if the index is not less than size().
+    iterator nth(size_type index);
+    const_iterator nth(size_type index) const;
+
+    /// Zero-based index of the element, size() for end().
+    size_type index_of(const_iterator pos) const;
+    /// The number of elements less than the value, i.e. the index lower_bound(value) would have.
+    size_type index_of(const value_type& value) const { return m_impl.count_less(value); }
+
+    /// std::distance without walking the range.
+    difference_type distance(const_iterator first, const_iterator last) const;
+    /// The number of elements in [lo, hi).
+    size_type count_range(const value_type& lo, const value_type& hi) const;
+
+    ///@}
+
+    ///@{ @name Parallel traversal
+
+    /**
+     * @brief Call fn(const value_type&) with every element in [lo, hi), from several threads
+     * The range is cut at evenly spaced positions and each thread visits its
+     * part in order, the parts in no particular order. fn is shared by the
+     * threads and must not change the list. threads = 0 uses every hardware
+     * thread, or fewer for a small range. An exception thrown by fn is
+     * rethrown here once every thread is done.
+     */
+    template <typename Fn>
+    void parallel_for_each(const value_type& lo, const value_type& hi, Fn&& fn, size_type threads = 0) const
+    {
+        m_impl.for_each_parallel(lo, hi, fn, threads);
+    }
+
+    ///@}
+
+    ///@{ @name Introspection
+
+    /**
+     * @brief Level histogram and node bytes, measured now in O(n), and the counters of the stats policy
+     * The counters (comparisons, hops per level, descents, allocations) stay
+     * zero with the default null_stats, use counting_stats to collect them.
+     */
+    stats_snapshot stats() const    { return m_impl.stats(); }
+    void reset_stats()              { m_impl.reset_stats(); }
 
     ///@}
 
     ///@}
 
+private:
+    /// Constructor of the lists returned by value, build fills the empty impl.
+    template <typename Build>
+    skip_list(internal::sl_build_t, const allocator_type& alloc, Build&& build)
+        : m_impl(alloc)
+    {
+        build(m_impl);
+    }
+
+    allocator_type copy_allocator() const
+    {
+        return std::allocator_traits<allocator_type>::select_on_container_copy_construction(get_allocator());
+    }
+
 public:
     void pretty_dump() const
     {
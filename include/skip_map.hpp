@@ -0,0 +1,187 @@
+#pragma once
+
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "internal/sl_impl.hpp"
+#include "internal/sl_map.hpp"
+#include "level_generator.hpp"
+#include "stats_policy.hpp"
+
+namespace skip_list
+{
+
+/**
+ * @brief Ordered map of unique keys
+ *
+ * Unlike a skip_list of pairs, the nodes keep only the key and a small
+ * mapped value next to the tower, so a search drags only key bytes into
+ * the cache. A mapped value bigger than a pointer is stored out of line
+ * in slabs owned by the map.
+ *
+ * The elements are not stored as std::pair, dereferencing an iterator
+ * gives a std::pair<const Key&, Mapped&>.
+ */
+template <typename Key,
+          typename Mapped,
+          typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, Mapped>>,
+          typename LevelGenerator = level_generator<>>
+class skip_map
+{
+private:
+    static constexpr bool inline_mapped = internal::sl_map_inline<Mapped>;
+
+    using entry_type = internal::sl_map_entry<Key, Mapped>;
+    using entry_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<entry_type>;
+    using impl_type = internal::sl_impl<entry_type, internal::sl_map_compare<Compare>, entry_allocator, LevelGenerator, null_stats>;
+    using node_type = typename impl_type::node_type;
+    using slab_type = internal::sl_slab<Mapped, Allocator>;
+
+public:
+    using key_type                  = Key;
+    using mapped_type               = Mapped;
+    using value_type                = std::pair<const Key, Mapped>;
+    using size_type                 = typename impl_type::size_type;
+    using difference_type           = typename std::allocator_traits<Allocator>::difference_type;
+    using key_compare               = Compare;
+    using allocator_type            = Allocator;
+    using level_generator_type      = LevelGenerator;
+
+    using iterator                  = internal::sl_map_iterator<node_type, Key, Mapped, false>;
+    using const_iterator            = internal::sl_map_iterator<node_type, Key, Mapped, true>;
+    using reference                 = typename iterator::reference;
+    using const_reference           = typename const_iterator::reference;
+
+    ///@{ @name Member functions
+
+    ///@{ @name Constructors and destructor
+
+    explicit skip_map(const allocator_type& alloc = allocator_type());
+    explicit skip_map(const key_compare& comp, const allocator_type& alloc = allocator_type());
+    template <class InputIterator>
+    skip_map(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type());
+    skip_map(std::initializer_list<value_type> init, const allocator_type& alloc = allocator_type());
+    /// Same keys, values and tower heights as other, O(n) without any comparison.
+    skip_map(const skip_map& other);
+    /// O(log n) to relink the nodes to the sentinels of this map, other is left empty.
+    skip_map(skip_map&& other) noexcept(std::is_nothrow_move_constructible_v<impl_type>);
+
+    ~skip_map();
+
+    ///@}
+
+    skip_map& operator=(const skip_map& other);
+    /// O(log n) unless the allocators differ and do not propagate on move assignment.
+    skip_map& operator=(skip_map&& other) noexcept(std::is_nothrow_move_assignable_v<impl_type>);
+
+    allocator_type get_allocator() const { return allocator_type(m_impl.get_allocator()); }
+    key_compare key_comp() const { return m_impl.key_comp().key_comp(); }
+
+    level_generator_type& get_level_generator() { return m_impl.get_level_generator(); }
+    const level_generator_type& get_level_generator() const { return m_impl.get_level_generator(); }
+
+    ///@{ @name Element access
+
+    /// Default constructs the mapped value if the key is absent.
+    mapped_type& operator[](const key_type& key);
+    mapped_type& operator[](key_type&& key);
+
+    /// @throw std::out_of_range if the key is absent
+    mapped_type& at(const key_type& key);
+    const mapped_type& at(const key_type& key) const;
+
+    ///@}
+
+    ///@{ @name Iterators
+
+    iterator       begin()          { return iterator(m_impl.front()); }
+    const_iterator begin() const    { return const_iterator(const_cast<node_type*>(m_impl.front())); }
+    const_iterator cbegin() const   { return begin(); }
+
+    iterator       end()            { return iterator(m_impl.tail()); }
+    const_iterator end() const      { return const_iterator(const_cast<node_type*>(m_impl.tail())); }
+    const_iterator cend() const     { return end(); }
+
+    ///@}
+
+    ///@{ @name Capacity
+
+    bool      empty() const         { return m_impl.size() == 0; }
+    size_type size() const          { return m_impl.size(); }
+
+    ///@}
+
+    ///@{ @name Modifiers
+
+    void clear();
+
+    std::pair<iterator, bool> insert(const value_type& value);
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last);
+
+    /// The mapped value is constructed from the arguments only if the key is absent.
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args);
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args);
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj);
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj);
+
+    /// @return The number of erased elements
+    size_type erase(const key_type& key);
+    iterator erase(const_iterator pos);
+
+    /// O(log n + log m), the allocators must be equal unless they propagate on swap.
+    void swap(skip_map& other) noexcept;
+    friend void swap(skip_map& lhs, skip_map& rhs) noexcept { lhs.swap(rhs); }
+
+    ///@}
+
+    ///@{ @name Lookup
+
+    iterator find(const key_type& key);
+    const_iterator find(const key_type& key) const;
+    bool contains(const key_type& key) const { return find(key) != end(); }
+    size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+    iterator lower_bound(const key_type& key);
+    const_iterator lower_bound(const key_type& key) const;
+
+    iterator upper_bound(const key_type& key);
+    const_iterator upper_bound(const key_type& key) const;
+
+    ///@}
+
+    ///@}
+
+private:
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace_key(K&& key, Args&&... args);
+
+    /// Callable building the mapped value of a new entry from the arguments, in the slab if it is out of line.
+    template <typename... Args>
+    auto mapped_factory(Args&&... args);
+
+    /// Replace the contents with copies of the entries of other, same tower heights.
+    void copy_entries(const skip_map& other);
+
+    /// Destroy the out of line value of an entry which is about to go.
+    void dispose(entry_type& entry);
+
+private:
+    slab_type m_slab;
+    impl_type m_impl;
+
+}; // skip_map
+
+} // namespace skip_list
+
+#include "_skip_map.hpp"
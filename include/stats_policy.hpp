@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace skip_list
+{
+
+/// Searches from the head told apart by the stats policies.
+enum class descent
+{
+    find,
+    insert,
+    erase,
+};
+
+/**
+ * @brief Shape and hot path counters of a list at one point in time
+ * The shape is measured when the snapshot is taken, O(n). The counters stay
+ * zero unless the list collects them with counting_stats.
+ */
+struct stats_snapshot
+{
+    static constexpr std::size_t max_levels = 32;
+
+    ///@{ @name Shape
+
+    std::size_t m_size = 0;
+    /// Highest level linked from the head.
+    std::size_t m_levels = 0;
+    /// Number of nodes per level, a node of level L has L + 1 links.
+    std::array<std::size_t, max_levels> m_level_histogram{};
+    /// Bytes of all the element nodes, tower included.
+    std::size_t m_node_bytes = 0;
+    double m_bytes_per_node = 0;
+
+    ///@}
+
+    ///@{ @name Counters
+
+    std::size_t m_comparisons = 0;
+    /// Moves to the right per level, over all the searches.
+    std::array<std::size_t, max_levels> m_hops{};
+    std::size_t m_find_descents = 0;
+    std::size_t m_insert_descents = 0;
+    std::size_t m_erase_descents = 0;
+    /// Moves to the right per search.
+    double m_average_path_length = 0;
+    std::size_t m_allocations = 0;
+    std::size_t m_deallocations = 0;
+    std::size_t m_allocated_bytes = 0;
+
+    ///@}
+
+}; // stats_snapshot
+
+/**
+ * @brief Default stats policy, collects nothing
+ * Every hook is empty so a list without stats pays nothing for them.
+ */
+struct null_stats
+{
+    static constexpr bool enabled = false;
+
+    void on_hop(std::size_t /*level*/) { }
+    void on_descent(descent /*kind*/) { }
+    void on_allocate(std::size_t /*bytes*/) { }
+    void on_deallocate(std::size_t /*bytes*/) { }
+
+    void fill(stats_snapshot& /*snapshot*/) const { }
+    void reset() { }
+
+}; // null_stats
+
+/**
+ * @brief Stats policy counting the hot path events of a list
+ * Plain counters, not synchronized, like the list they belong to. The
+ * comparator calls are counted by the list itself around its comparator.
+ */
+class counting_stats
+{
+public:
+    static constexpr bool enabled = true;
+
+    void on_hop(std::size_t level) { ++m_hops[level]; }
+    void on_descent(descent kind) { ++m_descents[static_cast<std::size_t>(kind)]; }
+    void on_allocate(std::size_t bytes)
+    {
+        ++m_allocations;
+        m_allocated_bytes += bytes;
+    }
+    void on_deallocate(std::size_t /*bytes*/) { ++m_deallocations; }
+
+    void fill(stats_snapshot& snapshot) const
+    {
+        std::size_t hops = 0;
+        for (std::size_t level = 0; level < stats_snapshot::max_levels; ++level) {
+            snapshot.m_hops[level] = m_hops[level];
+            hops += m_hops[level];
+        }
+        snapshot.m_find_descents = m_descents[static_cast<std::size_t>(descent::find)];
+        snapshot.m_insert_descents = m_descents[static_cast<std::size_t>(descent::insert)];
+        snapshot.m_erase_descents = m_descents[static_cast<std::size_t>(descent::erase)];
+        const std::size_t descents = snapshot.m_find_descents + snapshot.m_insert_descents + snapshot.m_erase_descents;
+        snapshot.m_average_path_length = descents == 0 ? 0 : static_cast<double>(hops) / static_cast<double>(descents);
+        snapshot.m_allocations = m_allocations;
+        snapshot.m_deallocations = m_deallocations;
+        snapshot.m_allocated_bytes = m_allocated_bytes;
+    }
+
+    void reset() { *this = counting_stats(); }
+
+private:
+    std::array<std::size_t, stats_snapshot::max_levels> m_hops{};
+    std::array<std::size_t, 3> m_descents{};
+    std::size_t m_allocations = 0;
+    std::size_t m_deallocations = 0;
+    std::size_t m_allocated_bytes = 0;
+
+}; // counting_stats
+
+} // namespace skip_list
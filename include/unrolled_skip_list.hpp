@@ -0,0 +1,169 @@
+#pragma once
+
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "internal/usl_impl.hpp"
+#include "level_generator.hpp"
+
+namespace skip_list
+{
+
+/**
+ * @brief Ordered set of unique keys stored in blocks
+ *
+ * Every node holds a sorted block of up to BlockSize keys and the skip list
+ * is built over the first key of each block, so there are BlockSize / 2 to
+ * BlockSize times fewer nodes than in a skip_list, a search visits fewer
+ * cache lines and an iteration walks contiguous keys.
+ *
+ * A full block is split in two halves. A block which falls under half a
+ * block on an erase takes keys from a neighbour, or takes it in whole when
+ * both fit in one block, so every block but a lone one holds BlockSize / 2
+ * to BlockSize keys. The blocks of 32 and 64 bit integers in their natural
+ * order are searched with SIMD compares (SSE2, SSE4.2 or AVX2 when enabled
+ * by the compiler), other keys with a binary search.
+ *
+ * The keys must be trivially copyable. Inserting or erasing invalidates
+ * the iterators.
+ */
+template <typename T,
+          typename Compare = std::less<T>,
+          typename Allocator = std::allocator<T>,
+          typename LevelGenerator = level_generator<>,
+          std::size_t BlockSize = 32>
+class unrolled_skip_list
+{
+private:
+    using impl_type = internal::usl_impl<T, Compare, Allocator, LevelGenerator, BlockSize>;
+    using node_type = typename impl_type::node_type;
+    using position_type = typename impl_type::position_type;
+
+public:
+    using value_type                = typename impl_type::value_type;
+    using size_type                 = typename impl_type::size_type;
+    using allocator_type            = typename impl_type::allocator_type;
+    using difference_type           = typename std::allocator_traits<allocator_type>::difference_type;
+    using reference                 = typename impl_type::reference;
+    using const_reference           = typename impl_type::const_reference;
+    using pointer                   = typename impl_type::pointer;
+    using const_pointer             = typename impl_type::const_pointer;
+    using compare                   = typename impl_type::compare;
+    using level_generator_type      = typename impl_type::level_generator_type;
+
+    using iterator                  = internal::usl_iterator<impl_type, false>;
+    using const_iterator            = internal::usl_iterator<impl_type, true>;
+    using reverse_iterator          = std::reverse_iterator<iterator>;
+    using const_reverse_iterator    = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type block_size = BlockSize;
+
+    ///@{ @name Member functions
+
+    ///@{ @name Constructors and destructor
+
+    explicit unrolled_skip_list(const allocator_type& alloc = allocator_type());
+    template <class InputIterator>
+    unrolled_skip_list(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type());
+    unrolled_skip_list(std::initializer_list<T> init, const allocator_type& alloc = allocator_type());
+    unrolled_skip_list(const unrolled_skip_list& other) = default;
+    /// Takes the blocks over without any allocation, other is left empty.
+    unrolled_skip_list(unrolled_skip_list&& other) noexcept = default;
+
+    ~unrolled_skip_list() = default;
+
+    ///@}
+
+    ///@{ @name Assignment
+
+    /// Copies other aside then swaps it in, the list is unchanged if the copy throws.
+    unrolled_skip_list& operator=(const unrolled_skip_list& other);
+    /// Takes the blocks over, other is left empty. Unequal allocators which do not propagate copy the keys.
+    unrolled_skip_list& operator=(unrolled_skip_list&& other) noexcept(std::is_nothrow_move_assignable_v<impl_type>);
+
+    ///@}
+
+    allocator_type get_allocator() const { return m_impl.get_allocator(); }
+    level_generator_type& get_level_generator() { return m_impl.get_level_generator(); }
+
+    ///@{ @name Iterators
+
+    iterator                begin()         { return iterator(m_impl.front(), 0); }
+    const_iterator          begin() const   { return const_iterator(m_impl.front(), 0); }
+    const_iterator          cbegin() const  { return begin(); }
+
+    iterator                end()           { return iterator(m_impl.tail(), 0); }
+    const_iterator          end() const     { return const_iterator(m_impl.tail(), 0); }
+    const_iterator          cend() const    { return end(); }
+
+    reverse_iterator        rbegin()        { return reverse_iterator(end()); }
+    const_reverse_iterator  rbegin() const  { return const_reverse_iterator(end()); }
+    const_reverse_iterator  crbegin() const { return rbegin(); }
+
+    reverse_iterator        rend()          { return reverse_iterator(begin()); }
+    const_reverse_iterator  rend() const    { return const_reverse_iterator(begin()); }
+    const_reverse_iterator  crend() const   { return rend(); }
+
+    ///@}
+
+    ///@{ @name Capacity
+
+    bool      empty() const         { return m_impl.size() == 0; }
+    size_type size() const          { return m_impl.size(); }
+    /// Number of blocks holding the keys.
+    size_type blocks() const        { return m_impl.nodes(); }
+
+    ///@}
+
+    ///@{ @name Modifiers
+
+    void clear() { m_impl.remove_all(); }
+
+    std::pair<iterator, bool> insert(const value_type& value);
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last);
+
+    /// @return The number of erased elements
+    size_type erase(const value_type& value) { return m_impl.erase(value) ? 1 : 0; }
+    /// @return Iterator after the erased element
+    iterator erase(const_iterator pos);
+
+    /**
+     * @brief Exchange the elements in O(log n + log m)
+     * The sentinels stay with their lists, the first and the last block of
+     * every level are relinked. The allocators must be equal unless they
+     * propagate on swap.
+     */
+    void swap(unrolled_skip_list& other) noexcept { m_impl.swap(other.m_impl); }
+    friend void swap(unrolled_skip_list& lhs, unrolled_skip_list& rhs) noexcept { lhs.swap(rhs); }
+
+    ///@}
+
+    ///@{ @name Lookup
+
+    iterator find(const value_type& value);
+    const_iterator find(const value_type& value) const;
+    bool contains(const value_type& value) const { return m_impl.find(value).first != m_impl.tail(); }
+    size_type count(const value_type& value) const { return contains(value) ? 1 : 0; }
+
+    iterator lower_bound(const value_type& value);
+    const_iterator lower_bound(const value_type& value) const;
+
+    iterator upper_bound(const value_type& value);
+    const_iterator upper_bound(const value_type& value) const;
+
+    ///@}
+
+    ///@}
+
+private:
+    impl_type m_impl;
+
+}; // unrolled_skip_list
+
+} // namespace skip_list
+
+#include "_unrolled_skip_list.hpp"
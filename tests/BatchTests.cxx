@@ -0,0 +1,128 @@
+#include <cstddef>
+#include <forward_list>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+using list_type = skip_list::skip_list<int, std::less<int>, std::allocator<int>,
+                                       skip_list::level_generator<>, skip_list::counting_stats>;
+using string_list = skip_list::skip_list<std::string, std::less<>>;
+
+/// Both batches against one search per key, with keys in any order, duplicates and misses.
+template <typename List, typename Keys>
+void check_batches(List& list, const Keys& keys)
+{
+    std::vector<typename List::iterator> lower;
+    std::vector<typename List::iterator> found;
+    list.lower_bound_batch(keys.begin(), keys.end(), std::back_inserter(lower));
+    list.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+    const std::size_t count = static_cast<std::size_t>(std::distance(keys.begin(), keys.end()));
+    CHECK(lower.size() == count && found.size() == count);
+    std::size_t i = 0;
+    for (const auto& key : keys) {
+        CHECK(lower[i] == list.lower_bound(key));
+        CHECK(found[i] == list.find(key));
+        ++i;
+    }
+
+    // the const overloads give the same positions
+    const List& const_list = list;
+    std::vector<typename List::const_iterator> const_lower(count);
+    std::vector<typename List::const_iterator> const_found(count);
+    CHECK(const_list.lower_bound_batch(keys.begin(), keys.end(), const_lower.begin()) == const_lower.end());
+    CHECK(const_list.find_batch(keys.begin(), keys.end(), const_found.begin()) == const_found.end());
+    for (i = 0; i < count; ++i) {
+        CHECK(const_lower[i] == lower[i] && const_found[i] == found[i]);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    for (int round = 0; round < 100; ++round) {
+        list_type list;
+        std::set<int> reference;
+        const int bound = 1 + static_cast<int>(rng() % 20000);
+        const std::size_t size = rng() % 5000;
+        for (std::size_t i = 0; i < size; ++i) {
+            const int value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+            list.insert(value);
+            reference.insert(value);
+        }
+
+        // batches of every length around the width of a group, misses and keys past the end included
+        std::vector<int> keys(rng() % 100);
+        for (int& key : keys) {
+            key = static_cast<int>(rng() % static_cast<unsigned>(bound + 10)) - 5;
+        }
+        check_batches(list, keys);
+        check_batches(list, std::vector<int>());
+
+        // a forward only range of sorted keys
+        std::forward_list<int> sorted_keys(keys.begin(), keys.end());
+        sorted_keys.sort();
+        check_batches(list, sorted_keys);
+
+        // the same path as one search per key, one descent each
+        list.reset_stats();
+        std::vector<list_type::iterator> out(keys.size());
+        list.lower_bound_batch(keys.begin(), keys.end(), out.begin());
+        const skip_list::stats_snapshot batched = list.stats();
+        list.reset_stats();
+        for (int key : keys) {
+            list.lower_bound(key);
+        }
+        const skip_list::stats_snapshot searched = list.stats();
+        CHECK(batched.m_find_descents == keys.size());
+        CHECK(batched.m_hops == searched.m_hops);
+
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const auto ref = reference.lower_bound(keys[i]);
+            CHECK(ref == reference.end() ? out[i] == list.end() : *out[i] == *ref);
+        }
+    }
+
+    // an empty list gives end() for every key
+    {
+        list_type list;
+        const std::vector<int> keys{3, 1, 2};
+        std::vector<list_type::iterator> out;
+        list.find_batch(keys.begin(), keys.end(), std::back_inserter(out));
+        CHECK(out.size() == 3 && out[0] == list.end() && out[1] == list.end() && out[2] == list.end());
+    }
+
+    // transparent keys
+    {
+        string_list list;
+        std::vector<std::string> values;
+        for (int i = 0; i < 3000; ++i) {
+            values.push_back("key " + std::to_string(rng() % 4000));
+            list.insert(values.back());
+        }
+        std::vector<std::string_view> keys;
+        for (int i = 0; i < 3000; i += 7) {
+            keys.push_back(values[static_cast<std::size_t>(i)]);
+            keys.push_back("no such key");
+        }
+        check_batches(list, keys);
+        std::vector<string_list::iterator> found;
+        list.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            CHECK(i % 2 == 0 ? *found[i] == keys[i] : found[i] == list.end());
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+using list_type = skip_list::skip_list<int, std::less<int>, std::allocator<int>,
+                                       skip_list::level_generator<>, skip_list::counting_stats>;
+
+/// Same elements as the reference, and towers as tall as if inserted one by one.
+void check_built(const list_type& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+    auto rit = list.rbegin();
+    for (auto ref = reference.rbegin(); ref != reference.rend(); ++ref, ++rit) {
+        CHECK(rit != list.rend() && *rit == *ref);
+    }
+    for (std::size_t index = 0; index < reference.size(); index += 1 + reference.size() / 16) {
+        CHECK(list.index_of(list.nth(index)) == index);
+    }
+
+    const skip_list::stats_snapshot stats = list.stats();
+    std::size_t nodes = 0;
+    for (std::size_t count : stats.m_level_histogram) {
+        nodes += count;
+    }
+    CHECK(nodes == reference.size());
+    if (reference.size() >= 1000) {
+        // about half of the nodes have a single link
+        const double share = static_cast<double>(stats.m_level_histogram[0]) / static_cast<double>(nodes);
+        CHECK(share > 0.4 && share < 0.6);
+        CHECK(stats.m_levels >= 5);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    for (int round = 0; round < 100; ++round) {
+        const std::size_t count = rng() % 5000;
+        std::vector<int> values(count);
+        for (int& value : values) {
+            value = static_cast<int>(rng() % 10000);
+        }
+        const std::set<int> reference(values.begin(), values.end());
+        std::vector<int> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        const std::vector<int> unique(reference.begin(), reference.end());
+
+        // sorted input with duplicates: one comparison per element and no search
+        {
+            list_type list;
+            list.assign(sorted.begin(), sorted.end());
+            const skip_list::stats_snapshot stats = list.stats();
+            CHECK(stats.m_comparisons <= 2 * sorted.size());
+            CHECK(stats.m_insert_descents == 0);
+            CHECK(stats.m_allocations == stats.m_deallocations + reference.size());
+            check_built(list, reference);
+        }
+
+        // sorted and unique, no comparisons but the order assertion of a debug build
+        {
+            list_type list(skip_list::sorted_unique, unique.begin(), unique.end());
+            CHECK(list.stats().m_comparisons <= unique.size());
+            check_built(list, reference);
+        }
+
+        // unsorted input falls back to inserts for the elements out of order
+        {
+            list_type list(values.begin(), values.end());
+            check_built(list, reference);
+        }
+
+        // assign replaces the old contents
+        {
+            list_type list{-3, -2, -1};
+            list.assign(unique.rbegin(), unique.rend());
+            check_built(list, reference);
+            list.assign(sorted.begin(), sorted.end());
+            check_built(list, reference);
+        }
+
+        // a single pass input range
+        {
+            std::stringstream stream;
+            for (int value : sorted) {
+                stream << value << ' ';
+            }
+            list_type list;
+            list.assign(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+            check_built(list, reference);
+        }
+
+        // the copy is built the same way and leaves the source alone
+        {
+            const list_type list(sorted.begin(), sorted.end());
+            list_type copy(list);
+            CHECK(copy.stats().m_comparisons <= unique.size());
+            check_built(copy, reference);
+            check_built(list, reference);
+            copy = list_type{1, 2, 3};
+            copy = list;
+            check_built(copy, reference);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+using list_type = skip_list::skip_list<int, std::less<int>, std::allocator<int>,
+                                       skip_list::level_generator<>, skip_list::counting_stats>;
+using histogram = std::array<std::size_t, skip_list::stats_snapshot::max_levels>;
+
+void check_equal(const list_type& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    std::size_t index = 0;
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        CHECK(list.nth(index) == it);
+        CHECK(list.index_of(value) == index);
+        ++it;
+        ++index;
+    }
+    CHECK(it == list.end());
+    auto rit = list.rbegin();
+    for (auto ref = reference.rbegin(); ref != reference.rend(); ++ref, ++rit) {
+        CHECK(rit != list.rend() && *rit == *ref);
+    }
+    CHECK(rit == list.rend());
+}
+
+/// Inserts and erases at random, which scatters the nodes over the heap.
+void churn(list_type& list, std::set<int>& reference, std::mt19937& rng, int count, int bound)
+{
+    for (int i = 0; i < count; ++i) {
+        const int value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+        if (rng() % 3 == 0) {
+            list.erase(value);
+            reference.erase(value);
+        } else {
+            list.insert(value);
+            reference.insert(value);
+        }
+    }
+}
+
+/// The nodes of one slab follow each other in key order, a tower apart at most.
+void check_contiguous(const list_type& list)
+{
+    const std::uintptr_t max_gap = 64 * 1024;
+    const int* previous = nullptr;
+    for (const int& value : list) {
+        if (previous != nullptr) {
+            const std::uintptr_t from = reinterpret_cast<std::uintptr_t>(previous);
+            const std::uintptr_t to = reinterpret_cast<std::uintptr_t>(&value);
+            CHECK(to > from && to - from < max_gap);
+        }
+        previous = &value;
+    }
+}
+
+/// With p = 1/2 the rank r reaches level L when 2^L divides it, up to the top level.
+void check_ideal(const list_type& list)
+{
+    const skip_list::stats_snapshot stats = list.stats();
+    const std::size_t size = list.size();
+    for (std::size_t level = 0; level < stats.m_levels; ++level) {
+        CHECK(stats.m_level_histogram[level] == (size >> level) - (size >> (level + 1)));
+    }
+    CHECK(stats.m_level_histogram[stats.m_levels] == (size >> stats.m_levels));
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    for (int round = 0; round < 20; ++round) {
+        list_type list;
+        std::set<int> reference;
+        const int bound = 1 + static_cast<int>(rng() % 60000);
+        churn(list, reference, rng, 1 + static_cast<int>(rng() % 40000), bound);
+
+        // relocating keeps the heights, every old node is freed and one slab holds the new ones
+        const histogram heights = list.stats().m_level_histogram;
+        list.reset_stats();
+        list.compact();
+        skip_list::stats_snapshot stats = list.stats();
+        CHECK(stats.m_allocations == (reference.empty() ? 0 : 1));
+        CHECK(stats.m_deallocations == reference.size());
+        CHECK(stats.m_comparisons == 0);
+        CHECK(stats.m_level_histogram == heights);
+        check_equal(list, reference);
+        check_contiguous(list);
+
+        // compacting again moves the nodes out of the slab, which goes with the last of them
+        list.reset_stats();
+        list.shrink_to_fit();
+        stats = list.stats();
+        CHECK(stats.m_allocations == (reference.empty() ? 0 : 1) && stats.m_deallocations == stats.m_allocations);
+        check_contiguous(list);
+
+        // rebalancing gives every rank its ideal height
+        list.compact(true);
+        check_equal(list, reference);
+        check_contiguous(list);
+        check_ideal(list);
+
+        // the list goes on with nodes in slabs and nodes of their own
+        churn(list, reference, rng, 5000, bound);
+        check_equal(list, reference);
+
+        // slices of a pass with changes in between
+        std::size_t slices = 0;
+        bool done = false;
+        while (!done) {
+            done = list.compact_step(1 + rng() % 3000, slices % 2 == 0);
+            ++slices;
+            churn(list, reference, rng, 20, bound);
+        }
+        check_equal(list, reference);
+        // once a pass is done the next one starts at the front, though the list grew past where it ended
+        for (int value = bound; value < bound + 20; ++value) {
+            list.insert(value);
+            reference.insert(value);
+        }
+        CHECK(list.compact_step(list.size()));
+        check_equal(list, reference);
+        check_contiguous(list);
+    }
+
+    // more nodes than a slab holds
+    {
+        list_type list;
+        std::set<int> reference;
+        churn(list, reference, rng, 200000, 1000000);
+        list.reset_stats();
+        list.compact(true);
+        const skip_list::stats_snapshot stats = list.stats();
+        CHECK(stats.m_allocations == (reference.size() + 65535) / 65536);
+        check_equal(list, reference);
+        check_ideal(list);
+    }
+
+    // the parts of a split share slabs, each frees its nodes in a thread of its own
+    for (int round = 0; round < 10; ++round) {
+        list_type list;
+        std::set<int> reference;
+        churn(list, reference, rng, 20000, 30000);
+        list.compact();
+        const int key = static_cast<int>(rng() % 30000);
+        list_type rest = list.split(key);
+        std::thread other([&rest] {
+            while (!rest.empty()) {
+                rest.pop_front();
+            }
+        });
+        while (!list.empty()) {
+            list.pop_back();
+        }
+        other.join();
+        CHECK(list.empty() && rest.empty());
+    }
+
+    // values which own memory are moved into the slab
+    {
+        skip_list::skip_list<std::string> list;
+        std::set<std::string> reference;
+        for (int i = 0; i < 5000; ++i) {
+            const std::string value = "a somewhat long key to be moved " + std::to_string(rng() % 8000);
+            list.insert(value);
+            reference.insert(value);
+        }
+        list.compact(true);
+        auto it = list.begin();
+        for (const std::string& value : reference) {
+            CHECK(*it++ == value);
+        }
+        CHECK(it == list.end());
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "concurrent_skip_list.hpp"
+
+namespace
+{
+
+constexpr int thread_count = 8;
+constexpr int value_count = 80000;
+
+/**
+ * Every thread inserts its share of the values, erases a third of them and
+ * pops some, while the others do the same. Each value must end up exactly
+ * once either erased, popped or still in the list, and the list in order.
+ */
+void stress(bool spray)
+{
+    skip_list::concurrent_skip_list<int> list;
+    std::vector<std::vector<int>> popped(thread_count);
+    std::vector<std::vector<int>> erased_values(thread_count);
+    std::atomic<int> ready(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<int> mine;
+            for (int v = t; v < value_count; v += thread_count) {
+                mine.push_back(v);
+            }
+            std::mt19937 rng(static_cast<unsigned>(t));
+            std::shuffle(mine.begin(), mine.end(), rng);
+            ++ready;
+            while (ready.load() != thread_count) {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = 0; i < mine.size(); ++i) {
+                CHECK(list.insert(mine[i]).second);
+                if (i % 3 == 0 && list.erase(mine[i / 2]) == 1) {
+                    erased_values[static_cast<std::size_t>(t)].push_back(mine[i / 2]);
+                }
+                if (i % 5 == 0) {
+                    int value = 0;
+                    if (spray ? list.spray_pop_min(value, thread_count) : list.try_pop_min(value)) {
+                        popped[static_cast<std::size_t>(t)].push_back(value);
+                    }
+                }
+                if (i % 7 == 0) {
+                    list.contains(mine[i / 3]);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<int> seen(value_count, 0);
+    std::size_t gone = 0;
+    for (int t = 0; t < thread_count; ++t) {
+        for (int value : popped[static_cast<std::size_t>(t)]) {
+            ++seen[static_cast<std::size_t>(value)];
+        }
+        for (int value : erased_values[static_cast<std::size_t>(t)]) {
+            ++seen[static_cast<std::size_t>(value)];
+        }
+        gone += popped[static_cast<std::size_t>(t)].size() + erased_values[static_cast<std::size_t>(t)].size();
+    }
+    std::size_t size = 0;
+    int previous = -1;
+    for (int value : list) {
+        CHECK(previous < value);
+        previous = value;
+        ++seen[static_cast<std::size_t>(value)];
+        ++size;
+    }
+    CHECK(size == list.size());
+    CHECK(size + gone == static_cast<std::size_t>(value_count));
+    for (int count : seen) {
+        CHECK(count == 1);
+    }
+
+    // what is left pops in order from a single thread
+    int value = 0;
+    previous = -1;
+    while (list.try_pop_min(value)) {
+        CHECK(previous < value);
+        previous = value;
+        --size;
+    }
+    CHECK(size == 0 && list.empty());
+}
+
+/// Level generator telling the splits of the list's generator apart, every thread must draw from its own.
+class traced_generator
+{
+public:
+    traced_generator split()
+    {
+        traced_generator result;
+        result.m_inner = m_inner.split();
+        result.m_split = ++m_splits;
+        return result;
+    }
+
+    std::size_t operator()(std::size_t limit)
+    {
+        thread_local int owned = 0;
+        CHECK(m_split != 0);
+        if (owned == 0) {
+            owned = m_split;
+        }
+        CHECK(owned == m_split);
+        return m_inner(limit);
+    }
+
+    int splits() const { return m_splits; }
+
+private:
+    skip_list::level_generator<> m_inner{1};
+    int m_splits = 0;
+    int m_split = 0;
+};
+
+/// Each thread splits the generator of the list once, and the size is exact once the threads are done.
+void per_thread_state()
+{
+    skip_list::concurrent_skip_list<int, std::less<int>, std::allocator<int>, traced_generator> list;
+    std::atomic<int> inserted(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&list, &inserted, t] {
+            for (int v = t; v < value_count; v += thread_count) {
+                CHECK(list.insert(v).second);
+            }
+            ++inserted;
+            while (inserted.load() != thread_count) {
+                std::this_thread::yield();
+            }
+            // erase values of another thread, the size shares go negative
+            for (int v = (t + 1) % thread_count; v < value_count; v += 2 * thread_count) {
+                CHECK(list.erase(v) == 1);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    CHECK(list.get_level_generator().splits() == thread_count);
+    CHECK(list.size() == static_cast<std::size_t>(value_count / 2));
+    CHECK(static_cast<std::size_t>(std::distance(list.begin(), list.end())) == list.size());
+
+    list.clear();
+    CHECK(list.empty());
+    list.insert(1);
+    CHECK(list.size() == 1);
+    CHECK(list.get_level_generator().splits() == thread_count + 1);
+}
+
+} // namespace
+
+int main()
+{
+    stress(false);
+    stress(true);
+    per_thread_state();
+    return 0;
+}
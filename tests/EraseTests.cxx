@@ -0,0 +1,141 @@
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <set>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+using list_type = skip_list::skip_list<int, std::less<int>, std::allocator<int>,
+                                       skip_list::level_generator<>, skip_list::counting_stats>;
+
+/// Same elements in both directions, the backward links are kept by every erase too.
+void check_equal(const list_type& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    CHECK(list.empty() == reference.empty());
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+    auto rit = list.rbegin();
+    for (auto ref = reference.rbegin(); ref != reference.rend(); ++ref) {
+        CHECK(rit != list.rend() && *rit == *ref);
+        ++rit;
+    }
+    CHECK(rit == list.rend());
+    if (!reference.empty()) {
+        CHECK(list.front() == *reference.begin());
+        CHECK(list.back() == *reference.rbegin());
+    }
+}
+
+/// The iterator returned by an erase points at the reference successor.
+void check_next(const list_type& list, list_type::const_iterator it, std::set<int>::const_iterator ref,
+                const std::set<int>& reference)
+{
+    if (ref == reference.end()) {
+        CHECK(it == list.end());
+    } else {
+        CHECK(it != list.end() && *it == *ref);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+    auto random_value = [&rng](int bound) { return static_cast<int>(rng() % static_cast<unsigned>(bound)); };
+
+    for (int round = 0; round < 100; ++round) {
+        list_type list;
+        std::set<int> reference;
+        const int bound = 1 + random_value(4000);
+        for (int i = random_value(3000); i > 0; --i) {
+            const int value = random_value(bound);
+            const auto result = list.insert(value);
+            const auto expected = reference.insert(value);
+            CHECK(result.second == expected.second);
+            CHECK(*result.first == value);
+        }
+        check_equal(list, reference);
+
+        for (int i = 0; i < 500 && !reference.empty(); ++i) {
+            switch (random_value(5)) {
+            case 0: {
+                // by value, present or not
+                const int value = random_value(bound);
+                const auto ref = reference.upper_bound(value);
+                const bool present = reference.count(value) != 0;
+                const auto it = list.erase(value);
+                if (present) {
+                    check_next(list, it, ref, reference);
+                    reference.erase(value);
+                } else {
+                    CHECK(it == list.end());
+                }
+                break;
+            }
+            case 1: {
+                // by iterator, one descent to collect the predecessors
+                const int value = random_value(bound);
+                const auto pos = list.lower_bound(value);
+                if (pos == list.end()) {
+                    break;
+                }
+                const auto ref = std::next(reference.lower_bound(value));
+                const std::size_t descents = list.stats().m_erase_descents;
+                const auto it = list.erase(pos);
+                CHECK(list.stats().m_erase_descents == descents + 1);
+                check_next(list, it, ref, reference);
+                reference.erase(std::prev(ref));
+                break;
+            }
+            case 2: {
+                // a range
+                const int low = random_value(bound);
+                const int high = low + random_value(bound / 10 + 1);
+                const auto ref = reference.lower_bound(high);
+                const auto it = list.erase(list.lower_bound(low), list.lower_bound(high));
+                check_next(list, it, ref, reference);
+                reference.erase(reference.lower_bound(low), ref);
+                break;
+            }
+            case 3:
+                list.pop_front();
+                reference.erase(reference.begin());
+                break;
+            default:
+                list.pop_back();
+                reference.erase(std::prev(reference.end()));
+                break;
+            }
+        }
+        check_equal(list, reference);
+
+        // erase everything through the returned iterators
+        const std::size_t deallocations = list.stats().m_deallocations;
+        const std::size_t count = list.size();
+        for (auto it = list.begin(); it != list.end();) {
+            it = list.erase(it);
+        }
+        reference.clear();
+        check_equal(list, reference);
+        CHECK(list.stats().m_deallocations == deallocations + count);
+
+        // and the list works as before
+        for (int value = 0; value < 100; ++value) {
+            list.insert(value);
+            reference.insert(value);
+        }
+        check_equal(list, reference);
+    }
+    return 0;
+}
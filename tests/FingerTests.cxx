@@ -0,0 +1,184 @@
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+using list_type = skip_list::skip_list<int, std::less<int>, std::allocator<int>,
+                                       skip_list::level_generator<>, skip_list::counting_stats>;
+
+void check_equal(const list_type& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+    for (std::size_t index = 0; index < reference.size(); index += 1 + reference.size() / 32) {
+        CHECK(list.index_of(list.nth(index)) == index);
+    }
+}
+
+/// An iterator of the list picked at random, end() included.
+list_type::const_iterator random_position(const list_type& list, std::mt19937& rng)
+{
+    return list.nth(rng() % (list.size() + 1));
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    // a sorted run into a gap costs O(1) per insert with the hint after the previous one
+    {
+        list_type list;
+        std::set<int> reference;
+        for (int value = 0; value < 100000; value += 2) {
+            if (value < 50000 || value >= 70000) {
+                list.insert(value);
+                reference.insert(value);
+            }
+        }
+        list.reset_stats();
+        auto hint = list.lower_bound(50000);
+        for (int value = 50000; value < 60000; ++value) {
+            const auto it = list.insert(hint, value);
+            CHECK(*it == value);
+            reference.insert(value);
+            hint = std::next(it);
+        }
+        const std::size_t hinted = list.stats().m_comparisons;
+        check_equal(list, reference);
+
+        list.reset_stats();
+        for (int value = 60000; value < 70000; ++value) {
+            list.insert(value);
+            reference.insert(value);
+        }
+        const std::size_t searched = list.stats().m_comparisons;
+        CHECK(hinted * 3 < searched * 2);
+        check_equal(list, reference);
+    }
+
+    for (int round = 0; round < 50; ++round) {
+        list_type list;
+        std::set<int> reference;
+        const int bound = 1 + static_cast<int>(rng() % 5000);
+        for (int i = 0; i < 1000; ++i) {
+            const int value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+            list.insert(value);
+            reference.insert(value);
+        }
+
+        // any hint, right, wrong or end(), still inserts in the right place
+        for (int i = 0; i < 1000; ++i) {
+            const int value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+            const auto hint = random_position(list, rng);
+            const auto it = (i % 2 == 0) ? list.insert(hint, value) : list.emplace_hint(hint, value);
+            CHECK(it != list.end() && *it == value);
+            reference.insert(value);
+        }
+        check_equal(list, reference);
+
+        // a hint kept across other changes is still a valid iterator and a fine hint
+        std::vector<list_type::const_iterator> hints;
+        for (int i = 0; i < 20; ++i) {
+            hints.push_back(random_position(list, rng));
+        }
+        for (int i = 0; i < 500; ++i) {
+            const int value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+            bool hinted = false;
+            for (const auto& hint : hints) {
+                hinted = hinted || (hint != list.end() && *hint == value);
+            }
+            if (!hinted) {
+                list.erase(value);
+                reference.erase(value);
+            }
+            list.insert(value + bound);
+            reference.insert(value + bound);
+        }
+        for (const auto& hint : hints) {
+            const int value = static_cast<int>(rng() % static_cast<unsigned>(2 * bound));
+            CHECK(*list.insert(hint, value) == value);
+            reference.insert(value);
+        }
+        check_equal(list, reference);
+
+        // find_from agrees with find from any position
+        for (int i = 0; i < 1000; ++i) {
+            const int value = static_cast<int>(rng() % static_cast<unsigned>(2 * bound + 1));
+            const auto pos = random_position(list, rng);
+            const auto it = list.find_from(pos, value);
+            CHECK(it == list.find(value));
+            CHECK((it != list.end()) == (reference.count(value) != 0));
+        }
+
+        // the finger follows the searches, the results do not change
+        list.enable_finger();
+        CHECK(list.finger_enabled());
+        for (int i = 0; i < 2000; ++i) {
+            const int value = static_cast<int>(rng() % static_cast<unsigned>(2 * bound));
+            switch (rng() % 5) {
+            case 0:
+                CHECK(list.insert(value).second == reference.insert(value).second);
+                break;
+            case 1:
+                list.erase(value);
+                reference.erase(value);
+                break;
+            case 2: {
+                const auto it = list.lower_bound(value);
+                const auto ref = reference.lower_bound(value);
+                CHECK(ref == reference.end() ? it == list.end() : *it == *ref);
+                if (it != list.end()) {
+                    list.erase(it);
+                    reference.erase(ref);
+                }
+                break;
+            }
+            case 3:
+                CHECK((list.find(value) != list.end()) == (reference.count(value) != 0));
+                break;
+            default: {
+                const auto it = list.upper_bound(value);
+                const auto ref = reference.upper_bound(value);
+                CHECK(ref == reference.end() ? it == list.end() : *it == *ref);
+                break;
+            }
+            }
+        }
+        check_equal(list, reference);
+
+        // a scan in key order costs O(1) per search from the finger, a search from the top O(log n)
+        list.reset_stats();
+        for (int value : reference) {
+            CHECK(*list.find(value) == value);
+        }
+        const std::size_t near = list.stats().m_comparisons;
+        list.enable_finger(false);
+        CHECK(!list.finger_enabled());
+        list.reset_stats();
+        for (int value : reference) {
+            CHECK(*list.find(value) == value);
+        }
+        const std::size_t searched = list.stats().m_comparisons;
+        CHECK(near <= 10 * reference.size() + 64);
+        if (reference.size() >= 1000) {
+            CHECK(near * 3 < searched * 2);
+        }
+        check_equal(list, reference);
+    }
+    return 0;
+}
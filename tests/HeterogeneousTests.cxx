@@ -0,0 +1,132 @@
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+
+namespace
+{
+
+/// Element counting how it is built, looked up by its integer key.
+struct record
+{
+    static inline int s_constructed = 0;
+    static inline int s_copied = 0;
+
+    record(int key, std::string payload) : m_key(key), m_payload(std::move(payload)) { ++s_constructed; }
+    record(const record& other) : m_key(other.m_key), m_payload(other.m_payload) { ++s_copied; }
+    record(record&& other) noexcept : m_key(other.m_key), m_payload(std::move(other.m_payload)) { }
+    record& operator=(const record&) = default;
+    record& operator=(record&&) = default;
+
+    int m_key;
+    std::string m_payload;
+};
+
+struct by_key
+{
+    using is_transparent = void;
+
+    bool operator()(const record& lhs, const record& rhs) const { return lhs.m_key < rhs.m_key; }
+    bool operator()(const record& lhs, int rhs) const { return lhs.m_key < rhs; }
+    bool operator()(int lhs, const record& rhs) const { return lhs < rhs.m_key; }
+};
+
+using record_list = skip_list::skip_list<record, by_key>;
+using string_list = skip_list::skip_list<std::string, std::less<>>;
+
+void check_equal(const string_list& list, const std::set<std::string, std::less<>>& reference)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (const std::string& value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    // string_view and C string keys against std::set with the same transparent comparator
+    for (int round = 0; round < 50; ++round) {
+        string_list list;
+        std::set<std::string, std::less<>> reference;
+        for (int i = 0; i < 1000; ++i) {
+            std::string value = "key " + std::to_string(rng() % 2000);
+            const auto result = list.try_emplace(std::string_view(value));
+            CHECK(result.second == reference.insert(value).second);
+            CHECK(*result.first == value);
+        }
+        check_equal(list, reference);
+        for (int i = 0; i < 1000; ++i) {
+            const std::string value = "key " + std::to_string(rng() % 2000);
+            const std::string_view key(value);
+            const auto it = list.find(key);
+            const auto ref = reference.find(key);
+            CHECK((it == list.end()) == (ref == reference.end()));
+            const auto lower = list.lower_bound(key);
+            const auto upper = list.upper_bound(key);
+            CHECK(lower == list.end() ? reference.lower_bound(key) == reference.end() : *lower == *reference.lower_bound(key));
+            CHECK(upper == list.end() ? reference.upper_bound(key) == reference.end() : *upper == *reference.upper_bound(key));
+            if (i % 3 == 0) {
+                list.erase(key);
+                reference.erase(value);
+            }
+        }
+        check_equal(list, reference);
+        CHECK(list.find("no such key") == list.end());
+    }
+
+    // lookups by key build no element, try_emplace builds one only for a new key
+    {
+        record_list list;
+        std::set<int> reference;
+        for (int i = 0; i < 2000; ++i) {
+            const int key = static_cast<int>(rng() % 1000);
+            const int constructed = record::s_constructed;
+            const bool inserted = list.try_emplace(key, "payload of " + std::to_string(key)).second;
+            CHECK(inserted == reference.insert(key).second);
+            CHECK(record::s_constructed == constructed + (inserted ? 1 : 0));
+        }
+        const int constructed = record::s_constructed;
+        for (int key = -10; key < 1010; ++key) {
+            const auto it = list.find(key);
+            CHECK((it != list.end()) == (reference.count(key) != 0));
+            if (it != list.end()) {
+                CHECK(it->m_key == key && it->m_payload == "payload of " + std::to_string(key));
+            }
+            const auto lower = list.lower_bound(key);
+            CHECK(lower == list.end() || lower->m_key == *reference.lower_bound(key));
+        }
+        for (int key = 0; key < 1000; key += 3) {
+            list.erase(key);
+            reference.erase(key);
+        }
+        CHECK(record::s_constructed == constructed);
+        CHECK(list.size() == reference.size());
+
+        // emplace builds the element once, in its node, and insert of an rvalue moves it
+        const int copied = record::s_copied;
+        list.emplace(5000, "emplaced");
+        list.insert(record(5001, "moved"));
+        CHECK(record::s_copied == copied);
+        CHECK(list.find(5000)->m_payload == "emplaced");
+        CHECK(list.find(5001)->m_payload == "moved");
+
+        // an emplace of a present key drops what it built and keeps the old element
+        const auto result = list.emplace(5000, "duplicate");
+        CHECK(!result.second && result.first->m_payload == "emplaced");
+        CHECK(record::s_copied == copied);
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+
+namespace
+{
+
+/// A small trivially copyable key, copied into the towers.
+struct tower_key
+{
+    std::int64_t m_value;
+
+    bool operator<(const tower_key& other) const { return m_value < other.m_value; }
+    bool operator==(const tower_key& other) const { return m_value == other.m_value; }
+};
+
+} // namespace
+
+template <>
+struct skip_list::key_in_tower<tower_key> : std::true_type { };
+
+namespace
+{
+
+using list_type = skip_list::skip_list<tower_key>;
+using reference_type = std::set<tower_key>;
+
+constexpr std::int64_t bound = 3000;
+
+tower_key key(std::int64_t value)
+{
+    return tower_key{value};
+}
+
+tower_key random_key(std::mt19937& rng)
+{
+    return key(static_cast<std::int64_t>(rng() % bound));
+}
+
+/// A stale copy in a tower sends some search the wrong way, so every key of the range is searched.
+void check_equal(const list_type& list, const reference_type& reference)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (const tower_key& value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+    for (std::int64_t value = -1; value <= bound + 1; ++value) {
+        const auto lower = list.lower_bound(key(value));
+        const auto ref = reference.lower_bound(key(value));
+        CHECK(ref == reference.end() ? lower == list.end() : *lower == *ref);
+        CHECK((list.find(key(value)) != list.end()) == (reference.count(key(value)) != 0));
+        const auto upper = list.upper_bound(key(value));
+        const auto ref_upper = reference.upper_bound(key(value));
+        CHECK(ref_upper == reference.end() ? upper == list.end() : *upper == *ref_upper);
+        CHECK(list.index_of(key(value)) == static_cast<std::size_t>(std::distance(reference.begin(), ref)));
+    }
+}
+
+void fill(list_type& list, reference_type& reference, std::mt19937& rng, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        const tower_key value = random_key(rng);
+        CHECK(list.insert(value).second == reference.insert(value).second);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    for (int round = 0; round < 20; ++round) {
+        list_type list;
+        reference_type reference;
+
+        // every way of linking a node refreshes the copies of its predecessors
+        fill(list, reference, rng, 1000);
+        for (int i = 0; i < 300; ++i) {
+            const tower_key value = random_key(rng);
+            list.insert(list.nth(rng() % (list.size() + 1)), value);
+            list.emplace(random_key(rng));
+            list.emplace_hint(list.lower_bound(value), key(value.m_value + 1));
+        }
+        reference.clear();
+        reference.insert(list.begin(), list.end());
+        check_equal(list, reference);
+
+        // and every way of unlinking one
+        for (int i = 0; i < 300; ++i) {
+            const tower_key value = random_key(rng);
+            list.erase(value);
+            reference.erase(value);
+            const auto it = list.lower_bound(random_key(rng));
+            if (it != list.end()) {
+                reference.erase(*it);
+                list.erase(it);
+            }
+        }
+        list.pop_front();
+        reference.erase(reference.begin());
+        list.pop_back();
+        reference.erase(std::prev(reference.end()));
+        CHECK(list.extract_min() == *reference.begin());
+        reference.erase(reference.begin());
+        const std::size_t first = rng() % list.size();
+        const std::size_t last = first + rng() % (list.size() - first);
+        list.erase(list.nth(first), list.nth(last));
+        reference.erase(std::next(reference.begin(), static_cast<std::ptrdiff_t>(first)),
+                        std::next(reference.begin(), static_cast<std::ptrdiff_t>(last)));
+        check_equal(list, reference);
+
+        // splicing relinks the ends of the parts
+        const tower_key middle = random_key(rng);
+        list_type rest = list.split(middle);
+        reference_type rest_reference(reference.lower_bound(middle), reference.end());
+        reference.erase(reference.lower_bound(middle), reference.end());
+        check_equal(list, reference);
+        check_equal(rest, rest_reference);
+        list.join(rest);
+        reference.insert(rest_reference.begin(), rest_reference.end());
+        check_equal(list, reference);
+        const list_type extracted = list.extract(list.nth(list.size() / 4), list.nth(list.size() / 2));
+        reference_type extracted_reference(extracted.begin(), extracted.end());
+        for (const tower_key& value : extracted_reference) {
+            reference.erase(value);
+        }
+        check_equal(list, reference);
+        check_equal(extracted, extracted_reference);
+
+        // merges and set operations build or relink whole chains
+        list_type other;
+        reference_type other_reference;
+        fill(other, other_reference, rng, 1 + rng() % 1500);
+        const list_type united = set_union(list, other);
+        reference_type united_reference = reference;
+        united_reference.insert(other_reference.begin(), other_reference.end());
+        check_equal(united, united_reference);
+        list.merge(other);
+        reference.merge(other_reference);
+        check_equal(list, reference);
+        check_equal(other, other_reference);
+
+        // copies, moves, bulk builds and compaction write the links anew
+        list_type copy(list);
+        check_equal(copy, reference);
+        list_type moved(std::move(copy));
+        check_equal(moved, reference);
+        std::vector<tower_key> sorted(reference.begin(), reference.end());
+        moved.assign(skip_list::sorted_unique, sorted.begin(), sorted.end());
+        check_equal(moved, reference);
+        list.compact(true);
+        check_equal(list, reference);
+        for (int i = 0; i < 200; ++i) {
+            const tower_key value = random_key(rng);
+            list.erase(value);
+            reference.erase(value);
+        }
+        while (list.compact_step(64, true)) {
+        }
+        check_equal(list, reference);
+
+        // the finger and the batches search through the copies as well
+        list.enable_finger();
+        for (int i = 0; i < 1000; ++i) {
+            const tower_key value = random_key(rng);
+            if (i % 2 == 0) {
+                CHECK(list.insert(value).second == reference.insert(value).second);
+            } else {
+                CHECK((list.find(value) != list.end()) == (reference.count(value) != 0));
+            }
+        }
+        check_equal(list, reference);
+        list.enable_finger(false);
+        std::vector<tower_key> keys;
+        for (int i = 0; i < 100; ++i) {
+            keys.push_back(random_key(rng));
+        }
+        std::vector<list_type::iterator> found;
+        list.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            CHECK(found[i] == list.find(keys[i]));
+        }
+    }
+    return 0;
+}
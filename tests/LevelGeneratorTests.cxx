@@ -0,0 +1,133 @@
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ratio>
+#include <set>
+#include <thread>
+
+#include "check.hpp"
+#include "level_generator.hpp"
+#include "skip_list.hpp"
+
+namespace
+{
+
+constexpr std::size_t draws = 1 << 20;
+
+/// The share of every level is close to p^L * (1 - p), and no level exceeds the limit.
+template <typename Generator>
+void check_distribution(Generator generator, double p)
+{
+    constexpr std::size_t limit = 20;
+    std::array<std::size_t, limit + 1> histogram{};
+    for (std::size_t i = 0; i < draws; ++i) {
+        const std::size_t level = generator(limit);
+        CHECK(level <= limit);
+        ++histogram[level];
+    }
+    double expected = 1 - p;
+    for (std::size_t level = 0; level < 6; ++level) {
+        const double share = static_cast<double>(histogram[level]) / static_cast<double>(draws);
+        CHECK(std::fabs(share - expected) < 0.01);
+        expected *= p;
+    }
+
+    // a small limit takes every taller draw
+    for (std::size_t i = 0; i < 1000; ++i) {
+        CHECK(generator(0) == 0);
+        CHECK(generator(2) <= 2);
+    }
+}
+
+template <typename Generator>
+void check_reproducible(std::uint64_t seed)
+{
+    Generator first(seed);
+    Generator second(seed);
+    Generator other(seed + 1);
+    std::size_t differences = 0;
+    for (std::size_t i = 0; i < 10000; ++i) {
+        const std::size_t level = first(31);
+        CHECK(second(31) == level);
+        differences += other(31) != level ? 1 : 0;
+    }
+    CHECK(differences > 0);
+
+    // seed() restarts the sequence
+    first.seed(seed);
+    Generator again(seed);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        CHECK(first(31) == again(31));
+    }
+}
+
+using list_type = skip_list::skip_list<int>;
+
+list_type seeded_list(std::uint64_t seed, const std::set<int>& values)
+{
+    list_type list;
+    list.get_level_generator().seed(seed);
+    for (int value : values) {
+        list.insert(value);
+    }
+    return list;
+}
+
+} // namespace
+
+int main()
+{
+    check_distribution(skip_list::half_level_generator(1), 0.5);
+    check_distribution(skip_list::quarter_level_generator(2), 0.25);
+    check_distribution(skip_list::inv_e_level_generator(3), 0.367879441171);
+    check_distribution(skip_list::level_generator<std::ratio<1, 3>>(4), 1.0 / 3);
+
+    check_reproducible<skip_list::half_level_generator>(0);
+    check_reproducible<skip_list::quarter_level_generator>(42);
+    check_reproducible<skip_list::inv_e_level_generator>(~std::uint64_t(0));
+
+    // default constructed generators all differ, also across threads
+    {
+        skip_list::half_level_generator first;
+        skip_list::half_level_generator second;
+        std::size_t differences = 0;
+        std::thread([&differences, &first] {
+            skip_list::half_level_generator other;
+            for (std::size_t i = 0; i < 1000; ++i) {
+                differences += other(31) != first(31) ? 1 : 0;
+            }
+        }).join();
+        for (std::size_t i = 0; i < 1000; ++i) {
+            differences += first(31) != second(31) ? 1 : 0;
+        }
+        CHECK(differences > 0);
+    }
+
+    // the same seed and the same inserts build the same towers
+    std::mt19937 rng(2024);
+    for (int round = 0; round < 50; ++round) {
+        std::set<int> values;
+        const int count = static_cast<int>(rng() % 5000);
+        for (int i = 0; i < count; ++i) {
+            values.insert(static_cast<int>(rng() % 100000));
+        }
+        const std::uint64_t seed = rng();
+        const list_type first = seeded_list(seed, values);
+        const list_type second = seeded_list(seed, values);
+        const skip_list::stats_snapshot lhs = first.stats();
+        const skip_list::stats_snapshot rhs = second.stats();
+        CHECK(lhs.m_size == values.size() && rhs.m_size == values.size());
+        CHECK(lhs.m_levels == rhs.m_levels);
+        CHECK(lhs.m_level_histogram == rhs.m_level_histogram);
+        CHECK(lhs.m_node_bytes == rhs.m_node_bytes);
+        auto it = first.begin();
+        for (int value : values) {
+            CHECK(it != first.end() && *it == value);
+            ++it;
+        }
+        CHECK(it == first.end());
+    }
+    return 0;
+}
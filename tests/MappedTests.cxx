@@ -0,0 +1,166 @@
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "check.hpp"
+#include "mapped_skip_list.hpp"
+
+namespace
+{
+
+using list_type = skip_list::mapped_skip_list<long>;
+
+void check_equal(const list_type& list, const std::set<long>& reference)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (long value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+    for (auto rit = list.rbegin(); rit != list.rend(); ++rit) {
+        CHECK(reference.count(*rit) == 1);
+    }
+}
+
+/// Create, fill past the first growth, close, and find everything again on every reopen.
+void round_trip(const std::string& path)
+{
+    std::mt19937 rng(11);
+    std::set<long> reference;
+    {
+        list_type list;
+        list.create(path, 4096);
+        for (int i = 0; i < 20000; ++i) {
+            const long value = static_cast<long>(rng() % 50000);
+            CHECK(list.insert(value).second == reference.insert(value).second);
+        }
+        check_equal(list, reference);
+        list.close();
+        CHECK(!list.is_open());
+    }
+    for (int round = 0; round < 3; ++round) {
+        list_type list;
+        list.open(path);
+        check_equal(list, reference);
+        for (int i = 0; i < 5000; ++i) {
+            const long value = static_cast<long>(rng() % 50000);
+            if (i % 2 == 0) {
+                CHECK(list.erase(value) == reference.erase(value));
+            } else {
+                CHECK(list.insert(value).second == reference.insert(value).second);
+            }
+        }
+        check_equal(list, reference);
+        // the destructor closes the file
+    }
+    list_type list;
+    list.open(path);
+    check_equal(list, reference);
+    list.clear();
+    list.close();
+    list.open(path);
+    CHECK(list.empty() && list.begin() == list.end());
+}
+
+/// A process which changes the list and dies before it syncs leaves the file as the last sync made it.
+void unsynced_change(const std::string& path)
+{
+    std::set<long> reference;
+    {
+        list_type list;
+        list.create(path, 4096);
+        for (long value = 0; value < 3000; ++value) {
+            list.insert(value * 7 % 10007);
+            reference.insert(value * 7 % 10007);
+        }
+    }
+    for (int round = 0; round < 2; ++round) {
+        const pid_t child = ::fork();
+        CHECK(child >= 0);
+        if (child == 0) {
+            list_type list;
+            list.open(path);
+            // enough to grow the file, then some erases and a clear on the second round
+            for (long value = 10007; value < 30000; ++value) {
+                list.insert(value);
+            }
+            for (long value = 0; value < 500; ++value) {
+                list.erase(value);
+            }
+            if (round == 1) {
+                list.clear();
+            }
+            ::_exit(0); // no destructor, no sync
+        }
+        int status = 0;
+        CHECK(::waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+        list_type list;
+        list.open(path);
+        check_equal(list, reference);
+        // and it is still usable
+        CHECK(list.insert(-1 - round).second);
+        reference.insert(-1 - round);
+        list.sync();
+    }
+    list_type list;
+    list.open(path);
+    check_equal(list, reference);
+}
+
+/// create() or open() on an open list syncs the file it had before letting it go.
+void switch_files(const std::string& path, const std::string& other_path)
+{
+    {
+        list_type other;
+        other.create(other_path, 4096);
+        other.insert(-1);
+    }
+    std::set<long> reference;
+    list_type list;
+    for (int round = 0; round < 2; ++round) {
+        list.create(path, 4096);
+        reference.clear();
+        for (long value = 0; value < 100; ++value) {
+            list.insert(value * 3);
+            reference.insert(value * 3);
+        }
+        if (round == 0) {
+            list.open(other_path);
+            check_equal(list, std::set<long>{-1});
+        } else {
+            list.create(other_path, 4096);
+            CHECK(list.empty());
+        }
+        list.close();
+        list.open(path);
+        CHECK(list.size() == 100);
+        check_equal(list, reference);
+    }
+    // a change to a reopened file is kept across a switch too
+    list.insert(1000);
+    reference.insert(1000);
+    list.open(other_path);
+    list.open(path);
+    check_equal(list, reference);
+}
+
+} // namespace
+
+int main()
+{
+    const std::string path = "MappedTests." + std::to_string(::getpid()) + ".sl";
+    round_trip(path);
+    unsynced_change(path);
+    const std::string other_path = path + ".other";
+    switch_files(path, other_path);
+    std::remove(path.c_str());
+    std::remove(other_path.c_str());
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+#include "pool_allocator.hpp"
+#include "skip_list.hpp"
+#include "skip_map.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+/// Allocator told apart by its id, which does not propagate on move assignment.
+template <typename T>
+struct tagged_allocator
+{
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::false_type;
+    using is_always_equal = std::false_type;
+
+    explicit tagged_allocator(int id = 0) : m_id(id) { }
+    template <typename U>
+    tagged_allocator(const tagged_allocator<U>& other) : m_id(other.m_id) { }
+
+    T* allocate(std::size_t count) { return std::allocator<T>().allocate(count); }
+    void deallocate(T* ptr, std::size_t count) { std::allocator<T>().deallocate(ptr, count); }
+
+    template <typename U>
+    bool operator==(const tagged_allocator<U>& other) const { return m_id == other.m_id; }
+    template <typename U>
+    bool operator!=(const tagged_allocator<U>& other) const { return m_id != other.m_id; }
+
+    int m_id;
+};
+
+using list_type = skip_list::skip_list<int>;
+using counted_list = skip_list::skip_list<int, std::less<int>, std::allocator<int>,
+                                          skip_list::level_generator<>, skip_list::counting_stats>;
+using tagged_list = skip_list::skip_list<int, std::less<int>, tagged_allocator<int>>;
+using pool_list = skip_list::skip_list<int, std::less<int>, skip_list::pool_allocator<int>>;
+
+static_assert(std::is_nothrow_move_constructible_v<list_type>);
+static_assert(std::is_nothrow_move_assignable_v<list_type>);
+static_assert(std::is_nothrow_move_constructible_v<tagged_list>);
+static_assert(!std::is_nothrow_move_assignable_v<tagged_list>);
+static_assert(std::is_nothrow_move_constructible_v<skip_list::skip_map<int, int>>);
+
+/// Same elements both ways, and the rank of every element right.
+template <typename List>
+void check_equal(const List& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    CHECK(list.empty() == reference.empty());
+    std::size_t index = 0;
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        CHECK(list.nth(index) == it);
+        CHECK(list.index_of(value) == index);
+        ++it;
+        ++index;
+    }
+    CHECK(it == list.end());
+    auto rit = list.rbegin();
+    for (auto ref = reference.rbegin(); ref != reference.rend(); ++ref, ++rit) {
+        CHECK(rit != list.rend() && *rit == *ref);
+    }
+    CHECK(rit == list.rend());
+}
+
+template <typename List>
+void fill(List& list, std::set<int>& reference, std::mt19937& rng, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        const int value = static_cast<int>(rng() % 10000);
+        list.insert(value);
+        reference.insert(value);
+    }
+}
+
+/// Inserts and erases after a move, the list which is left behind included.
+template <typename List>
+void exercise(List& list, std::set<int>& reference, std::mt19937& rng)
+{
+    for (int i = 0; i < 300; ++i) {
+        const int value = static_cast<int>(rng() % 10000);
+        if (i % 3 == 0) {
+            list.erase(value);
+            reference.erase(value);
+        } else {
+            list.insert(value);
+            reference.insert(value);
+        }
+    }
+    check_equal(list, reference);
+}
+
+std::vector<const int*> addresses(const list_type& list)
+{
+    std::vector<const int*> result;
+    for (const int& value : list) {
+        result.push_back(&value);
+    }
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    for (int round = 0; round < 50; ++round) {
+        // an end() taken on the empty list stays the end of that list
+        list_type list;
+        const auto end = list.end();
+        std::set<int> reference;
+        fill(list, reference, rng, rng() % 2000);
+        CHECK(list.end() == end);
+        list.clear();
+        reference.clear();
+        CHECK(list.end() == end && list.begin() == end);
+        CHECK(*list.insert(end, 5) == 5 && list.end() == end);
+        reference.insert(5);
+        fill(list, reference, rng, rng() % 2000);
+
+        // a move relinks the nodes, which keep their addresses
+        const std::vector<const int*> nodes = addresses(list);
+        list_type moved(std::move(list));
+        CHECK(list.empty() && list.begin() == list.end() && list.end() == end);
+        CHECK(addresses(moved) == nodes);
+        check_equal(moved, reference);
+        std::set<int> list_reference;
+        exercise(list, list_reference, rng);
+        exercise(moved, reference, rng);
+
+        // move assignment frees the old nodes and takes the others
+        list_type assigned;
+        std::set<int> assigned_reference;
+        fill(assigned, assigned_reference, rng, rng() % 500);
+        const auto assigned_end = assigned.end();
+        const std::vector<const int*> moved_nodes = addresses(moved);
+        assigned = std::move(moved);
+        CHECK(assigned.end() == assigned_end && addresses(assigned) == moved_nodes);
+        check_equal(assigned, reference);
+        check_equal(moved, std::set<int>());
+        assigned = std::move(assigned);
+        check_equal(assigned, reference);
+
+        // swap exchanges the nodes, each list keeps its end
+        const auto first = assigned.empty() ? nullptr : &*assigned.begin();
+        swap(list, assigned);
+        CHECK(list.end() == end && assigned.end() == assigned_end);
+        CHECK(list.empty() || &*list.begin() == first);
+        check_equal(list, reference);
+        check_equal(assigned, list_reference);
+        list_type empty;
+        swap(empty, list);
+        swap(list, empty);
+        check_equal(list, reference);
+        check_equal(empty, std::set<int>());
+        exercise(list, reference, rng);
+        exercise(assigned, list_reference, rng);
+
+        // with the allocator given, equal allocators relink the nodes as well
+        const std::vector<const int*> list_nodes = addresses(list);
+        list_type with_allocator(std::move(list), list.get_allocator());
+        CHECK(list.empty() && addresses(with_allocator) == list_nodes);
+        check_equal(with_allocator, reference);
+    }
+
+    // the lists of a vector move when it grows and stay whole
+    {
+        std::vector<list_type> lists;
+        std::vector<std::set<int>> references;
+        for (int i = 0; i < 100; ++i) {
+            lists.emplace_back();
+            references.emplace_back();
+            fill(lists.back(), references.back(), rng, rng() % 100);
+        }
+        for (std::size_t i = 0; i < lists.size(); ++i) {
+            check_equal(lists[i], references[i]);
+            exercise(lists[i], references[i], rng);
+        }
+    }
+
+    // a copy has the same tower heights and makes no comparison
+    for (int round = 0; round < 20; ++round) {
+        counted_list list;
+        std::set<int> reference;
+        fill(list, reference, rng, rng() % 3000);
+        const counted_list copy(list);
+        const skip_list::stats_snapshot stats = copy.stats();
+        CHECK(stats.m_comparisons == 0 && stats.m_insert_descents == 0);
+        CHECK(stats.m_allocations == reference.size());
+        CHECK(stats.m_level_histogram == list.stats().m_level_histogram);
+        CHECK(stats.m_levels == list.stats().m_levels);
+        check_equal(copy, reference);
+        counted_list assigned;
+        fill(assigned, reference, rng, 100);
+        assigned = copy;
+        CHECK(assigned.stats().m_level_histogram == copy.stats().m_level_histogram);
+        CHECK(std::equal(assigned.begin(), assigned.end(), copy.begin(), copy.end()));
+    }
+
+    // unequal allocators which do not propagate move the values one by one
+    {
+        tagged_list list(tagged_allocator<int>(1));
+        tagged_list other(tagged_allocator<int>(2));
+        std::set<int> reference;
+        fill(other, reference, rng, 1000);
+        list.insert(-1);
+        const auto end = list.end();
+        list = std::move(other);
+        CHECK(list.get_allocator().m_id == 1 && list.end() == end);
+        check_equal(list, reference);
+        check_equal(other, std::set<int>());
+        tagged_list moved(std::move(list), tagged_allocator<int>(3));
+        CHECK(moved.get_allocator().m_id == 3);
+        check_equal(moved, reference);
+        check_equal(list, std::set<int>());
+    }
+
+    // a list which drops its whole arena keeps its sentinels
+    {
+        pool_list list;
+        const auto end = list.end();
+        std::set<int> reference;
+        fill(list, reference, rng, 1000);
+        list.clear();
+        CHECK(list.empty() && list.end() == end && list.begin() == end);
+        reference.clear();
+        fill(list, reference, rng, 1000);
+        check_equal(list, reference);
+        pool_list moved(std::move(list));
+        CHECK(list.end() == end);
+        check_equal(moved, reference);
+        reference.clear();
+        exercise(list, reference, rng);
+    }
+    return 0;
+}
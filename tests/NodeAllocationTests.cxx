@@ -0,0 +1,136 @@
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <set>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+
+namespace
+{
+
+struct counters
+{
+    std::size_t m_allocations = 0;
+    std::size_t m_live = 0;
+};
+
+/// Stateful allocator recording every block it gives out.
+template <typename T>
+class counting_allocator
+{
+    template <typename U> friend class counting_allocator;
+
+public:
+    using value_type = T;
+
+    explicit counting_allocator(counters* stats) : m_counters(stats) { }
+    template <typename U>
+    counting_allocator(const counting_allocator<U>& other) noexcept : m_counters(other.m_counters) { }
+
+    T* allocate(std::size_t count)
+    {
+        ++m_counters->m_allocations;
+        ++m_counters->m_live;
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* ptr, std::size_t count)
+    {
+        CHECK(m_counters->m_live > 0);
+        --m_counters->m_live;
+        std::allocator<T>().deallocate(ptr, count);
+    }
+
+    template <typename U>
+    bool operator==(const counting_allocator<U>& other) const { return m_counters == other.m_counters; }
+    template <typename U>
+    bool operator!=(const counting_allocator<U>& other) const { return m_counters != other.m_counters; }
+
+private:
+    counters* m_counters;
+
+}; // counting_allocator
+
+/// Element counting its live instances, to catch leaked or doubly destroyed values.
+struct tracked
+{
+    static inline int s_live = 0;
+
+    tracked(int value) : m_value(value) { ++s_live; }
+    tracked(const tracked& other) : m_value(other.m_value) { ++s_live; }
+    ~tracked() { --s_live; }
+    tracked& operator=(const tracked&) = default;
+
+    bool operator<(const tracked& other) const { return m_value < other.m_value; }
+
+    int m_value;
+};
+
+using list_type = skip_list::skip_list<tracked, std::less<tracked>, counting_allocator<tracked>>;
+
+void check_equal(const list_type& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && it->m_value == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    for (int round = 0; round < 100; ++round) {
+        counters stats;
+        {
+            list_type list{counting_allocator<tracked>(&stats)};
+            CHECK(list.get_allocator() == counting_allocator<tracked>(&stats));
+            std::set<int> reference;
+
+            // the sentinels take a fixed number of blocks, then one block per node
+            list.insert(-1);
+            reference.insert(-1);
+            const std::size_t fixed = stats.m_live - 1;
+            const int count = static_cast<int>(rng() % 2000);
+            for (int i = 0; i < count; ++i) {
+                const int value = static_cast<int>(rng() % 4000);
+                const std::size_t before = stats.m_allocations;
+                const bool inserted = list.insert(value).second;
+                CHECK(inserted == reference.insert(value).second);
+                // a duplicate allocates nothing, a new element exactly one block
+                CHECK(stats.m_allocations == before + (inserted ? 1 : 0));
+                CHECK(stats.m_live == fixed + reference.size());
+            }
+            check_equal(list, reference);
+            CHECK(tracked::s_live == static_cast<int>(reference.size()));
+
+            // erasing gives the block of the node back at once
+            for (int i = 0; i < count / 2; ++i) {
+                const int value = static_cast<int>(rng() % 4000);
+                list.erase(value);
+                reference.erase(value);
+                CHECK(stats.m_live == fixed + reference.size());
+            }
+            check_equal(list, reference);
+            CHECK(tracked::s_live == static_cast<int>(reference.size()));
+
+            // a copy allocates through a copy of the same allocator
+            list_type copy(list);
+            CHECK(copy.get_allocator() == list.get_allocator());
+            check_equal(copy, reference);
+            CHECK(tracked::s_live == 2 * static_cast<int>(reference.size()));
+            copy.clear();
+            CHECK(tracked::s_live == static_cast<int>(reference.size()));
+        }
+        // nothing leaks and nothing is freed twice
+        CHECK(stats.m_live == 0);
+        CHECK(tracked::s_live == 0);
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+/// A composite key without a default constructor or numeric limits, which counts its live copies.
+struct record
+{
+    record(std::string name, int id) : m_name(std::move(name)), m_id(id) { ++live; }
+    record(const record& other) : m_name(other.m_name), m_id(other.m_id) { ++live; }
+    record(record&& other) noexcept : m_name(std::move(other.m_name)), m_id(other.m_id) { ++live; }
+    record& operator=(const record&) = default;
+    record& operator=(record&&) = default;
+    ~record() { --live; }
+
+    bool operator<(const record& other) const { return m_name < other.m_name || (m_name == other.m_name && m_id < other.m_id); }
+    bool operator==(const record& other) const { return m_name == other.m_name && m_id == other.m_id; }
+
+    std::string m_name;
+    int m_id;
+
+    static std::ptrdiff_t live;
+};
+
+std::ptrdiff_t record::live = 0;
+
+template <typename T, typename Compare>
+using counted_list = skip_list::skip_list<T, Compare, std::allocator<T>, skip_list::level_generator<>, skip_list::counting_stats>;
+
+std::size_t sum(const std::array<std::size_t, skip_list::stats_snapshot::max_levels>& counts)
+{
+    std::size_t total = 0;
+    for (std::size_t count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+template <typename List, typename Set>
+void check_equal(const List& list, const Set& reference)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (const auto& value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+    auto rit = list.rbegin();
+    for (auto ref = reference.rbegin(); ref != reference.rend(); ++ref, ++rit) {
+        CHECK(rit != list.rend() && *rit == *ref);
+    }
+    CHECK(rit == list.rend());
+}
+
+/// Every search against the reference, one comparison per hop and per level, and one for equality.
+template <typename List, typename Set>
+void check_search(List& list, const Set& reference, const typename List::value_type& value)
+{
+    list.reset_stats();
+    const bool found = list.find(value) != list.end();
+    const skip_list::stats_snapshot stats = list.stats();
+    CHECK(found == (reference.count(value) != 0));
+    CHECK(stats.m_comparisons >= sum(stats.m_hops));
+    CHECK(stats.m_comparisons <= sum(stats.m_hops) + stats.m_levels + 2);
+
+    const auto lower = list.lower_bound(value);
+    const auto ref_lower = reference.lower_bound(value);
+    CHECK(ref_lower == reference.end() ? lower == list.end() : *lower == *ref_lower);
+    const auto upper = list.upper_bound(value);
+    const auto ref_upper = reference.upper_bound(value);
+    CHECK(ref_upper == reference.end() ? upper == list.end() : *upper == *ref_upper);
+}
+
+template <typename List, typename Set, typename Make>
+void exercise(List& list, Set& reference, std::mt19937& rng, Make make)
+{
+    for (int i = 0; i < 3000; ++i) {
+        const auto value = make(rng);
+        switch (rng() % 4) {
+        case 0:
+        case 1:
+            CHECK(list.insert(value).second == reference.insert(value).second);
+            break;
+        case 2:
+            list.erase(value);
+            reference.erase(value);
+            break;
+        default:
+            check_search(list, reference, value);
+            break;
+        }
+    }
+    check_equal(list, reference);
+}
+
+std::string random_string(std::mt19937& rng)
+{
+    // the empty string and strings of one repeated extreme character included
+    std::string value(rng() % 6, 'a');
+    for (char& c : value) {
+        const unsigned pick = static_cast<unsigned>(rng() % 8);
+        c = pick == 0 ? '\0' : pick == 1 ? '\x7f' : static_cast<char>('a' + rng() % 4);
+    }
+    return value;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    for (int round = 0; round < 10; ++round) {
+        counted_list<std::string, std::less<std::string>> list;
+        std::set<std::string> reference;
+        exercise(list, reference, rng, random_string);
+        CHECK(list.front() == *reference.begin() && list.back() == *reference.rbegin());
+
+        counted_list<std::string, std::greater<std::string>> reversed;
+        std::set<std::string, std::greater<std::string>> reversed_reference;
+        exercise(reversed, reversed_reference, rng, random_string);
+    }
+
+    // the sentinels hold no record, so an empty list holds none at all
+    {
+        counted_list<record, std::less<record>> list;
+        CHECK(record::live == 0);
+        CHECK(list.begin() == list.end() && list.find(record("a", 1)) == list.end());
+        CHECK(record::live == 0);
+        std::set<record> reference;
+        const auto make = [](std::mt19937& r) { return record(random_string(r), static_cast<int>(r() % 4)); };
+        exercise(list, reference, rng, make);
+        counted_list<record, std::less<record>> copy(list);
+        check_equal(copy, reference);
+        // the list, its copy and the reference
+        CHECK(record::live == static_cast<std::ptrdiff_t>(3 * reference.size()));
+        list.clear();
+        copy.clear();
+        reference.clear();
+        CHECK(record::live == 0);
+        exercise(copy, reference, rng, make);
+    }
+    CHECK(record::live == 0);
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <set>
+#include <utility>
+
+#include "check.hpp"
+#include "packed_skip_list.hpp"
+
+namespace
+{
+
+template <typename T, typename C, typename G, bool Backward, typename Set>
+void check_equal(const skip_list::packed_skip_list<T, C, G, Backward>& list, const Set& reference)
+{
+    CHECK(list.size() == reference.size());
+    CHECK(list.empty() == reference.empty());
+    auto it = list.begin();
+    for (const auto& value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+    if (!reference.empty()) {
+        CHECK(list.front() == *reference.begin() && list.back() == *reference.rbegin());
+    }
+    if constexpr (Backward) {
+        auto rit = list.rbegin();
+        for (auto ref = reference.rbegin(); ref != reference.rend(); ++ref, ++rit) {
+            CHECK(rit != list.rend() && *rit == *ref);
+        }
+        CHECK(rit == list.rend());
+    }
+}
+
+/// Random inserts, erases and searches against std::set, the erased nodes are reused.
+template <typename List, typename Set, typename Make>
+void exercise(List& list, Set& reference, std::mt19937& rng, Make make, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const auto value = make(rng);
+        switch (rng() % 5) {
+        case 0:
+        case 1: {
+            const auto result = list.insert(value);
+            CHECK(result.second == reference.insert(value).second);
+            CHECK(*result.first == value);
+            break;
+        }
+        case 2:
+            CHECK(list.erase(value) == reference.erase(value));
+            break;
+        case 3: {
+            const auto lower = list.lower_bound(value);
+            const auto ref_lower = reference.lower_bound(value);
+            CHECK(ref_lower == reference.end() ? lower == list.end() : *lower == *ref_lower);
+            const auto upper = list.upper_bound(value);
+            const auto ref_upper = reference.upper_bound(value);
+            CHECK(ref_upper == reference.end() ? upper == list.end() : *upper == *ref_upper);
+            break;
+        }
+        default:
+            CHECK((list.find(value) != list.end()) == (reference.count(value) != 0));
+            CHECK(list.contains(value) == (reference.count(value) != 0));
+            break;
+        }
+    }
+    check_equal(list, reference);
+}
+
+template <typename List, typename Make>
+void check_list(std::mt19937& rng, Make make)
+{
+    using set_type = std::set<typename List::value_type, typename List::compare>;
+
+    for (int round = 0; round < 10; ++round) {
+        List list;
+        set_type reference;
+        CHECK(list.capacity_bytes() == 0 && list.begin() == list.end());
+        exercise(list, reference, rng, make, 5000);
+
+        // copies are independent, a move leaves an empty list which still works
+        List copy(list);
+        check_equal(copy, reference);
+        set_type copy_reference = reference;
+        exercise(copy, copy_reference, rng, make, 1000);
+        check_equal(list, reference);
+        List moved(std::move(list));
+        check_equal(moved, reference);
+        check_equal(list, set_type());
+        set_type list_reference;
+        exercise(list, list_reference, rng, make, 1000);
+        swap(list, moved);
+        check_equal(list, reference);
+        check_equal(moved, list_reference);
+        moved = copy;
+        check_equal(moved, copy_reference);
+
+        // clear keeps the arena, which the next inserts reuse
+        const std::size_t bytes = list.capacity_bytes();
+        list.clear();
+        reference.clear();
+        check_equal(list, reference);
+        CHECK(list.capacity_bytes() == bytes);
+        exercise(list, reference, rng, make, 500);
+
+        // a range insert after a reserve
+        list.reserve(2000);
+        const std::size_t reserved = list.capacity_bytes();
+        set_type more;
+        for (int i = 0; i < 1000; ++i) {
+            more.insert(make(rng));
+        }
+        list.insert(more.begin(), more.end());
+        reference.insert(more.begin(), more.end());
+        check_equal(list, reference);
+        CHECK(list.capacity_bytes() == reserved || list.size() > 2000);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    const auto small_int = [](std::mt19937& r) { return static_cast<int>(r() % 5000) - 2500; };
+    check_list<skip_list::packed_skip_list<int>>(rng, small_int);
+    check_list<skip_list::packed_skip_list<int, std::less<int>, skip_list::level_generator<>, false>>(rng, small_int);
+    check_list<skip_list::packed_skip_list<int, std::greater<int>>>(rng, small_int);
+
+    // headers smaller than a link, padded so the towers stay aligned
+    const auto any_char = [](std::mt19937& r) { return static_cast<char>(static_cast<int>(r() % 256) - 128); };
+    check_list<skip_list::packed_skip_list<char, std::less<char>, skip_list::level_generator<>, false>>(rng, any_char);
+    check_list<skip_list::packed_skip_list<char>>(rng, any_char);
+    const auto any_short = [](std::mt19937& r) { return static_cast<std::uint16_t>(r() % 65536); };
+    check_list<skip_list::packed_skip_list<std::uint16_t, std::less<std::uint16_t>, skip_list::level_generator<>, false>>(rng, any_short);
+    check_list<skip_list::packed_skip_list<std::uint16_t>>(rng, any_short);
+
+    // values aligned past the links, the arena counts in units of 8 bytes
+    const auto wide = [](std::mt19937& r) { return static_cast<std::int64_t>(r() % 5000) * 0x100000001ll; };
+    check_list<skip_list::packed_skip_list<std::int64_t>>(rng, wide);
+    check_list<skip_list::packed_skip_list<std::int64_t, std::less<std::int64_t>, skip_list::level_generator<>, false>>(rng, wide);
+    return 0;
+}
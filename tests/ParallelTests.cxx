@@ -0,0 +1,201 @@
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+#include "pool_allocator.hpp"
+#include "skip_list.hpp"
+
+namespace
+{
+
+/// Ordered by key alone, the order tells which of equal values was kept.
+struct entry
+{
+    int m_key;
+    std::size_t m_order;
+
+    bool operator<(const entry& other) const { return m_key < other.m_key; }
+};
+
+using list_type = skip_list::skip_list<int>;
+using entry_list = skip_list::skip_list<entry>;
+using pool_list = skip_list::skip_list<int, std::less<int>, skip_list::pool_allocator<int>>;
+
+template <typename List>
+void check_equal(const List& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    std::size_t index = 0;
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        CHECK(list.nth(index) == it);
+        CHECK(list.index_of(value) == index);
+        ++it;
+        ++index;
+    }
+    CHECK(it == list.end());
+    auto rit = list.rbegin();
+    for (auto ref = reference.rbegin(); ref != reference.rend(); ++ref, ++rit) {
+        CHECK(rit != list.rend() && *rit == *ref);
+    }
+    CHECK(rit == list.rend());
+}
+
+/// The built list takes inserts and erases like any other.
+template <typename List>
+void exercise(List& list, std::set<int>& reference, std::mt19937& rng, int bound)
+{
+    for (int i = 0; i < 500; ++i) {
+        const int value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+        if (i % 2 == 0) {
+            list.erase(value);
+            reference.erase(value);
+        } else {
+            list.insert(value);
+            reference.insert(value);
+        }
+    }
+    check_equal(list, reference);
+}
+
+std::vector<int> random_values(std::mt19937& rng, std::size_t count, int bound)
+{
+    std::vector<int> values(count);
+    for (int& value : values) {
+        value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+    }
+    return values;
+}
+
+/// Every element of [lo, hi) is visited exactly once, and nothing else.
+void check_for_each(const list_type& list, const std::set<int>& reference, int bound, int lo, int hi, std::size_t threads)
+{
+    std::vector<std::atomic<int>> visits(static_cast<std::size_t>(bound));
+    list.parallel_for_each(lo, hi, [&visits](int value) {
+        visits[static_cast<std::size_t>(value)].fetch_add(1, std::memory_order_relaxed);
+    }, threads);
+    for (int value = 0; value < bound; ++value) {
+        const bool inside = value >= lo && value < hi && reference.count(value) != 0;
+        CHECK(visits[static_cast<std::size_t>(value)].load() == (inside ? 1 : 0));
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    // every size around the thread counts, and every thread count
+    for (int round = 0; round < 60; ++round) {
+        const std::size_t count = round < 20 ? static_cast<std::size_t>(round) : rng() % 50000;
+        const int bound = 1 + static_cast<int>(rng() % 100000);
+        const std::vector<int> values = random_values(rng, count, bound);
+        const std::set<int> reference(values.begin(), values.end());
+        const std::size_t threads = rng() % 9;
+
+        list_type list;
+        list.insert(-1); // replaced by the build
+        list.assign(skip_list::parallel, values.begin(), values.end(), threads);
+        check_equal(list, reference);
+        // the heights are drawn for the number of values, as if each one were inserted
+        const skip_list::stats_snapshot stats = list.stats();
+        std::size_t log_size = 0;
+        for (std::size_t rest = values.size(); rest > 1; rest >>= 1) {
+            ++log_size;
+        }
+        CHECK(stats.m_levels <= log_size);
+        if (reference.size() >= 10000) {
+            // p = 1/2: about half as many nodes top out one level higher
+            CHECK(stats.m_level_histogram[1] * 10 > stats.m_level_histogram[0] * 4 &&
+                  stats.m_level_histogram[1] * 10 < stats.m_level_histogram[0] * 6);
+        }
+
+        // a forward only range and the constructor build the same list
+        const std::list<int> linked(values.begin(), values.end());
+        const list_type built(skip_list::parallel, linked.begin(), linked.end());
+        check_equal(built, reference);
+
+        std::set<int> changed = reference;
+        exercise(list, changed, rng, bound);
+
+        // parallel traversal of any range, empty and reversed ones included
+        for (int i = 0; i < 4; ++i) {
+            const int lo = static_cast<int>(rng() % static_cast<unsigned>(bound + 2)) - 1;
+            const int hi = i == 3 ? lo - 1 : lo + static_cast<int>(rng() % static_cast<unsigned>(bound + 1));
+            check_for_each(built, reference, bound, lo < 0 ? 0 : lo, hi, rng() % 9);
+        }
+        check_for_each(built, reference, bound, 0, bound, threads);
+    }
+
+    // of equal values the first one is kept
+    for (int round = 0; round < 10; ++round) {
+        std::vector<entry> values(20000 + rng() % 20000);
+        std::map<int, std::size_t> first;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = entry{static_cast<int>(rng() % 3000), i};
+            first.emplace(values[i].m_key, i);
+        }
+        entry_list list;
+        list.assign(skip_list::parallel, values.begin(), values.end(), 1 + rng() % 8);
+        CHECK(list.size() == first.size());
+        auto it = list.begin();
+        for (const auto& kept : first) {
+            CHECK(it != list.end() && it->m_key == kept.first && it->m_order == kept.second);
+            ++it;
+        }
+    }
+
+    // strings are moved between the threads and the segments
+    {
+        std::vector<std::string> values;
+        for (int i = 0; i < 20000; ++i) {
+            values.push_back(std::to_string(rng() % 30000));
+        }
+        const std::set<std::string> reference(values.begin(), values.end());
+        skip_list::skip_list<std::string> list(skip_list::parallel, values.begin(), values.end());
+        CHECK(list.size() == reference.size());
+        auto it = list.begin();
+        for (const std::string& value : reference) {
+            CHECK(*it++ == value);
+        }
+    }
+
+    // a pool list is linked by one thread
+    {
+        const std::vector<int> values = random_values(rng, 30000, 50000);
+        std::set<int> reference(values.begin(), values.end());
+        pool_list list;
+        list.assign(skip_list::parallel, values.begin(), values.end(), 4);
+        check_equal(list, reference);
+        exercise(list, reference, rng, 50000);
+    }
+
+    // an exception from fn reaches the caller once the threads are done
+    {
+        const std::vector<int> values = random_values(rng, 10000, 10000);
+        const list_type list(skip_list::parallel, values.begin(), values.end());
+        std::atomic<std::size_t> calls(0);
+        bool thrown = false;
+        try {
+            list.parallel_for_each(0, 10000, [&calls](int value) {
+                calls.fetch_add(1, std::memory_order_relaxed);
+                if (value >= 5000) {
+                    throw std::runtime_error("stop");
+                }
+            }, 4);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        CHECK(thrown && calls.load() <= list.size());
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <cstddef>
+#include <random>
+#include <set>
+#include <string>
+
+#include "check.hpp"
+#include "pool_allocator.hpp"
+#include "skip_list.hpp"
+
+namespace
+{
+
+using allocator_type = skip_list::pool_allocator<int>;
+using list_type = skip_list::skip_list<int, std::less<int>, allocator_type>;
+
+template <typename List, typename Set>
+void check_equal(const List& list, const Set& reference)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (const auto& value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+}
+
+void fill(list_type& list, std::set<int>& reference, std::mt19937& rng, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const int value = static_cast<int>(rng() % 10000);
+        list.insert(value);
+        reference.insert(value);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+    constexpr std::size_t chunk_size = 1 << 14;
+
+    // the arena itself: size classes are reused, copies share, a copied container gets a fresh one
+    {
+        allocator_type alloc(chunk_size);
+        int* first = alloc.allocate(3);
+        alloc.deallocate(first, 3);
+        CHECK(alloc.allocate(3) == first);
+        CHECK(alloc.reserved() == chunk_size);
+
+        skip_list::pool_allocator<double> rebound(alloc);
+        CHECK(rebound == alloc);
+        CHECK(!alloc.unique());
+
+        allocator_type fresh = alloc.select_on_container_copy_construction();
+        CHECK(fresh != alloc);
+        CHECK(fresh.unique());
+        CHECK(fresh.reserved() == 0);
+        fresh.deallocate(fresh.allocate(1), 1);
+        CHECK(fresh.reserved() == chunk_size);
+    }
+
+    for (int round = 0; round < 50; ++round) {
+        list_type list{allocator_type(chunk_size)};
+        std::set<int> reference;
+        fill(list, reference, rng, static_cast<int>(rng() % 5000));
+        for (int i = 0; i < 1000; ++i) {
+            const int value = static_cast<int>(rng() % 10000);
+            list.erase(value);
+            reference.erase(value);
+        }
+        check_equal(list, reference);
+        CHECK(list.get_allocator().reserved() > 0);
+
+        // erased nodes are recycled: refilling to the same contents does not grow the arena much
+        const std::size_t reserved = list.get_allocator().reserved();
+        const std::set<int> before = reference;
+        for (int value : before) {
+            list.erase(value);
+        }
+        for (int value : before) {
+            list.insert(value);
+        }
+        check_equal(list, reference);
+        CHECK(list.get_allocator().reserved() <= reserved + chunk_size);
+
+        // the copy has an arena of its own
+        list_type copy(list);
+        check_equal(copy, reference);
+        CHECK(copy.get_allocator() != list.get_allocator());
+
+        // the only owner of its arena clears by dropping it, and is usable again
+        list.clear();
+        CHECK(list.empty());
+        CHECK(list.get_allocator().reserved() <= chunk_size);
+        check_equal(copy, reference);
+        std::set<int> refill;
+        fill(list, refill, rng, 500);
+        check_equal(list, refill);
+
+        // an arena shared with another list is not dropped by clear()
+        list_type sharing(list.get_allocator());
+        std::set<int> shared_reference;
+        fill(sharing, shared_reference, rng, 500);
+        list.clear();
+        check_equal(list, std::set<int>());
+        check_equal(sharing, shared_reference);
+        CHECK(sharing.get_allocator().reserved() > 0);
+    }
+
+    // elements with a destructor are destroyed one by one, the arena stays
+    {
+        using string_list = skip_list::skip_list<std::string, std::less<std::string>, skip_list::pool_allocator<std::string>>;
+        string_list list{skip_list::pool_allocator<std::string>(chunk_size)};
+        std::set<std::string> reference;
+        for (int i = 0; i < 2000; ++i) {
+            std::string value = "a fairly long string to defeat the small buffer " + std::to_string(rng() % 3000);
+            list.insert(value);
+            reference.insert(value);
+        }
+        check_equal(list, reference);
+        const std::size_t reserved = list.get_allocator().reserved();
+        list.clear();
+        CHECK(list.empty());
+        CHECK(list.get_allocator().reserved() == reserved);
+        list.insert("again");
+        CHECK(list.size() == 1 && list.front() == "again");
+    }
+    return 0;
+}
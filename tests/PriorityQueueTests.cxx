@@ -0,0 +1,189 @@
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "concurrent_skip_list.hpp"
+#include "skip_list.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+/// A move-only timer, ordered by its due time.
+struct timer
+{
+    int m_due;
+    std::unique_ptr<int> m_payload;
+
+    bool operator<(const timer& other) const { return m_due < other.m_due; }
+};
+
+using list_type = skip_list::skip_list<int, std::less<int>, std::allocator<int>,
+                                       skip_list::level_generator<>, skip_list::counting_stats>;
+using concurrent_list = skip_list::concurrent_skip_list<int>;
+
+constexpr int thread_count = 8;
+
+/// Same elements, and the ranks right after the pops.
+void check_equal(const list_type& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    std::size_t index = 0;
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        CHECK(list.nth(index) == it);
+        CHECK(list.index_of(value) == index);
+        ++it;
+        ++index;
+    }
+    CHECK(it == list.end());
+    if (!reference.empty()) {
+        CHECK(list.front() == *reference.begin() && list.back() == *reference.rbegin());
+    }
+}
+
+/// A scheduler queue: new timers are due later than the current time, the earliest ones are popped.
+void scheduler(std::mt19937& rng, bool finger)
+{
+    list_type list;
+    list.enable_finger(finger);
+    std::set<int> reference;
+    int now = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const unsigned pick = static_cast<unsigned>(rng() % 8);
+        if (pick < 4 || reference.empty()) {
+            const int due = now + static_cast<int>(rng() % 1000);
+            CHECK(list.insert(due).second == reference.insert(due).second);
+        } else if (pick < 6) {
+            // the first element goes without a search or a comparison
+            list.reset_stats();
+            now = list.front();
+            list.pop_front();
+            const skip_list::stats_snapshot stats = list.stats();
+            CHECK(stats.m_erase_descents == 0 && stats.m_find_descents == 0 && stats.m_comparisons == 0);
+            CHECK(stats.m_deallocations == 1);
+            CHECK(now == *reference.begin());
+            reference.erase(reference.begin());
+        } else if (pick < 7) {
+            CHECK(list.extract_min() == *reference.begin());
+            reference.erase(reference.begin());
+        } else {
+            list.pop_back();
+            reference.erase(std::prev(reference.end()));
+        }
+        if (i % 1000 == 0) {
+            check_equal(list, reference);
+        }
+        // the finger, if any, still finds its way after the pops
+        const int key = now + static_cast<int>(rng() % 1000);
+        CHECK((list.find(key) != list.end()) == (reference.count(key) != 0));
+    }
+    check_equal(list, reference);
+    while (!list.empty()) {
+        CHECK(list.extract_min() == *reference.begin());
+        reference.erase(reference.begin());
+    }
+    check_equal(list, reference);
+    CHECK(list.begin() == list.end());
+    CHECK(list.insert(1).second && list.front() == 1 && list.back() == 1);
+}
+
+/// Every value pops exactly once, and a thread using try_pop_min gets them in increasing order.
+void drain(bool spray)
+{
+    concurrent_list list;
+    const int count = 100000;
+    for (int value = 0; value < count; ++value) {
+        list.insert(value);
+    }
+    std::vector<std::vector<int>> popped(thread_count);
+    std::atomic<int> ready(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            ++ready;
+            while (ready.load() != thread_count) {
+                std::this_thread::yield();
+            }
+            std::vector<int>& mine = popped[static_cast<std::size_t>(t)];
+            int value = 0;
+            while (spray ? list.spray_pop_min(value, thread_count) : list.try_pop_min(value)) {
+                CHECK(spray || mine.empty() || mine.back() < value);
+                mine.push_back(value);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    std::vector<int> seen(count, 0);
+    for (const std::vector<int>& mine : popped) {
+        for (int value : mine) {
+            ++seen[static_cast<std::size_t>(value)];
+        }
+    }
+    for (int times : seen) {
+        CHECK(times == 1);
+    }
+    CHECK(list.empty() && list.begin() == list.end());
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    scheduler(rng, false);
+    scheduler(rng, true);
+
+    // extract_min moves the value out
+    {
+        skip_list::skip_list<timer> timers;
+        std::set<int> reference;
+        for (int i = 0; i < 2000; ++i) {
+            const int due = static_cast<int>(rng() % 100000);
+            if (timers.emplace(timer{due, std::make_unique<int>(due)}).second) {
+                reference.insert(due);
+            }
+        }
+        while (!timers.empty()) {
+            const timer first = timers.extract_min();
+            CHECK(first.m_payload != nullptr && *first.m_payload == first.m_due);
+            CHECK(first.m_due == *reference.begin());
+            reference.erase(reference.begin());
+        }
+        CHECK(reference.empty());
+    }
+
+    // popping alone, the spray is the smallest element like try_pop_min
+    {
+        concurrent_list list;
+        std::set<int> reference;
+        int value = 0;
+        CHECK(!list.try_pop_min(value) && !list.spray_pop_min(value, 1));
+        for (int i = 0; i < 5000; ++i) {
+            const int inserted = static_cast<int>(rng() % 20000);
+            list.insert(inserted);
+            reference.insert(inserted);
+        }
+        for (int i = 0; !reference.empty(); ++i) {
+            CHECK(i % 2 == 0 ? list.spray_pop_min(value, 1) : list.try_pop_min(value));
+            CHECK(value == *reference.begin());
+            reference.erase(reference.begin());
+        }
+        CHECK(!list.spray_pop_min(value, 1) && list.empty());
+    }
+
+    drain(false);
+    drain(true);
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <set>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+
+namespace
+{
+
+using list_type = skip_list::skip_list<int>;
+
+/// Every element has the index of its place in the reference, and the reverse.
+void check_ranks(const list_type& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    std::size_t index = 0;
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        CHECK(*list.nth(index) == value);
+        CHECK(list.index_of(it) == index);
+        CHECK(list.index_of(value) == index);
+        ++it;
+        ++index;
+    }
+    CHECK(it == list.end());
+    CHECK(list.nth(index) == list.end());
+    CHECK(list.index_of(list.end()) == index);
+}
+
+std::set<int> split_reference(std::set<int>& reference, int key)
+{
+    std::set<int> rest(reference.lower_bound(key), reference.end());
+    reference.erase(reference.lower_bound(key), reference.end());
+    return rest;
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+    auto random_value = [&rng](int bound) { return static_cast<int>(rng() % static_cast<unsigned>(bound)); };
+
+    for (int round = 0; round < 200; ++round) {
+        list_type list;
+        std::set<int> reference;
+        const int bound = 1 + random_value(3000);
+        const int count = random_value(1500);
+        for (int i = 0; i < count; ++i) {
+            const int value = random_value(bound);
+            list.insert(value);
+            reference.insert(value);
+        }
+        for (int i = 0; i < count / 4; ++i) {
+            const int value = random_value(bound);
+            list.erase(value);
+            reference.erase(value);
+        }
+        check_ranks(list, reference);
+
+        // split at a random key, then join the halves back
+        const int key = random_value(bound + 1);
+        list_type upper = list.split(key);
+        std::set<int> upper_reference = split_reference(reference, key);
+        check_ranks(list, reference);
+        check_ranks(upper, upper_reference);
+
+        // both halves stay usable before they are joined again
+        for (int i = 0; i < 20; ++i) {
+            const int low = random_value(key + 1);
+            if (low < key) {
+                list.insert(low);
+                reference.insert(low);
+            }
+            const int high = key + random_value(bound + 1);
+            upper.insert(high);
+            upper_reference.insert(high);
+        }
+        list.join(upper);
+        reference.insert(upper_reference.begin(), upper_reference.end());
+        CHECK(upper.empty());
+        check_ranks(upper, {});
+        check_ranks(list, reference);
+
+        // extract a random range by index
+        const std::size_t first = reference.empty() ? 0 : rng() % (reference.size() + 1);
+        const std::size_t last = first + (reference.size() == first ? 0 : rng() % (reference.size() - first + 1));
+        list_type middle = list.extract(list.nth(first), list.nth(last));
+        std::set<int> middle_reference(std::next(reference.begin(), static_cast<std::ptrdiff_t>(first)),
+                                       std::next(reference.begin(), static_cast<std::ptrdiff_t>(last)));
+        for (int value : middle_reference) {
+            reference.erase(value);
+        }
+        check_ranks(list, reference);
+        check_ranks(middle, middle_reference);
+
+        // the extracted range goes back in the middle by merge
+        list.merge(middle);
+        reference.insert(middle_reference.begin(), middle_reference.end());
+        CHECK(middle.empty());
+        check_ranks(list, reference);
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "check.hpp"
+#include "pool_allocator.hpp"
+#include "skip_list.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+using list_type = skip_list::skip_list<int, std::less<int>, std::allocator<int>,
+                                       skip_list::level_generator<>, skip_list::counting_stats>;
+using pool_list = skip_list::skip_list<int, std::less<int>, skip_list::pool_allocator<int>>;
+
+/// Same elements in the same order, and ranks which agree with the order.
+template <typename List>
+void check_equal(const List& list, const std::vector<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+    for (std::size_t index = 0; index < reference.size(); index += 1 + reference.size() / 16) {
+        CHECK(*list.nth(index) == reference[index]);
+        CHECK(list.index_of(list.nth(index)) == index);
+    }
+}
+
+template <typename List>
+void check_equal(const List& list, const std::set<int>& reference)
+{
+    check_equal(list, std::vector<int>(reference.begin(), reference.end()));
+}
+
+template <typename List>
+void fill(List& list, std::set<int>& reference, std::mt19937& rng, std::size_t count, int bound)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        const int value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+        list.insert(value);
+        reference.insert(value);
+    }
+}
+
+/// The node of every element, to tell a relinked node from a new one.
+template <typename List>
+std::map<int, const int*> addresses(const List& list)
+{
+    std::map<int, const int*> result;
+    for (const int& value : list) {
+        result[value] = &value;
+    }
+    return result;
+}
+
+/// merge() against std::set::merge, the nodes which move keep their address.
+template <typename List>
+void check_merge(List& lhs, std::set<int>& lhs_ref, List& rhs, std::set<int>& rhs_ref, bool same_nodes)
+{
+    const auto lhs_nodes = addresses(lhs);
+    const auto rhs_nodes = addresses(rhs);
+    lhs.merge(rhs);
+    lhs_ref.merge(rhs_ref);
+    check_equal(lhs, lhs_ref);
+    check_equal(rhs, rhs_ref);
+    for (const int& value : lhs) {
+        const auto mine = lhs_nodes.find(value);
+        if (mine != lhs_nodes.end()) {
+            CHECK(mine->second == &value);
+        } else if (same_nodes) {
+            CHECK(rhs_nodes.at(value) == &value);
+        }
+    }
+    // what stays in the source had an equal element here
+    for (const int& value : rhs) {
+        CHECK(lhs_nodes.count(value) == 1);
+        CHECK(rhs_nodes.at(value) == &value);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    for (int round = 0; round < 200; ++round) {
+        // sizes far apart as well, for the searches from the previous match
+        const std::size_t lhs_count = rng() % (round % 4 == 0 ? 20 : 3000);
+        const std::size_t rhs_count = rng() % (round % 4 == 1 ? 20 : 3000);
+        const int bound = 1 + static_cast<int>(rng() % 8000);
+
+        list_type lhs;
+        list_type rhs;
+        std::set<int> lhs_ref;
+        std::set<int> rhs_ref;
+        fill(lhs, lhs_ref, rng, lhs_count, bound);
+        fill(rhs, rhs_ref, rng, rhs_count, bound);
+
+        // the set operations against the std algorithms, the operands do not change
+        std::vector<int> expected;
+        std::set_union(lhs_ref.begin(), lhs_ref.end(), rhs_ref.begin(), rhs_ref.end(), std::back_inserter(expected));
+        lhs.reset_stats();
+        const list_type united = set_union(lhs, rhs);
+        // one pass, about a comparison per element and one more per step
+        CHECK(lhs.stats().m_comparisons + united.stats().m_comparisons <= 3 * (lhs_ref.size() + rhs_ref.size()) + 8);
+        check_equal(united, expected);
+
+        expected.clear();
+        std::set_intersection(lhs_ref.begin(), lhs_ref.end(), rhs_ref.begin(), rhs_ref.end(), std::back_inserter(expected));
+        check_equal(set_intersection(lhs, rhs), expected);
+        check_equal(set_intersection(rhs, lhs), expected);
+
+        expected.clear();
+        std::set_difference(lhs_ref.begin(), lhs_ref.end(), rhs_ref.begin(), rhs_ref.end(), std::back_inserter(expected));
+        check_equal(set_difference(lhs, rhs), expected);
+        expected.clear();
+        std::set_difference(rhs_ref.begin(), rhs_ref.end(), lhs_ref.begin(), lhs_ref.end(), std::back_inserter(expected));
+        check_equal(set_difference(rhs, lhs), expected);
+
+        check_equal(set_union(lhs, lhs), lhs_ref);
+        check_equal(set_intersection(lhs, list_type()), std::vector<int>());
+        check_equal(set_difference(lhs, list_type()), lhs_ref);
+        check_equal(lhs, lhs_ref);
+        check_equal(rhs, rhs_ref);
+
+        // merge relinks the nodes of the same allocator
+        check_merge(lhs, lhs_ref, rhs, rhs_ref, true);
+        lhs.merge(lhs);
+        check_equal(lhs, lhs_ref);
+        lhs.merge(list_type());
+        check_equal(lhs, lhs_ref);
+
+        // both lists keep working after the merge
+        fill(lhs, lhs_ref, rng, 100, bound);
+        fill(rhs, rhs_ref, rng, 100, bound);
+        check_merge(rhs, rhs_ref, lhs, lhs_ref, true);
+    }
+
+    // unequal allocators move the values, equal ones of a shared arena relink the nodes
+    for (int round = 0; round < 50; ++round) {
+        const int bound = 1 + static_cast<int>(rng() % 4000);
+        pool_list lhs;
+        pool_list other_arena;
+        pool_list same_arena(lhs.get_allocator());
+        std::set<int> lhs_ref;
+        std::set<int> other_ref;
+        std::set<int> same_ref;
+        fill(lhs, lhs_ref, rng, rng() % 2000, bound);
+        fill(other_arena, other_ref, rng, rng() % 2000, bound);
+        fill(same_arena, same_ref, rng, rng() % 2000, bound);
+
+        check_merge(lhs, lhs_ref, other_arena, other_ref, false);
+        check_merge(lhs, lhs_ref, same_arena, same_ref, true);
+
+        std::vector<int> expected;
+        std::set_union(lhs_ref.begin(), lhs_ref.end(), other_ref.begin(), other_ref.end(), std::back_inserter(expected));
+        check_equal(set_union(lhs, other_arena), expected);
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include <cstddef>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "check.hpp"
+#include "skip_map.hpp"
+
+namespace
+{
+
+/// Comparator with state, ascending or descending.
+struct directed_less
+{
+    static inline std::size_t s_calls = 0;
+
+    bool m_descending = false;
+
+    bool operator()(int lhs, int rhs) const
+    {
+        ++s_calls;
+        return m_descending ? rhs < lhs : lhs < rhs;
+    }
+};
+
+template <typename Map, typename Reference>
+void check_equal(const Map& map, const Reference& reference)
+{
+    CHECK(map.size() == reference.size());
+    CHECK(map.empty() == reference.empty());
+    auto it = map.begin();
+    for (const auto& entry : reference) {
+        CHECK(it != map.end());
+        CHECK(it->first == entry.first && it->second == entry.second);
+        ++it;
+    }
+    CHECK(it == map.end());
+}
+
+/// Random changes applied to the map and to the reference alike.
+template <typename Map, typename Reference, typename Make>
+void exercise(Map& map, Reference& reference, std::mt19937& rng, Make make)
+{
+    for (int i = 0; i < 3000; ++i) {
+        const int key = static_cast<int>(rng() % 1000);
+        switch (rng() % 8) {
+        case 0:
+            map[key] = make(i);
+            reference[key] = make(i);
+            break;
+        case 1: {
+            const auto result = map.try_emplace(key, make(i));
+            CHECK(result.second == reference.try_emplace(key, make(i)).second);
+            CHECK(result.first->first == key && result.first->second == reference.at(key));
+            break;
+        }
+        case 2: {
+            const auto result = map.insert_or_assign(key, make(i));
+            CHECK(result.second == reference.insert_or_assign(key, make(i)).second);
+            break;
+        }
+        case 3:
+            CHECK(map.insert(std::make_pair(key, make(i))).second == reference.insert(std::make_pair(key, make(i))).second);
+            break;
+        case 4:
+            CHECK(map.erase(key) == reference.erase(key));
+            break;
+        case 5: {
+            const auto it = map.lower_bound(key);
+            const auto ref = reference.lower_bound(key);
+            if (ref == reference.end()) {
+                CHECK(it == map.end());
+            } else {
+                CHECK(it != map.end() && it->first == ref->first);
+                const auto next = map.erase(it);
+                const auto ref_next = reference.erase(ref);
+                CHECK(ref_next == reference.end() ? next == map.end() : next->first == ref_next->first);
+            }
+            break;
+        }
+        case 6: {
+            const auto it = map.upper_bound(key);
+            const auto ref = reference.upper_bound(key);
+            CHECK(ref == reference.end() ? it == map.end() : it->first == ref->first);
+            CHECK(map.contains(key) == (reference.count(key) != 0));
+            break;
+        }
+        default: {
+            const auto it = map.find(key);
+            const auto ref = reference.find(key);
+            CHECK(ref == reference.end() ? it == map.end() : it->second == ref->second);
+            if (ref == reference.end()) {
+                bool thrown = false;
+                try {
+                    map.at(key);
+                } catch (const std::out_of_range&) {
+                    thrown = true;
+                }
+                CHECK(thrown);
+            } else {
+                CHECK(map.at(key) == ref->second);
+            }
+            break;
+        }
+        }
+    }
+    check_equal(map, reference);
+}
+
+/// Copies, moves and swaps keep the entries and the comparator.
+template <typename Map, typename Reference, typename Make>
+void check_copies(Map& map, Reference& reference, std::mt19937& rng, Make make)
+{
+    const directed_less comp = map.key_comp();
+
+    // the copy takes the tower heights over, no key is compared
+    const std::size_t calls = directed_less::s_calls;
+    Map copy(map);
+    CHECK(directed_less::s_calls == calls);
+    CHECK(copy.key_comp().m_descending == comp.m_descending);
+    check_equal(copy, reference);
+    // the copy owns its values, changing one side leaves the other alone
+    Reference copy_reference = reference;
+    exercise(copy, copy_reference, rng, make);
+    check_equal(map, reference);
+
+    Map assigned(directed_less{!comp.m_descending});
+    assigned[1] = make(1);
+    const std::size_t assign_calls = directed_less::s_calls;
+    assigned = map;
+    CHECK(directed_less::s_calls == assign_calls);
+    CHECK(assigned.key_comp().m_descending == comp.m_descending);
+    check_equal(assigned, reference);
+
+    Map moved(std::move(assigned));
+    check_equal(moved, reference);
+    CHECK(moved.key_comp().m_descending == comp.m_descending);
+
+    moved.swap(copy);
+    check_equal(moved, copy_reference);
+    check_equal(copy, reference);
+
+    copy.clear();
+    CHECK(copy.empty() && copy.begin() == copy.end());
+    copy = std::move(moved);
+    check_equal(copy, copy_reference);
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    for (bool descending : {false, true}) {
+        const directed_less comp{descending};
+
+        // mapped values kept in the nodes
+        {
+            using map_type = skip_list::skip_map<int, long, directed_less>;
+            map_type map(comp);
+            CHECK(map.key_comp().m_descending == descending);
+            std::map<int, long, directed_less> reference(comp);
+            auto make = [](int i) { return static_cast<long>(i) * 7; };
+            exercise(map, reference, rng, make);
+            check_copies(map, reference, rng, make);
+        }
+
+        // mapped values out of line
+        {
+            using map_type = skip_list::skip_map<int, std::string, directed_less>;
+            map_type map(comp);
+            std::map<int, std::string, directed_less> reference(comp);
+            auto make = [](int i) { return "a value too long for the small buffer " + std::to_string(i); };
+            exercise(map, reference, rng, make);
+            check_copies(map, reference, rng, make);
+        }
+    }
+    return 0;
+}
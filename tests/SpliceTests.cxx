@@ -0,0 +1,182 @@
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "check.hpp"
+#include "pool_allocator.hpp"
+#include "skip_list.hpp"
+
+namespace
+{
+
+using list_type = skip_list::skip_list<int>;
+using pool_list = skip_list::skip_list<int, std::less<int>, skip_list::pool_allocator<int>>;
+
+/// Same elements, and the rank of every element right both ways.
+template <typename List>
+void check_equal(const List& list, const std::set<int>& reference)
+{
+    CHECK(list.size() == reference.size());
+    CHECK(list.empty() == reference.empty());
+    std::size_t index = 0;
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        CHECK(list.nth(index) == it);
+        CHECK(list.index_of(it) == index);
+        CHECK(list.index_of(value) == index);
+        ++it;
+        ++index;
+    }
+    CHECK(it == list.end());
+    CHECK(list.nth(index) == list.end());
+    auto rit = list.rbegin();
+    for (auto ref = reference.rbegin(); ref != reference.rend(); ++ref, ++rit) {
+        CHECK(rit != list.rend() && *rit == *ref);
+    }
+    CHECK(rit == list.rend());
+}
+
+template <typename List>
+void fill(List& list, std::set<int>& reference, std::mt19937& rng, std::size_t count, int bound)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        const int value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+        list.insert(value);
+        reference.insert(value);
+    }
+}
+
+/// Moves the elements of the reference not less than the key to the returned set.
+std::set<int> split_reference(std::set<int>& reference, int key)
+{
+    const auto first = reference.lower_bound(key);
+    std::set<int> rest(first, reference.end());
+    reference.erase(first, reference.end());
+    return rest;
+}
+
+/// Both parts of a cut take inserts and erases with their ranks kept right.
+template <typename List>
+void exercise(List& list, std::set<int>& reference, std::mt19937& rng, int bound)
+{
+    for (int i = 0; i < 50; ++i) {
+        const int value = static_cast<int>(rng() % static_cast<unsigned>(bound));
+        if (i % 3 == 0) {
+            const auto next = list.erase(value);
+            const bool erased = reference.erase(value) != 0;
+            const auto ref_next = reference.upper_bound(value);
+            CHECK(!erased || ref_next == reference.end() ? next == list.end() : *next == *ref_next);
+        } else {
+            list.insert(value);
+            reference.insert(value);
+        }
+    }
+    check_equal(list, reference);
+}
+
+template <typename List>
+void check_splicing(std::mt19937& rng, const List& prototype)
+{
+    for (int round = 0; round < 200; ++round) {
+        const int bound = 1 + static_cast<int>(rng() % 4000);
+        List list(prototype.get_allocator());
+        std::set<int> reference;
+        fill(list, reference, rng, rng() % 1500, bound);
+
+        // split at any key, below and above every element as well
+        const int key = static_cast<int>(rng() % static_cast<unsigned>(bound + 20)) - 10;
+        std::vector<const int*> nodes;
+        for (const int& value : list) {
+            nodes.push_back(&value);
+        }
+        List rest = list.split(key);
+        std::set<int> rest_reference = split_reference(reference, key);
+        check_equal(list, reference);
+        check_equal(rest, rest_reference);
+
+        // the nodes moved without being copied
+        auto node = nodes.begin();
+        for (const int& value : list) {
+            CHECK(*node++ == &value);
+        }
+        for (const int& value : rest) {
+            CHECK(*node++ == &value);
+        }
+
+        // join gives the whole list back
+        list.join(rest);
+        reference.insert(rest_reference.begin(), rest_reference.end());
+        CHECK(rest.empty() && rest.begin() == rest.end());
+        check_equal(list, reference);
+        check_equal(rest, std::set<int>());
+
+        // the parts of a split keep working on their own
+        rest = list.split(key);
+        rest_reference = split_reference(reference, key);
+        exercise(list, reference, rng, key > 0 ? key : 1);
+        for (int i = 0; i < 50; ++i) {
+            const int value = key + static_cast<int>(rng() % 1000);
+            rest.insert(value);
+            rest_reference.insert(value);
+        }
+        check_equal(rest, rest_reference);
+        list.join(std::move(rest));
+        reference.insert(rest_reference.begin(), rest_reference.end());
+        check_equal(list, reference);
+
+        // extract a range by position, the remainder closes up
+        const std::size_t first_index = list.empty() ? 0 : rng() % (list.size() + 1);
+        const std::size_t last_index = first_index + rng() % (list.size() - first_index + 1);
+        auto ref_first = std::next(reference.begin(), static_cast<std::ptrdiff_t>(first_index));
+        auto ref_last = std::next(reference.begin(), static_cast<std::ptrdiff_t>(last_index));
+        const std::set<int> extracted_reference(ref_first, ref_last);
+        List extracted = list.extract(list.nth(first_index), list.nth(last_index));
+        reference.erase(ref_first, ref_last);
+        check_equal(list, reference);
+        check_equal(extracted, extracted_reference);
+        exercise(list, reference, rng, bound);
+
+        // erase a range by position
+        const std::size_t erase_first = list.empty() ? 0 : rng() % (list.size() + 1);
+        const std::size_t erase_last = erase_first + rng() % (list.size() - erase_first + 1);
+        const auto next = list.erase(list.nth(erase_first), list.nth(erase_last));
+        reference.erase(std::next(reference.begin(), static_cast<std::ptrdiff_t>(erase_first)),
+                        std::next(reference.begin(), static_cast<std::ptrdiff_t>(erase_last)));
+        CHECK(list.index_of(next) == erase_first);
+        check_equal(list, reference);
+        exercise(list, reference, rng, bound);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    check_splicing(rng, list_type());
+    check_splicing(rng, pool_list());
+
+    // a join across arenas moves the values
+    {
+        pool_list list;
+        pool_list other;
+        std::set<int> reference;
+        std::set<int> other_reference;
+        fill(list, reference, rng, 1000, 5000);
+        for (int i = 0; i < 1000; ++i) {
+            const int value = 5000 + static_cast<int>(rng() % 5000);
+            other.insert(value);
+            other_reference.insert(value);
+        }
+        list.join(other);
+        reference.insert(other_reference.begin(), other_reference.end());
+        CHECK(other.empty());
+        check_equal(list, reference);
+        exercise(list, reference, rng, 10000);
+    }
+    return 0;
+}
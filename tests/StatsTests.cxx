@@ -0,0 +1,145 @@
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <set>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+#include "stats_policy.hpp"
+
+namespace
+{
+
+using counted_list = skip_list::skip_list<int, std::less<int>, std::allocator<int>,
+                                          skip_list::level_generator<>, skip_list::counting_stats>;
+using plain_list = skip_list::skip_list<int>;
+
+std::size_t sum(const std::array<std::size_t, skip_list::stats_snapshot::max_levels>& counts)
+{
+    std::size_t total = 0;
+    for (std::size_t count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+/// The shape agrees with the list whatever the policy.
+void check_shape(const skip_list::stats_snapshot& stats, std::size_t size)
+{
+    CHECK(stats.m_size == size);
+    CHECK(sum(stats.m_level_histogram) == size);
+    std::size_t top = 0;
+    for (std::size_t level = 0; level < stats.m_level_histogram.size(); ++level) {
+        if (stats.m_level_histogram[level] != 0) {
+            top = level;
+        }
+    }
+    CHECK(stats.m_levels == top);
+    CHECK((stats.m_node_bytes == 0) == (size == 0));
+    if (size != 0) {
+        CHECK(std::fabs(stats.m_bytes_per_node * static_cast<double>(size) - static_cast<double>(stats.m_node_bytes)) < 1);
+    }
+    if (size >= 10000) {
+        // p = 1/2: about half of the nodes on every level go one level up
+        for (std::size_t level = 0; level < 4; ++level) {
+            const double ratio = static_cast<double>(stats.m_level_histogram[level + 1]) /
+                                 static_cast<double>(stats.m_level_histogram[level]);
+            CHECK(ratio > 0.4 && ratio < 0.6);
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    // without stats only the shape is measured
+    {
+        plain_list list;
+        check_shape(list.stats(), 0);
+        for (int i = 0; i < 20000; ++i) {
+            list.insert(static_cast<int>(rng() % 100000));
+        }
+        for (int i = 0; i < 1000; ++i) {
+            list.find(static_cast<int>(rng() % 100000));
+        }
+        const skip_list::stats_snapshot stats = list.stats();
+        check_shape(stats, list.size());
+        CHECK(stats.m_comparisons == 0 && sum(stats.m_hops) == 0);
+        CHECK(stats.m_find_descents == 0 && stats.m_insert_descents == 0 && stats.m_erase_descents == 0);
+        CHECK(stats.m_allocations == 0 && stats.m_allocated_bytes == 0);
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        counted_list list;
+        std::set<int> reference;
+        list.insert(-1);
+        reference.insert(-1);
+        list.reset_stats();
+        const skip_list::stats_snapshot cleared = list.stats();
+        CHECK(cleared.m_comparisons == 0 && sum(cleared.m_hops) == 0 && cleared.m_allocations == 0);
+        CHECK(!(cleared.m_average_path_length > 0));
+        check_shape(cleared, 1);
+
+        // one descent and one node per new element, the bytes of the nodes are the ones allocated
+        const std::size_t count = 1000 + rng() % 20000;
+        std::size_t inserted = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const int value = static_cast<int>(rng() % 100000);
+            if (list.insert(value).second) {
+                ++inserted;
+            }
+            reference.insert(value);
+        }
+        skip_list::stats_snapshot stats = list.stats();
+        CHECK(stats.m_insert_descents == count);
+        CHECK(stats.m_allocations == inserted && stats.m_deallocations == 0);
+        // all the nodes but the first one were allocated since the reset
+        CHECK(stats.m_allocated_bytes < stats.m_node_bytes && stats.m_node_bytes - stats.m_allocated_bytes < 1024);
+        CHECK(std::fabs(stats.m_average_path_length * static_cast<double>(count) - static_cast<double>(sum(stats.m_hops))) < 1);
+        check_shape(stats, reference.size());
+
+        // searches count their descents, hops and comparisons, O(log n) of each
+        list.reset_stats();
+        const std::size_t finds = 1000;
+        for (std::size_t i = 0; i < finds; ++i) {
+            const int value = static_cast<int>(rng() % 100000);
+            CHECK((list.find(value) != list.end()) == (reference.count(value) != 0));
+        }
+        stats = list.stats();
+        const double log_size = std::log2(static_cast<double>(reference.size()));
+        CHECK(stats.m_find_descents == finds && stats.m_insert_descents == 0 && stats.m_erase_descents == 0);
+        CHECK(stats.m_average_path_length > 0.5 * log_size && stats.m_average_path_length < 2 * log_size + 4);
+        CHECK(stats.m_comparisons >= sum(stats.m_hops) && stats.m_comparisons < finds * static_cast<std::size_t>(3 * log_size + 8));
+        CHECK(stats.m_allocations == 0);
+        // no hop above the top level
+        for (std::size_t level = stats.m_levels + 1; level < stats.m_hops.size(); ++level) {
+            CHECK(stats.m_hops[level] == 0);
+        }
+
+        // every erase descends once and frees the node it finds
+        list.reset_stats();
+        std::size_t erased = 0;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            const int value = static_cast<int>(rng() % 100000);
+            list.erase(value);
+            erased += reference.erase(value);
+        }
+        stats = list.stats();
+        CHECK(stats.m_erase_descents == 1000);
+        CHECK(stats.m_deallocations == erased && stats.m_allocations == 0);
+        check_shape(stats, reference.size());
+
+        // reset leaves the shape alone
+        list.reset_stats();
+        stats = list.stats();
+        CHECK(stats.m_comparisons == 0 && sum(stats.m_hops) == 0 && stats.m_deallocations == 0);
+        check_shape(stats, reference.size());
+        list.clear();
+        check_shape(list.stats(), 0);
+    }
+    return 0;
+}
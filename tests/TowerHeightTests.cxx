@@ -0,0 +1,112 @@
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <set>
+
+#include "check.hpp"
+#include "skip_list.hpp"
+
+namespace
+{
+
+using list_type = skip_list::skip_list<int>;
+
+/// floor(log2(count)), the level limit of a list of count - 1 elements.
+std::size_t floor_log2(std::size_t count)
+{
+    std::size_t result = 0;
+    while ((count >>= 1) != 0) {
+        ++result;
+    }
+    return result;
+}
+
+/// Same elements as the reference, and no tower taller than the size allows.
+void check_shape(const list_type& list, const std::set<int>& reference, std::size_t capacity = 0)
+{
+    CHECK(list.size() == reference.size());
+    auto it = list.begin();
+    for (int value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+
+    const skip_list::stats_snapshot stats = list.stats();
+    CHECK(stats.m_size == reference.size());
+    // a node gets at most the limit of the size it was inserted at
+    const std::size_t peak = capacity > reference.size() + 1 ? capacity : reference.size() + 1;
+    CHECK(stats.m_levels <= floor_log2(peak));
+    std::size_t nodes = 0;
+    for (std::size_t level = 0; level < skip_list::stats_snapshot::max_levels; ++level) {
+        nodes += stats.m_level_histogram[level];
+        if (level > stats.m_levels) {
+            CHECK(stats.m_level_histogram[level] == 0);
+        }
+    }
+    CHECK(nodes == reference.size());
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    // the height follows the size instead of stopping at a fixed level
+    {
+        list_type list;
+        std::set<int> reference;
+        std::size_t previous = 0;
+        for (int value = 0; value < (1 << 16); ++value) {
+            list.insert(value);
+            reference.insert(value);
+            if ((value & (value + 1)) == 0) {
+                const std::size_t levels = list.stats().m_levels;
+                CHECK(levels >= previous);
+                CHECK(levels <= floor_log2(reference.size()));
+                previous = levels;
+            }
+        }
+        check_shape(list, reference);
+        // far above the old static limit of 5, and close to log2(n)
+        CHECK(list.stats().m_levels >= 10);
+
+        // the empty top levels go away with their nodes
+        while (reference.size() > 16) {
+            list.pop_back();
+            reference.erase(std::prev(reference.end()));
+        }
+        check_shape(list, reference, std::size_t(1) << 16);
+        list.clear();
+        reference.clear();
+        check_shape(list, reference);
+        CHECK(list.stats().m_levels == 0);
+    }
+
+    // random contents, the shape stays within the bound after every change
+    for (int round = 0; round < 100; ++round) {
+        list_type list;
+        std::set<int> reference;
+        const int count = static_cast<int>(rng() % 5000);
+        for (int i = 0; i < count; ++i) {
+            const int value = static_cast<int>(rng() % 10000);
+            list.insert(value);
+            reference.insert(value);
+        }
+        check_shape(list, reference);
+    }
+
+    // reserve() lets the first nodes grow as tall as the expected size needs
+    {
+        list_type list;
+        std::set<int> reference;
+        list.reserve(1 << 12);
+        for (int value = 0; value < 64; ++value) {
+            list.insert(value);
+            reference.insert(value);
+        }
+        check_shape(list, reference, std::size_t(1) << 12);
+    }
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <utility>
+
+#include "check.hpp"
+#include "unrolled_skip_list.hpp"
+
+namespace
+{
+
+/// Allocator told apart by its id, which does not propagate on move assignment.
+template <typename T>
+struct tagged_allocator
+{
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::false_type;
+    using is_always_equal = std::false_type;
+
+    explicit tagged_allocator(int id = 0) : m_id(id) { }
+    template <typename U>
+    tagged_allocator(const tagged_allocator<U>& other) : m_id(other.m_id) { }
+
+    T* allocate(std::size_t count) { return std::allocator<T>().allocate(count); }
+    void deallocate(T* ptr, std::size_t count) { std::allocator<T>().deallocate(ptr, count); }
+
+    template <typename U>
+    bool operator==(const tagged_allocator<U>& other) const { return m_id == other.m_id; }
+    template <typename U>
+    bool operator!=(const tagged_allocator<U>& other) const { return m_id != other.m_id; }
+
+    int m_id;
+};
+
+template <typename List, typename Set>
+void check_equal(const List& list, const Set& reference)
+{
+    CHECK(list.size() == reference.size());
+    CHECK(list.empty() == reference.empty());
+    auto it = list.begin();
+    for (const auto& value : reference) {
+        CHECK(it != list.end() && *it == value);
+        ++it;
+    }
+    CHECK(it == list.end());
+    auto rit = list.rbegin();
+    for (auto ref = reference.rbegin(); ref != reference.rend(); ++ref, ++rit) {
+        CHECK(rit != list.rend() && *rit == *ref);
+    }
+    CHECK(rit == list.rend());
+    // every block but a lone one holds half a block at least
+    CHECK(list.blocks() <= (list.size() == 0 ? 0 : 1 + list.size() / (List::block_size / 2)));
+}
+
+/// Random inserts and erases, by value and by position, against std::set.
+template <typename List, typename Make>
+void exercise(List& list, std::set<typename List::value_type, typename List::compare>& reference, std::mt19937& rng, Make make)
+{
+    for (int i = 0; i < 4000; ++i) {
+        const auto value = make(rng);
+        switch (rng() % 6) {
+        case 0:
+        case 1: {
+            const auto result = list.insert(value);
+            CHECK(result.second == reference.insert(value).second);
+            CHECK(*result.first == value);
+            break;
+        }
+        case 2:
+            CHECK(list.erase(value) == reference.erase(value));
+            break;
+        case 3: {
+            const auto it = list.lower_bound(value);
+            const auto ref = reference.lower_bound(value);
+            CHECK(ref == reference.end() ? it == list.end() : *it == *ref);
+            if (it != list.end()) {
+                const auto next = list.erase(it);
+                const auto ref_next = reference.erase(ref);
+                CHECK(ref_next == reference.end() ? next == list.end() : *next == *ref_next);
+            }
+            break;
+        }
+        case 4: {
+            const auto it = list.upper_bound(value);
+            const auto ref = reference.upper_bound(value);
+            CHECK(ref == reference.end() ? it == list.end() : *it == *ref);
+            break;
+        }
+        default:
+            CHECK((list.find(value) != list.end()) == (reference.count(value) != 0));
+            CHECK(list.contains(value) == (reference.count(value) != 0));
+            break;
+        }
+    }
+    check_equal(list, reference);
+}
+
+/// erase(const_iterator) in a loop over the whole list, the returned iterator goes on.
+template <typename List, typename Set>
+void erase_every_other(List& list, Set& reference)
+{
+    bool drop = true;
+    for (auto it = list.cbegin(); it != list.cend(); drop = !drop) {
+        if (drop) {
+            CHECK(reference.erase(*it) == 1);
+            it = list.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    check_equal(list, reference);
+}
+
+template <typename List, typename Make>
+void check_list(std::mt19937& rng, Make make)
+{
+    static_assert(std::is_nothrow_move_constructible_v<List>);
+    static_assert(std::is_nothrow_move_assignable_v<List>);
+
+    for (int round = 0; round < 20; ++round) {
+        List list;
+        std::set<typename List::value_type, typename List::compare> reference;
+        // an end() taken on the empty list stays the end
+        const auto end = list.end();
+        exercise(list, reference, rng, make);
+        CHECK(list.end() == end);
+        erase_every_other(list, reference);
+
+        // a move takes the blocks over and leaves an empty list which still works
+        const auto* first = list.empty() ? nullptr : &*list.begin();
+        List moved(std::move(list));
+        CHECK(list.empty() && list.begin() == list.end() && list.blocks() == 0);
+        CHECK(list.end() == end);
+        CHECK(moved.empty() || &*moved.begin() == first);
+        check_equal(moved, reference);
+        auto list_reference = decltype(reference)();
+        exercise(list, list_reference, rng, make);
+
+        // move assignment frees the old blocks and takes the others
+        List assigned;
+        auto assigned_reference = decltype(reference)();
+        exercise(assigned, assigned_reference, rng, make);
+        assigned = std::move(moved);
+        check_equal(assigned, reference);
+        check_equal(moved, decltype(reference)());
+        assigned_reference.clear();
+        exercise(moved, assigned_reference, rng, make);
+        assigned = std::move(assigned);
+        check_equal(assigned, reference);
+
+        // swap relinks the sentinels of both, copies are deep
+        swap(assigned, list);
+        check_equal(assigned, list_reference);
+        check_equal(list, reference);
+        List empty;
+        swap(empty, list);
+        check_equal(empty, reference);
+        check_equal(list, decltype(reference)());
+        List copy(empty);
+        exercise(copy, reference, rng, make);
+        copy = assigned;
+        check_equal(copy, list_reference);
+        erase_every_other(copy, list_reference);
+        check_equal(assigned, decltype(list_reference)(assigned.begin(), assigned.end()));
+
+        // erase down to nothing by position
+        while (!copy.empty()) {
+            const auto next = copy.erase(copy.begin());
+            list_reference.erase(list_reference.begin());
+            CHECK(next == copy.begin());
+        }
+        check_equal(copy, list_reference);
+        exercise(copy, list_reference, rng, make);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(2024);
+
+    // SIMD searched blocks
+    check_list<skip_list::unrolled_skip_list<int>>(rng, [](std::mt19937& r) { return static_cast<int>(r() % 3000) - 1500; });
+    check_list<skip_list::unrolled_skip_list<std::uint32_t, std::less<std::uint32_t>, std::allocator<std::uint32_t>, skip_list::level_generator<>, 8>>(
+        rng, [](std::mt19937& r) { return static_cast<std::uint32_t>(r() % 3000) + 0xFFFFF000u; });
+    check_list<skip_list::unrolled_skip_list<std::int64_t, std::less<>, std::allocator<std::int64_t>, skip_list::level_generator<>, 16>>(
+        rng, [](std::mt19937& r) { return static_cast<std::int64_t>(r() % 3000) * 0x100000001ll - 0x7FFFFFFFFFFll; });
+    check_list<skip_list::unrolled_skip_list<std::uint64_t>>(rng, [](std::mt19937& r) { return ~std::uint64_t(0) - r() % 3000; });
+    // binary searched blocks
+    check_list<skip_list::unrolled_skip_list<int, std::greater<int>>>(rng, [](std::mt19937& r) { return static_cast<int>(r() % 3000); });
+    check_list<skip_list::unrolled_skip_list<std::int16_t, std::less<std::int16_t>, std::allocator<std::int16_t>, skip_list::level_generator<>, 8>>(
+        rng, [](std::mt19937& r) { return static_cast<std::int16_t>(static_cast<int>(r() % 3000) - 1500); });
+
+    // unequal allocators which do not propagate copy the keys on a move assignment
+    {
+        using list_type = skip_list::unrolled_skip_list<int, std::less<int>, tagged_allocator<int>>;
+        static_assert(!std::is_nothrow_move_assignable_v<list_type>);
+        list_type list(tagged_allocator<int>(1));
+        list_type other(tagged_allocator<int>(2));
+        std::set<int> reference;
+        for (int i = 0; i < 1000; ++i) {
+            const int value = static_cast<int>(rng() % 5000);
+            other.insert(value);
+            reference.insert(value);
+        }
+        list.insert(-1);
+        list = std::move(other);
+        CHECK(list.get_allocator().m_id == 1);
+        check_equal(list, reference);
+        check_equal(other, std::set<int>());
+        list_type same(tagged_allocator<int>(1));
+        same = std::move(list);
+        check_equal(same, reference);
+        check_equal(list, std::set<int>());
+    }
+    return 0;
+}